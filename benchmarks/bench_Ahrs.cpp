@@ -0,0 +1,124 @@
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+// File for benchmarking the attitude filters
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "../include/Ahrs.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+#endif
+
+namespace
+{
+    // Noisy readings around a gentle bank
+    std::vector< aero::def::IMU_t > readings( size_t n, bool magnetometer )
+    {
+        std::vector< aero::def::IMU_t > out( n );
+        uint32_t seed = 7;
+        for( size_t i = 0; i < n; ++i )
+        {
+            seed = seed * 1664525u + 1013904223u;
+            float noise = static_cast< float >( seed >> 8 ) / 16777216.0f - 0.5f;
+
+            aero::def::IMU_t& imu = out[ i ];
+            imu = {};
+            imu.ax = -0.34f + 0.02f * noise;
+            imu.ay = 0.47f - 0.01f * noise;
+            imu.az = 0.81f + 0.03f * noise;
+            imu.gx = 1.5f * noise;
+            imu.gy = -0.7f + noise;
+            imu.gz = 3.0f * noise;
+            if( magnetometer )
+            {
+                imu.mx = 18.0f + noise;
+                imu.my = -4.0f;
+                imu.mz = 41.0f - noise;
+            }
+        }
+        return out;
+    }
+
+    // Processor timestamp cycles per iteration, where there is a counter to read
+    struct Cycles
+    {
+        uint64_t start;
+
+        Cycles( ) : start( now() ) {}
+
+        static uint64_t now( void )
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            return __rdtsc();
+#else
+            return 0;
+#endif
+        }
+
+        void report( benchmark::State& state ) const
+        {
+            state.counters[ "cycles" ] = benchmark::Counter( static_cast< double >( now() - start ) / state.iterations() );
+        }
+    };
+}
+
+// One fixed step update, with or without a magnetometer
+template< typename Filter >
+static void BM_AhrsUpdate( benchmark::State& state )
+{
+    std::vector< aero::def::IMU_t > data = readings( 1024, state.range( 0 ) != 0 );
+    Filter filter( 1000.0f );
+    size_t i = 0;
+
+    Cycles cycles;
+    for( auto _ : state )
+    {
+        filter.update( data[ i++ & 1023 ] );
+        benchmark::DoNotOptimize( filter.quaternion() );
+    }
+    cycles.report( state );
+}
+BENCHMARK_TEMPLATE( BM_AhrsUpdate, aero::ahrs::Madgwick< aero::ahrs::Exact > )->Arg( 0 )->Arg( 1 );
+BENCHMARK_TEMPLATE( BM_AhrsUpdate, aero::ahrs::Madgwick< aero::ahrs::Fast > )->Arg( 0 )->Arg( 1 );
+BENCHMARK_TEMPLATE( BM_AhrsUpdate, aero::ahrs::Mahony< aero::ahrs::Exact > )->Arg( 0 )->Arg( 1 );
+BENCHMARK_TEMPLATE( BM_AhrsUpdate, aero::ahrs::Mahony< aero::ahrs::Fast > )->Arg( 0 )->Arg( 1 );
+
+// Yaw, pitch and roll from the quaternion
+static void BM_AhrsAttitude( benchmark::State& state )
+{
+    std::vector< aero::def::IMU_t > data = readings( 1, true );
+    aero::ahrs::Madgwick<> filter( 1000.0f );
+    filter.update( data[ 0 ] );
+
+    Cycles cycles;
+    for( auto _ : state )
+    {
+        filter.attitude( data[ 0 ] );
+        benchmark::DoNotOptimize( data[ 0 ] );
+    }
+    cycles.report( state );
+}
+BENCHMARK( BM_AhrsAttitude );
+
+// Reprocessing a log, update and attitude for every sample
+template< typename Filter >
+static void BM_AhrsProcess( benchmark::State& state )
+{
+    std::vector< aero::def::IMU_t > data = readings( static_cast< size_t >( state.range( 0 ) ), true );
+    Filter filter( 1000.0f );
+
+    for( auto _ : state )
+    {
+        aero::ahrs::process( filter, data.data(), data.size() );
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed( state.iterations() * state.range( 0 ) );
+}
+BENCHMARK_TEMPLATE( BM_AhrsProcess, aero::ahrs::Madgwick< aero::ahrs::Fast > )->Arg( 60000 );
+BENCHMARK_TEMPLATE( BM_AhrsProcess, aero::ahrs::Mahony< aero::ahrs::Fast > )->Arg( 60000 );
+
+#endif
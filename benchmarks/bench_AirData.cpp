@@ -0,0 +1,95 @@
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+// File for benchmarking the air data computer against the separate conversions
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "../include/AirData.hpp"
+
+namespace
+{
+    const size_t READINGS = 1024;
+
+    // Pitot readings every sample, a new environment reading every fourth
+    struct Inputs
+    {
+        std::vector< aero::def::Pitot_t > pitot;
+        std::vector< aero::def::Enviro_t > enviro;
+
+        Inputs( ) : pitot( READINGS ), enviro( READINGS )
+        {
+            for( size_t i = 0; i < READINGS; ++i )
+            {
+                pitot[ i ].differential_pressure = 150.0f + 0.37f * i;
+                enviro[ i ].altitude = 0.0f;
+                enviro[ i ].temperature = 18.0f - 0.01f * ( i / 4 );
+                enviro[ i ].pressure = 98000.0f - 1.3f * ( i / 4 );
+            }
+        }
+    };
+
+    uint32_t bits( float value )
+    {
+        return static_cast< uint32_t >( aero::fixed::Q16_16::from_float( value ).raw );
+    }
+}
+
+// Every field from its own convert:: call
+static void BM_AirDataSeparate( benchmark::State& state )
+{
+    using namespace aero;
+
+    Inputs in;
+    def::AirData_t out;
+    size_t i = 0;
+
+    for( auto _ : state )
+    {
+        float dp = in.pitot[ i ].differential_pressure, p = in.enviro[ i ].pressure, t = in.enviro[ i ].temperature;
+        float ias = convert::cal_as( dp );
+        float agl = convert::above_gnd_altitude( p, 250.0f );
+
+        out.ias = bits( ias );
+        out.eas = bits( convert::equiv_as( dp, p ) );
+        out.tas = bits( convert::true_as( ias, t ) );
+        out.agl = bits( agl );
+        out.pressure_alt = bits( convert::pressure_altitude( p ) );
+        out.msl = bits( convert::mean_sl_altitude( agl, 262.0f ) );
+        out.density_alt = bits( convert::density_altitude( p, t ) );
+        out.approx_temp = bits( convert::approx_temp( t, convert::above_gnd_altitude( p, 250.0f ) ) );
+        out.density = bits( convert::approx_density( p, t ) );
+        benchmark::DoNotOptimize( out );
+
+        i = ( i + 1 ) % READINGS;
+    }
+}
+BENCHMARK( BM_AirDataSeparate );
+
+// The computer on the same stream, arg 1 gives it a new environment every sample
+static void BM_AirDataComputer( benchmark::State& state )
+{
+    using namespace aero;
+
+    Inputs in;
+    if( state.range( 0 ) )
+        for( size_t i = 0; i < READINGS; ++i )
+            in.enviro[ i ].pressure = 98000.0f - 1.3f * i;
+
+    convert::AirDataComputer::Config_t config = { 250.0f, 262.0f };
+    convert::AirDataComputer air( config );
+    def::AirData_t out;
+    size_t i = 0;
+
+    for( auto _ : state )
+    {
+        air.update( in.pitot[ i ], in.enviro[ i ], out );
+        benchmark::DoNotOptimize( out );
+
+        i = ( i + 1 ) % READINGS;
+    }
+}
+BENCHMARK( BM_AirDataComputer )->Arg( 0 )->Arg( 1 );
+
+#endif
@@ -0,0 +1,68 @@
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+// File for benchmarking per-field scans over structs against columns
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "../include/Columns.hpp"
+
+namespace
+{
+    // Thirty minutes of IMU data at 200 Hz
+    const size_t FLIGHT_ROWS = 30 * 60 * 200;
+
+    struct ImuFlight
+    {
+        ImuFlight( ) : rows( FLIGHT_ROWS )
+        {
+            for( size_t i = 0; i < FLIGHT_ROWS; ++i )
+            {
+                rows[ i ].az = -1.0f + 0.001f * ( i % 977 );
+                columns.append( 5000 * i, rows[ i ] );
+            }
+        }
+
+        std::vector< aero::def::IMU_t > rows;
+        aero::TelemetryColumns< aero::def::IMU_t > columns;
+    };
+
+    ImuFlight& imu_flight( void )
+    {
+        static ImuFlight flight;
+        return flight;
+    }
+}
+
+// Largest az by walking the structs
+static void BM_StructMaxAz( benchmark::State& state )
+{
+    const std::vector< aero::def::IMU_t >& rows = imu_flight().rows;
+
+    for( auto _ : state )
+    {
+        float hi = rows[ 0 ].az;
+        for( size_t i = 0; i < rows.size(); ++i )
+            hi = rows[ i ].az > hi ? rows[ i ].az : hi;
+        benchmark::DoNotOptimize( hi );
+    }
+
+    state.SetItemsProcessed( state.iterations() * FLIGHT_ROWS );
+}
+BENCHMARK( BM_StructMaxAz );
+
+// Largest az from the column
+static void BM_ColumnMaxAz( benchmark::State& state )
+{
+    const aero::TelemetryColumns< aero::def::IMU_t >& columns = imu_flight().columns;
+    size_t az = columns.find( "az" );
+
+    for( auto _ : state )
+        benchmark::DoNotOptimize( columns.stats( az, 0, columns.rows() ) );
+
+    state.SetItemsProcessed( state.iterations() * FLIGHT_ROWS );
+}
+BENCHMARK( BM_ColumnMaxAz );
+
+#endif
@@ -0,0 +1,81 @@
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+// File for benchmarking the batch conversions against a loop of scalar calls
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "../include/ConvertBatch.hpp"
+
+namespace
+{
+    // Thirty minutes of air data logged at 200 Hz
+    const size_t FLIGHT_SAMPLES = 30 * 60 * 200;
+
+    struct Flight
+    {
+        Flight( ) : diff_pressure( FLIGHT_SAMPLES ), pressure( FLIGHT_SAMPLES ),
+                    temperature( FLIGHT_SAMPLES ), out( FLIGHT_SAMPLES )
+        {
+            for( size_t i = 0; i < FLIGHT_SAMPLES; ++i )
+            {
+                float t = static_cast< float >( i ) / FLIGHT_SAMPLES;
+                diff_pressure[ i ] = 5.0f + 2500.0f * t;
+                pressure[ i ] = 101325.0f - 15000.0f * t;
+                temperature[ i ] = 35.0f - 45.0f * t;
+            }
+        }
+
+        std::vector< float > diff_pressure;
+        std::vector< float > pressure;
+        std::vector< float > temperature;
+        std::vector< float > out;
+    };
+
+    Flight flight;
+}
+
+// Convert the whole flight one sample at a time
+#define AERO_SCALAR_FLIGHT_BENCHMARK( Function, ... )                       \
+    static void BM_Scalar_##Function( benchmark::State& state )             \
+    {                                                                       \
+        Flight& f = flight;                                                 \
+        for( auto _ : state )                                               \
+        {                                                                   \
+            for( size_t i = 0; i < FLIGHT_SAMPLES; ++i )                    \
+                f.out[ i ] = aero::convert::Function( __VA_ARGS__ );        \
+            benchmark::DoNotOptimize( f.out.data() );                       \
+            benchmark::ClobberMemory();                                     \
+        }                                                                   \
+        state.SetItemsProcessed( state.iterations() * FLIGHT_SAMPLES );     \
+    }                                                                       \
+    BENCHMARK( BM_Scalar_##Function )->Unit( benchmark::kMillisecond );
+
+// Convert the whole flight with one batch call
+#define AERO_BATCH_FLIGHT_BENCHMARK( Function, ... )                        \
+    static void BM_Batch_##Function( benchmark::State& state )              \
+    {                                                                       \
+        Flight& f = flight;                                                 \
+        for( auto _ : state )                                               \
+        {                                                                   \
+            aero::convert::Function( __VA_ARGS__, f.out.data(), FLIGHT_SAMPLES ); \
+            benchmark::DoNotOptimize( f.out.data() );                       \
+            benchmark::ClobberMemory();                                     \
+        }                                                                   \
+        state.SetItemsProcessed( state.iterations() * FLIGHT_SAMPLES );     \
+    }                                                                       \
+    BENCHMARK( BM_Batch_##Function )->Unit( benchmark::kMillisecond );
+
+AERO_SCALAR_FLIGHT_BENCHMARK( cal_as, f.diff_pressure[ i ] )
+AERO_BATCH_FLIGHT_BENCHMARK( cal_as, f.diff_pressure.data() )
+AERO_SCALAR_FLIGHT_BENCHMARK( equiv_as, f.diff_pressure[ i ], f.pressure[ i ] )
+AERO_BATCH_FLIGHT_BENCHMARK( equiv_as, f.diff_pressure.data(), f.pressure.data() )
+AERO_SCALAR_FLIGHT_BENCHMARK( pressure_altitude, f.pressure[ i ] )
+AERO_BATCH_FLIGHT_BENCHMARK( pressure_altitude, f.pressure.data() )
+AERO_SCALAR_FLIGHT_BENCHMARK( density_altitude, f.pressure[ i ], f.temperature[ i ] )
+AERO_BATCH_FLIGHT_BENCHMARK( density_altitude, f.pressure.data(), f.temperature.data() )
+AERO_SCALAR_FLIGHT_BENCHMARK( approx_density, f.pressure[ i ], f.temperature[ i ] )
+AERO_BATCH_FLIGHT_BENCHMARK( approx_density, f.pressure.data(), f.temperature.data() )
+
+#endif
@@ -0,0 +1,92 @@
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+// File for benchmarking the streaming filters, one channel at a time against vectors
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "../include/Data.hpp"
+#include "../include/Filter.hpp"
+
+namespace
+{
+    // Noisy IMU readings, every field a channel
+    std::vector< aero::def::IMU_t > imu_stream( size_t n )
+    {
+        std::vector< aero::def::IMU_t > out( n );
+        uint32_t seed = 11;
+        for( size_t i = 0; i < n; ++i )
+        {
+            float* field = &out[ i ].ax;
+            for( size_t c = 0; c < 12; ++c )
+            {
+                seed = seed * 1664525u + 1013904223u;
+                field[ c ] = 10.0f * c + static_cast< float >( seed >> 8 ) / 16777216.0f;
+            }
+        }
+        return out;
+    }
+
+    // Filters built the same way whatever their template arguments
+    template< typename Filter >
+    struct Make
+    {
+        static Filter make( void ) { return Filter(); }
+    };
+
+    template< typename V >
+    struct Make< aero::filter::Biquad< 12, V > >
+    {
+        static aero::filter::Biquad< 12, V > make( void )
+        {
+            return aero::filter::Biquad< 12, V >( aero::filter::Coefficients::lowpass( 20.0f, 1000.0f ) );
+        }
+    };
+}
+
+// One step over all 12 IMU channels
+template< typename Filter >
+static void BM_FilterImu( benchmark::State& state )
+{
+    std::vector< aero::def::IMU_t > data = imu_stream( 1024 );
+    Filter filter = Make< Filter >::make();
+    size_t i = 0;
+
+    for( auto _ : state )
+    {
+        aero::def::IMU_t& imu = data[ i++ & 1023 ];
+        aero::filter::apply( filter, imu );
+        benchmark::DoNotOptimize( imu );
+    }
+
+    state.SetItemsProcessed( state.iterations() * 12 );
+}
+BENCHMARK_TEMPLATE( BM_FilterImu, aero::filter::MovingAverage< 12, 8, aero::filter::Scalar > );
+BENCHMARK_TEMPLATE( BM_FilterImu, aero::filter::MovingAverage< 12, 8 > );
+BENCHMARK_TEMPLATE( BM_FilterImu, aero::filter::Median< 12, 5, aero::filter::Scalar > );
+BENCHMARK_TEMPLATE( BM_FilterImu, aero::filter::Median< 12, 5 > );
+BENCHMARK_TEMPLATE( BM_FilterImu, aero::filter::Biquad< 12, aero::filter::Scalar > );
+BENCHMARK_TEMPLATE( BM_FilterImu, aero::filter::Biquad< 12 > );
+
+// Gyro rates blended with attitudes, 3 channels
+template< typename V >
+static void BM_FilterComplementary( benchmark::State& state )
+{
+    std::vector< aero::def::IMU_t > data = imu_stream( 1024 );
+    aero::filter::Complementary< 3, V > blend( 0.5f, 1000.0f );
+    size_t i = 0;
+
+    for( auto _ : state )
+    {
+        aero::def::IMU_t& imu = data[ i++ & 1023 ];
+        blend.step( &imu.gx, &imu.yaw, &imu.yaw );
+        benchmark::DoNotOptimize( imu );
+    }
+
+    state.SetItemsProcessed( state.iterations() * 3 );
+}
+BENCHMARK_TEMPLATE( BM_FilterComplementary, aero::filter::Scalar );
+BENCHMARK_TEMPLATE( BM_FilterComplementary, aero::filter::Lanes );
+
+#endif
@@ -0,0 +1,95 @@
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+// File for benchmarking the formatter against stdio
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include "../include/Format.hpp"
+
+namespace
+{
+    // One console line of telemetry
+    const float ALTITUDE = 251.36f, AIRSPEED = 17.8125f, PRESSURE = 98234.5f;
+    const uint32_t TIME_MS = 1234567;
+}
+
+// Telemetry line with snprintf
+static void BM_SnprintfLine( benchmark::State& state )
+{
+    char line[ 128 ];
+
+    for( auto _ : state )
+    {
+        int n = snprintf( line, sizeof( line ), "%lu alt %.2f as %.3f p %.1f\n", (unsigned long) TIME_MS,
+                          ALTITUDE, AIRSPEED, PRESSURE );
+        benchmark::DoNotOptimize( n );
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK( BM_SnprintfLine );
+
+// The same line with the formatter
+static void BM_FormatterLine( benchmark::State& state )
+{
+    char line[ 128 ];
+
+    for( auto _ : state )
+    {
+        aero::print::Formatter out( line, sizeof( line ) );
+        out.number( TIME_MS ).text( " alt " ).fixed( ALTITUDE, 2 ).text( " as " ).fixed( AIRSPEED, 3 )
+           .text( " p " ).fixed( PRESSURE, 1 ).line();
+        benchmark::DoNotOptimize( out.c_str() );
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK( BM_FormatterLine );
+
+// Shortest round trip floats against the 9 digits that always round trip
+static void BM_SnprintfFloat( benchmark::State& state )
+{
+    char text[ 32 ];
+    float value = 0.1f;
+
+    for( auto _ : state )
+    {
+        value += 0.37f;
+        benchmark::DoNotOptimize( snprintf( text, sizeof( text ), "%.9g", value ) );
+    }
+}
+BENCHMARK( BM_SnprintfFloat );
+
+static void BM_FormatterFloat( benchmark::State& state )
+{
+    char text[ 32 ];
+    float value = 0.1f;
+
+    for( auto _ : state )
+    {
+        value += 0.37f;
+        aero::print::Formatter out( text, sizeof( text ) );
+        benchmark::DoNotOptimize( out.real( value ).c_str() );
+    }
+}
+BENCHMARK( BM_FormatterFloat );
+
+// Hex dump of a full frame
+static void BM_HexDump( benchmark::State& state )
+{
+    uint8_t frame[ 267 ];
+    char text[ 1400 ];
+    for( size_t i = 0; i < sizeof( frame ); ++i )
+        frame[ i ] = static_cast< uint8_t >( i * 7 );
+
+    for( auto _ : state )
+    {
+        aero::print::Formatter out( text, sizeof( text ) );
+        benchmark::DoNotOptimize( out.hex_dump( frame, sizeof( frame ) ).c_str() );
+    }
+
+    state.SetBytesProcessed( state.iterations() * sizeof( frame ) );
+}
+BENCHMARK( BM_HexDump );
+
+#endif
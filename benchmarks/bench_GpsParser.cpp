@@ -0,0 +1,195 @@
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+// File for benchmarking the GPS parser on streams like a receiver sends
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "../include/GpsParser.hpp"
+
+namespace
+{
+    std::string checksummed( const char* body )
+    {
+        uint8_t sum = 0;
+        for( const char* c = body; *c; ++c )
+            sum ^= static_cast< uint8_t >( *c );
+
+        char tail[ 8 ];
+        snprintf( tail, sizeof( tail ), "*%02X\r\n", sum );
+        return std::string( "$" ) + body + tail;
+    }
+
+    // A u-blox receiver's default NMEA output, 100 epochs of 8 sentences
+    std::vector< uint8_t > nmea_stream( void )
+    {
+        std::string text;
+        char body[ 128 ];
+        for( int epoch = 0; epoch < 100; ++epoch )
+        {
+            int cs = epoch % 10, s = 42 + epoch / 10;
+            snprintf( body, sizeof( body ), "GNRMC,1005%02d.%d0,A,4300.%05d,N,08116.%05d,W,%d.%03d,77.52,140721,,,A",
+                      s, cs, 57600 + 13 * epoch, 42200 + 7 * epoch, 33, 10 * epoch );
+            text += checksummed( body );
+            text += checksummed( "GNVTG,77.52,T,,M,33.100,N,61.301,K,A" );
+            snprintf( body, sizeof( body ), "GNGGA,1005%02d.%d0,4300.%05d,N,08116.%05d,W,1,11,0.78,%d.%d,M,-35.3,M,,",
+                      s, cs, 57600 + 13 * epoch, 42200 + 7 * epoch, 251 + epoch / 4, epoch % 10 );
+            text += checksummed( body );
+            text += checksummed( "GNGSA,A,3,10,12,15,18,23,24,25,32,,,,,1.35,0.78,1.10,1" );
+            text += checksummed( "GPGSV,3,1,11,10,64,291,42,12,34,113,39,15,17,057,35,18,21,313,37,1" );
+            text += checksummed( "GPGSV,3,2,11,23,51,216,44,24,69,096,45,25,22,168,38,32,35,262,41,1" );
+            text += checksummed( "GPGSV,3,3,11,13,07,041,,19,03,160,,20,01,330,,1" );
+            text += checksummed( "GNGLL,4300.57600,N,08116.42200,W,100542.00,A,A" );
+        }
+        return std::vector< uint8_t >( text.begin(), text.end() );
+    }
+
+    // UBX only output, NAV-PVT and NAV-SAT for 100 epochs
+    std::vector< uint8_t > ubx_stream( void )
+    {
+        std::vector< uint8_t > out;
+        for( int epoch = 0; epoch < 100; ++epoch )
+        {
+            const uint16_t lengths[] = { 92, 8 + 12 * 11 };
+            for( int m = 0; m < 2; ++m )
+            {
+                std::vector< uint8_t > message = { 0xB5, 0x62, 0x01, static_cast< uint8_t >( m == 0 ? 0x07 : 0x35 ),
+                                                   static_cast< uint8_t >( lengths[ m ] ), static_cast< uint8_t >( lengths[ m ] >> 8 ) };
+                for( int i = 0; i < lengths[ m ]; ++i )
+                    message.push_back( static_cast< uint8_t >( epoch * 31 + i * 7 ) );
+                if( m == 0 )
+                {
+                    message[ 6 + 11 ] = 0x03;
+                    message[ 6 + 20 ] = 3;
+                    message[ 6 + 21 ] = 0x01;
+                }
+
+                uint8_t a = 0, b = 0;
+                for( size_t i = 2; i < message.size(); ++i )
+                {
+                    a = static_cast< uint8_t >( a + message[ i ] );
+                    b = static_cast< uint8_t >( b + a );
+                }
+                message.push_back( a );
+                message.push_back( b );
+                out.insert( out.end(), message.begin(), message.end() );
+            }
+        }
+        return out;
+    }
+
+    // Line buffer, strtok and atof, the usual way of doing it
+    struct TokenParser
+    {
+        char line[ 128 ];
+        size_t have;
+        aero::def::GPS_t data;
+
+        TokenParser( ) : have( 0 ), data() {}
+
+        static float degrees( const char* field )
+        {
+            double value = atof( field );
+            int whole = static_cast< int >( value / 100 );
+            return static_cast< float >( whole + ( value - whole * 100 ) / 60.0 );
+        }
+
+        size_t feed( const uint8_t* bytes, size_t len )
+        {
+            size_t applied = 0;
+            for( size_t i = 0; i < len; ++i )
+            {
+                char c = static_cast< char >( bytes[ i ] );
+                if( c == '$' )
+                    have = 0;
+                if( c != '\n' )
+                {
+                    if( have < sizeof( line ) - 1 )
+                        line[ have++ ] = c;
+                    continue;
+                }
+
+                line[ have ] = 0;
+                char* star = strchr( line, '*' );
+                if( star == NULL )
+                    continue;
+
+                uint8_t sum = 0;
+                for( char* p = line + 1; p < star; ++p )
+                    sum ^= static_cast< uint8_t >( *p );
+                if( sum != strtoul( star + 1, NULL, 16 ) )
+                    continue;
+                *star = 0;
+
+                // strtok merges empty fields, so this only works with a fix
+                char* field[ 20 ] = {};
+                int n = 0;
+                for( char* t = strtok( line, "," ); t != NULL && n < 20; t = strtok( NULL, "," ) )
+                    field[ n++ ] = t;
+
+                if( n >= 10 && strcmp( field[ 0 ] + 3, "GGA" ) == 0 )
+                {
+                    data.time = static_cast< uint32_t >( atof( field[ 1 ] ) * 100 );
+                    data.lat = degrees( field[ 2 ] ) * ( field[ 3 ][ 0 ] == 'S' ? -1 : 1 );
+                    data.lon = degrees( field[ 4 ] ) * ( field[ 5 ][ 0 ] == 'W' ? -1 : 1 );
+                    data.quality = atoi( field[ 6 ] );
+                    data.satellites = atoi( field[ 7 ] );
+                    data.HDOP = static_cast< uint32_t >( atof( field[ 8 ] ) * 100 );
+                    data.altitude = static_cast< float >( atof( field[ 9 ] ) );
+                    ++applied;
+                }
+                else if( n >= 9 && strcmp( field[ 0 ] + 3, "RMC" ) == 0 )
+                {
+                    data.fix = field[ 2 ][ 0 ] == 'A';
+                    data.speed = static_cast< float >( atof( field[ 7 ] ) * 0.514444 );
+                    data.date = atoi( field[ 9 ] );
+                    ++applied;
+                }
+            }
+            return applied;
+        }
+    };
+
+    // Feed a stream in chunks the size a UART DMA buffer would hand over
+    template< typename Parser >
+    void run( benchmark::State& state, const std::vector< uint8_t >& stream )
+    {
+        size_t chunk = static_cast< size_t >( state.range( 0 ) );
+        Parser parser;
+
+        for( auto _ : state )
+        {
+            size_t applied = 0;
+            for( size_t at = 0; at < stream.size(); at += chunk )
+                applied += parser.feed( stream.data() + at, std::min( chunk, stream.size() - at ) );
+            benchmark::DoNotOptimize( applied );
+        }
+
+        state.SetBytesProcessed( state.iterations() * stream.size() );
+    }
+}
+
+static void BM_GpsParserNmea( benchmark::State& state )
+{
+    run< aero::GpsParser >( state, nmea_stream() );
+}
+BENCHMARK( BM_GpsParserNmea )->Arg( 1 )->Arg( 64 );
+
+static void BM_GpsParserTokens( benchmark::State& state )
+{
+    run< TokenParser >( state, nmea_stream() );
+}
+BENCHMARK( BM_GpsParserTokens )->Arg( 64 );
+
+static void BM_GpsParserUbx( benchmark::State& state )
+{
+    run< aero::GpsParser >( state, ubx_stream() );
+}
+BENCHMARK( BM_GpsParserUbx )->Arg( 1 )->Arg( 64 );
+
+#endif
@@ -0,0 +1,124 @@
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+// File for benchmarking frame building, parsing and validation
+#include <benchmark/benchmark.h>
+#include "../include/Schema.hpp"
+
+namespace
+{
+    using namespace aero::def;
+
+    // One of every segment a schema can pick from
+    struct Segments
+    {
+        Pitot_t pitot = { 450.0f };
+        IMU_t imu = { 0.01f, -0.02f, 0.98f, 1.0f, 2.0f, 3.0f, 20.0f, -5.0f, 40.0f, 90.0f, 5.0f, -2.0f };
+        GPS_t gps = { true, 43.0f, -81.2f, 20.0f, 9, 250.0f, 123456, 170619, 90, 1 };
+        Enviro_t enviro = { 250.0f, 15.0f, 98000.0f };
+        Battery_t battery = { 12.6f, 2.0f };
+        Status_t status = { -60.0f, 1 };
+        Servos_t servos = {};
+        AirData_t air = {};
+    };
+
+    Pitot_t& pick( Segments& s, Pitot_t* ) { return s.pitot; }
+    IMU_t& pick( Segments& s, IMU_t* ) { return s.imu; }
+    GPS_t& pick( Segments& s, GPS_t* ) { return s.gps; }
+    Enviro_t& pick( Segments& s, Enviro_t* ) { return s.enviro; }
+    Battery_t& pick( Segments& s, Battery_t* ) { return s.battery; }
+    Status_t& pick( Segments& s, Status_t* ) { return s.status; }
+    Servos_t& pick( Segments& s, Servos_t* ) { return s.servos; }
+    AirData_t& pick( Segments& s, AirData_t* ) { return s.air; }
+
+    // Signature densities from one segment to most of the payload
+    using Sparse = aero::Schema< Pitot_t >;
+    using Medium = aero::Schema< Pitot_t, Enviro_t, Status_t >;
+    using Dense = aero::Schema< Pitot_t, IMU_t, GPS_t, Enviro_t, Battery_t, Status_t, Servos_t, AirData_t >;
+}
+
+// Build a frame into a buffer, including the CRC
+template< typename Schema, typename... Ts >
+void build_frame( benchmark::State& state, Segments& segments, Ts*... )
+{
+    uint8_t buf[ MAX_FRAME_SIZE ];
+
+    for( auto _ : state )
+    {
+        benchmark::DoNotOptimize( segments );
+        Schema::build( buf, ID::Plane, ID::Gnd, pick( segments, (Ts*) NULL )... );
+        benchmark::DoNotOptimize( buf );
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed( state.iterations() * Schema::frame_size );
+}
+
+// Check and copy out every segment of a frame
+template< typename Schema, typename... Ts >
+void parse_frame( benchmark::State& state, Segments& segments, Ts*... )
+{
+    uint8_t buf[ MAX_FRAME_SIZE ];
+    Schema::build( buf, ID::Plane, ID::Gnd, pick( segments, (Ts*) NULL )... );
+    Segments out;
+
+    for( auto _ : state )
+    {
+        benchmark::DoNotOptimize( buf );
+        benchmark::DoNotOptimize( Schema::parse( buf, Schema::frame_size, pick( out, (Ts*) NULL )... ) );
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed( state.iterations() * Schema::frame_size );
+}
+
+// Validate a frame without knowing its schema
+template< typename Schema, typename... Ts >
+void validate_frame( benchmark::State& state, Segments& segments, Ts*... )
+{
+    uint8_t buf[ MAX_FRAME_SIZE ];
+    Schema::build( buf, ID::Plane, ID::Gnd, pick( segments, (Ts*) NULL )... );
+
+    for( auto _ : state )
+    {
+        benchmark::DoNotOptimize( buf );
+        benchmark::DoNotOptimize( aero::MessageView( buf, sizeof( buf ) ).valid() );
+    }
+
+    state.SetBytesProcessed( state.iterations() * Schema::frame_size );
+}
+
+#define AERO_FRAME_BENCHMARKS( Name, Schema, ... )                                                                  \
+    static void BM_Build##Name( benchmark::State& state ) { Segments s; build_frame< Schema >( state, s, __VA_ARGS__ ); }       \
+    static void BM_Parse##Name( benchmark::State& state ) { Segments s; parse_frame< Schema >( state, s, __VA_ARGS__ ); }       \
+    static void BM_Validate##Name( benchmark::State& state ) { Segments s; validate_frame< Schema >( state, s, __VA_ARGS__ ); } \
+    BENCHMARK( BM_Build##Name );                                                                                    \
+    BENCHMARK( BM_Parse##Name );                                                                                    \
+    BENCHMARK( BM_Validate##Name );
+
+AERO_FRAME_BENCHMARKS( Sparse, Sparse, (Pitot_t*) NULL )
+AERO_FRAME_BENCHMARKS( Medium, Medium, (Pitot_t*) NULL, (Enviro_t*) NULL, (Status_t*) NULL )
+AERO_FRAME_BENCHMARKS( Dense, Dense, (Pitot_t*) NULL, (IMU_t*) NULL, (GPS_t*) NULL, (Enviro_t*) NULL,
+                       (Battery_t*) NULL, (Status_t*) NULL, (Servos_t*) NULL, (AirData_t*) NULL )
+
+// Copy one segment out of a dense frame
+static void BM_ViewCopy( benchmark::State& state )
+{
+    Segments s;
+    uint8_t buf[ MAX_FRAME_SIZE ];
+    Dense::build( buf, ID::Plane, ID::Gnd, s.pitot, s.imu, s.gps, s.enviro, s.battery, s.status, s.servos, s.air );
+    aero::MessageView view( buf, sizeof( buf ) );
+    Servos_t servos;
+
+    for( auto _ : state )
+    {
+        benchmark::DoNotOptimize( view );
+        benchmark::DoNotOptimize( view.copy( servos ) );
+        benchmark::DoNotOptimize( servos );
+    }
+}
+BENCHMARK( BM_ViewCopy );
+
+#endif
@@ -0,0 +1,102 @@
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+// File for benchmarking reflected per-field code against a runtime field table
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "../include/Reflect.hpp"
+#include "../include/Columns.hpp"
+
+namespace
+{
+    std::vector< aero::def::GPS_t > gps_rows( size_t n )
+    {
+        std::vector< aero::def::GPS_t > rows( n );
+        for( size_t i = 0; i < n; ++i )
+            rows[ i ] = { true, 43.0f + i * 1e-6f, -81.2f, 12.5f, 9, 250.0f, static_cast< uint32_t >( i ), 10121, 95, 1 };
+        return rows;
+    }
+}
+
+// Swap every field through a table walked at run time, the way the column store used to
+static void BM_TableSwap( benchmark::State& state )
+{
+    typedef aero::columns::Layout< aero::def::GPS_t > Layout;
+    std::vector< aero::def::GPS_t > rows = gps_rows( state.range( 0 ) );
+
+    for( auto _ : state )
+    {
+        for( size_t r = 0; r < rows.size(); ++r )
+        {
+            uint8_t* bytes = reinterpret_cast< uint8_t* >( &rows[ r ] );
+            for( size_t i = 0; i < Layout::count; ++i )
+            {
+                const aero::columns::Field& field = Layout::fields()[ i ];
+                uint8_t* value = bytes + field.offset;
+                for( size_t lo = 0, hi = aero::columns::width( field.type ) - 1; lo < hi; ++lo, --hi )
+                    std::swap( value[ lo ], value[ hi ] );
+            }
+        }
+
+        benchmark::DoNotOptimize( rows.data() );
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed( state.iterations() * rows.size() );
+}
+BENCHMARK( BM_TableSwap )->Arg( 4096 );
+
+// Swap every field with the code unrolled from the description
+static void BM_ReflectSwap( benchmark::State& state )
+{
+    std::vector< aero::def::GPS_t > rows = gps_rows( state.range( 0 ) );
+
+    for( auto _ : state )
+    {
+        for( size_t r = 0; r < rows.size(); ++r )
+            aero::reflect::swap( rows[ r ] );
+
+        benchmark::DoNotOptimize( rows.data() );
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed( state.iterations() * rows.size() );
+}
+BENCHMARK( BM_ReflectSwap )->Arg( 4096 );
+
+// Swap a whole array with byte shuffles
+static void BM_ReflectSwapArray( benchmark::State& state )
+{
+    std::vector< aero::def::GPS_t > rows = gps_rows( state.range( 0 ) );
+
+    for( auto _ : state )
+    {
+        aero::reflect::swap( rows.data(), rows.size() );
+
+        benchmark::DoNotOptimize( rows.data() );
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed( state.iterations() * rows.size() );
+}
+BENCHMARK( BM_ReflectSwapArray )->Arg( 4096 );
+
+// Write a CSV row per segment
+static void BM_ReflectCsv( benchmark::State& state )
+{
+    std::vector< aero::def::GPS_t > rows = gps_rows( state.range( 0 ) );
+    char line[ 160 ];
+
+    for( auto _ : state )
+    {
+        for( size_t r = 0; r < rows.size(); ++r )
+            benchmark::DoNotOptimize( aero::reflect::csv_row( rows[ r ], line, sizeof( line ) ) );
+    }
+
+    state.SetItemsProcessed( state.iterations() * rows.size() );
+}
+BENCHMARK( BM_ReflectCsv )->Arg( 1024 );
+
+#endif
@@ -0,0 +1,129 @@
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+// File for benchmarking the binary and conversion helpers
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "../include/Utility.hpp"
+#include "../include/Simd.hpp"
+#include "../include/FastConvert.hpp"
+
+// Swap the byte order of an array in place
+template< typename T >
+static void BM_SwapEndian( benchmark::State& state )
+{
+    std::vector< T > data( state.range( 0 ) );
+    for( size_t i = 0; i < data.size(); ++i )
+        data[ i ] = static_cast< T >( i * 2654435761u );
+
+    for( auto _ : state )
+    {
+        for( size_t i = 0; i < data.size(); ++i )
+            data[ i ] = aero::bit::swap_endian( data[ i ] );
+
+        benchmark::DoNotOptimize( data.data() );
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed( state.iterations() * data.size() * sizeof( T ) );
+}
+BENCHMARK_TEMPLATE( BM_SwapEndian, uint16_t )->Arg( 4096 );
+BENCHMARK_TEMPLATE( BM_SwapEndian, uint32_t )->Arg( 4096 );
+BENCHMARK_TEMPLATE( BM_SwapEndian, uint64_t )->Arg( 4096 );
+BENCHMARK_TEMPLATE( BM_SwapEndian, float )->Arg( 4096 );
+BENCHMARK_TEMPLATE( BM_SwapEndian, double )->Arg( 4096 );
+
+// Swap the byte order of an array with the bulk path
+template< typename T >
+static void BM_SwapEndianArray( benchmark::State& state )
+{
+    std::vector< T > data( state.range( 0 ) );
+    for( size_t i = 0; i < data.size(); ++i )
+        data[ i ] = static_cast< T >( i * 2654435761u );
+
+    for( auto _ : state )
+    {
+        aero::bit::swap_endian( data.data(), data.size() );
+
+        benchmark::DoNotOptimize( data.data() );
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed( state.iterations() * data.size() * sizeof( T ) );
+}
+BENCHMARK_TEMPLATE( BM_SwapEndianArray, uint16_t )->Arg( 4096 );
+BENCHMARK_TEMPLATE( BM_SwapEndianArray, uint32_t )->Arg( 4096 );
+BENCHMARK_TEMPLATE( BM_SwapEndianArray, float )->Arg( 4096 );
+
+namespace
+{
+    // Samples across the flight envelope, kept in arrays so nothing is constant folded
+    const size_t SAMPLES = 1024;
+
+    struct Envelope
+    {
+        Envelope( )
+        {
+            for( size_t i = 0; i < SAMPLES; ++i )
+            {
+                float t = static_cast< float >( i ) / SAMPLES;
+                diff_pressure[ i ] = 5.0f + 2500.0f * t;        // Up to about 65 m/s
+                pressure[ i ] = 101325.0f - 15000.0f * t;       // Sea level to about 1300 m
+                temperature[ i ] = 35.0f - 45.0f * t;
+                airspeed[ i ] = 5.0f + 60.0f * t;
+                altitude[ i ] = 1300.0f * t;
+            }
+        }
+
+        float diff_pressure[ SAMPLES ];
+        float pressure[ SAMPLES ];
+        float temperature[ SAMPLES ];
+        float airspeed[ SAMPLES ];
+        float altitude[ SAMPLES ];
+    };
+
+    const Envelope envelope;
+}
+
+// Apply a conversion from a namespace to every sample
+#define AERO_CONVERT_BENCHMARK_IN( Space, Name, Function, ... )        \
+    static void BM_##Name( benchmark::State& state )                    \
+    {                                                                   \
+        const Envelope& e = envelope;                                   \
+        float out[ SAMPLES ];                                           \
+        for( auto _ : state )                                           \
+        {                                                               \
+            for( size_t i = 0; i < SAMPLES; ++i )                       \
+                out[ i ] = Space::Function( __VA_ARGS__ );              \
+            benchmark::DoNotOptimize( out );                            \
+            benchmark::ClobberMemory();                                 \
+        }                                                               \
+        state.SetItemsProcessed( state.iterations() * SAMPLES );        \
+    }                                                                   \
+    BENCHMARK( BM_##Name );
+
+#define AERO_CONVERT_BENCHMARK( Function, ... ) \
+    AERO_CONVERT_BENCHMARK_IN( aero::convert, Function, Function, __VA_ARGS__ )
+
+#define AERO_FAST_CONVERT_BENCHMARK( Function, ... ) \
+    AERO_CONVERT_BENCHMARK_IN( aero::convert::fast, fast_##Function, Function, __VA_ARGS__ )
+
+AERO_CONVERT_BENCHMARK( cal_as, e.diff_pressure[ i ] )
+AERO_CONVERT_BENCHMARK( equiv_as, e.diff_pressure[ i ], e.pressure[ i ] )
+AERO_CONVERT_BENCHMARK( true_as, e.airspeed[ i ], e.temperature[ i ] )
+AERO_CONVERT_BENCHMARK( pressure_altitude, e.pressure[ i ] )
+AERO_CONVERT_BENCHMARK( above_gnd_altitude, e.pressure[ i ], 250.0f )
+AERO_CONVERT_BENCHMARK( mean_sl_altitude, e.altitude[ i ], 250.0f )
+AERO_CONVERT_BENCHMARK( density_altitude, e.pressure[ i ], e.temperature[ i ] )
+AERO_CONVERT_BENCHMARK( approx_temp, e.temperature[ i ], e.altitude[ i ] )
+AERO_CONVERT_BENCHMARK( approx_density, e.pressure[ i ], e.temperature[ i ] )
+AERO_CONVERT_BENCHMARK( metric, e.altitude[ i ], aero::convert::Unit::base, aero::convert::Unit::k )
+
+AERO_FAST_CONVERT_BENCHMARK( cal_as, e.diff_pressure[ i ] )
+AERO_FAST_CONVERT_BENCHMARK( equiv_as, e.diff_pressure[ i ], e.pressure[ i ] )
+AERO_FAST_CONVERT_BENCHMARK( pressure_altitude, e.pressure[ i ] )
+AERO_FAST_CONVERT_BENCHMARK( density_altitude, e.pressure[ i ], e.temperature[ i ] )
+
+#endif
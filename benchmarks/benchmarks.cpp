@@ -0,0 +1,21 @@
+// Units under benchmark
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+#include "bench_Message.cpp"
+#include "bench_Utility.cpp"
+#include "bench_ConvertBatch.cpp"
+#include "bench_Columns.cpp"
+#include "bench_Reflect.cpp"
+#include "bench_Format.cpp"
+#include "bench_Ahrs.cpp"
+#include "bench_AirData.cpp"
+#include "bench_Filter.cpp"
+#include "bench_GpsParser.cpp"
+
+// Main that runs all benchmarks
+BENCHMARK_MAIN();
+
+#endif
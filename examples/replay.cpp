@@ -0,0 +1,60 @@
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+#include <cstdio>
+#include <cstdlib>
+#include <Replay.hpp>
+
+// For getopt
+#include "unistd.h"
+
+// Replays a log through the decode pipeline and prints throughput and latency
+int main( int argc, char** argv )
+{
+    aero::replay::Options options;
+    int repeat = 1;
+    int opt;
+
+    while( ( opt = getopt( argc, argv, "s:b:d:r:c:n:" ) ) != -1 )
+    {
+        switch( opt )
+        {
+            case 's': options.speed = atof( optarg ); break;
+            case 'b': options.bit_error_rate = atof( optarg ); break;
+            case 'd': options.drop_rate = atof( optarg ); break;
+            case 'r': options.seed = strtoull( optarg, NULL, 0 ); break;
+            case 'c': options.chunk = strtoul( optarg, NULL, 0 ); break;
+            case 'n': repeat = atoi( optarg ); break;
+            default:
+                fprintf( stderr, "usage: %s [-s speed] [-b bit error rate] [-d drop rate] "
+                                 "[-r seed] [-c chunk bytes] [-n repeats] log\n", argv[ 0 ] );
+                return 1;
+        }
+    }
+
+    if( optind >= argc )
+    {
+        fprintf( stderr, "No log given\n" );
+        return 1;
+    }
+
+    aero::LogReader log;
+    if( !log.open( argv[ optind ] ) )
+    {
+        fprintf( stderr, "Could not open %s\n", argv[ optind ] );
+        return 1;
+    }
+
+    aero::replay::Report report;
+    aero::replay::Engine engine( options );
+
+    for( int i = 0; i < repeat; ++i )
+        engine.run( log, report );
+
+    report.print( stdout );
+    return 0;
+}
+
+#endif
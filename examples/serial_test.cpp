@@ -4,29 +4,48 @@
 #else
 
 #include <iostream>
-#include <fstream>
-#include <Message.hpp>
+#include <PosixSerial.hpp>
+#include <Schema.hpp>
 
-int main(void)
+// Print every frame that comes back
+void on_frame( const aero::MessageView& frame, void* )
+{
+    std::cout << "Frame from " << (int) frame.from() << " with signature 0x"
+              << std::hex << frame.signature() << std::dec << std::endl;
+}
+
+int main( int argc, char** argv )
 {
     using namespace aero::def;
-    aero::Message messageHandler;
-    
-    std::ofstream arduino;
-    arduino.open( "/dev/ttyACM0");
-    IMU_t imu;
+
+    const char* device = argc > 1 ? argv[ 1 ] : "/dev/ttyACM0";
+
+    aero::serial::PosixPort arduino;
+    if( !arduino.open( device, 921600 ) )
+    {
+        std::cerr << "Could not open " << device << std::endl;
+        return 1;
+    }
+
+    IMU_t imu = {};
     imu.ax = 100;
     imu.gy = 55;
-    messageHandler.add_imu(imu);
-    RawMessage_t message = messageHandler.build( ID::G1, ID::G2 );
-    char* buf = (char*) &message;
-    //write to it
-    for(int i = 0; i < sizeof(message); ++i)
-    {
-        arduino << *(buf+i);
-    } 
 
-    arduino.close();
+    using Telemetry = aero::Schema< IMU_t >;
+    uint8_t frame[ Telemetry::frame_size ];
+    Telemetry::build( frame, ID::G1, ID::G2, imu );
+
+    // Whole frame in one call instead of one byte at a time
+    if( arduino.write( frame, sizeof( frame ) ) != (ssize_t) sizeof( frame ) )
+        std::cerr << "Short write" << std::endl;
+
+    // Listen for replies for a second
+    aero::FrameDecoder decoder( on_frame );
+    aero::serial::PortReader reader;
+    reader.add( arduino, decoder );
+
+    for( int i = 0; i < 10 && reader.count() > 0; ++i )
+        reader.poll( 100 );
 
     return 0;
 }
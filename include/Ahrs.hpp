@@ -0,0 +1,482 @@
+#pragma once
+
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    #include "Arduino.h"
+#else
+    #include <cstddef>
+    #include <cstdint>
+    #include <cstring>
+    #include <cmath>
+#endif
+
+#include "Data.hpp"
+#include "Sensors.hpp"
+
+/*!
+ *  \addtogroup aero
+ *  @{
+ */
+
+//! Aero library code
+namespace aero
+{
+
+/*!
+ *  \addtogroup ahrs
+ *  @{
+ */
+
+//! Attitude and heading from the raw IMU fields
+namespace ahrs
+{
+    const float RAD_PER_DEG = 0.0174532925f;
+    const float DEG_PER_RAD = 57.2957795f;
+
+    /**
+     * @brief 1 / sqrt( x ) with the library call
+     */
+    struct Exact
+    {
+        static inline float inv_sqrt( float x ) { return 1.0f / sqrtf( x ); }
+    };
+
+    /**
+     * @brief 1 / sqrt( x ) from the float bits and one Newton step
+     *
+     * @details Relative error under 7e-4 with the constants from Moroz et
+     *          al., "Fast calculation of inverse square root with the use of
+     *          magic constant". Every update normalizes again, so the error
+     *          never builds up. Worth it where there is no hardware divide
+     *          or square root, like the Teensy 3.2
+     */
+    struct Fast
+    {
+        static inline float inv_sqrt( float x )
+        {
+            uint32_t bits;
+            memcpy( &bits, &x, sizeof( bits ) );
+            bits = 0x5F1FFFF9u - ( bits >> 1 );
+
+            float y;
+            memcpy( &y, &bits, sizeof( y ) );
+            return y * 0.703952253f * ( 2.38924456f - x * y * y );
+        }
+    };
+
+    /**
+     * @brief Orientation of the sensor relative to the earth
+     */
+    struct Quaternion
+    {
+        float w;
+        float x;
+        float y;
+        float z;
+    };
+
+    namespace detail
+    {
+        /**
+         * @brief Scale a vector to unit length
+         *
+         * @return false if it was all zeros and left alone
+         */
+        template< typename Sqrt >
+        inline bool normalize( float& x, float& y, float& z )
+        {
+            float norm = x * x + y * y + z * z;
+            if( norm == 0.0f )
+                return false;
+
+            norm = Sqrt::inv_sqrt( norm );
+            x *= norm;
+            y *= norm;
+            z *= norm;
+            return true;
+        }
+
+        template< typename Sqrt >
+        inline void normalize( Quaternion& q )
+        {
+            float norm = Sqrt::inv_sqrt( q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z );
+            q.w *= norm;
+            q.x *= norm;
+            q.y *= norm;
+            q.z *= norm;
+        }
+
+        /**
+         * @brief Yaw, pitch and roll in degrees, rotating about z then y then x
+         */
+        inline void euler( const Quaternion& q, def::IMU_t& imu )
+        {
+            float sin_pitch = 2.0f * ( q.w * q.y - q.z * q.x );
+            sin_pitch = sin_pitch > 1.0f ? 1.0f : sin_pitch < -1.0f ? -1.0f : sin_pitch;
+
+            imu.roll = DEG_PER_RAD * atan2f( 2.0f * ( q.w * q.x + q.y * q.z ), 1.0f - 2.0f * ( q.x * q.x + q.y * q.y ) );
+            imu.pitch = DEG_PER_RAD * asinf( sin_pitch );
+            imu.yaw = DEG_PER_RAD * atan2f( 2.0f * ( q.w * q.z + q.x * q.y ), 1.0f - 2.0f * ( q.y * q.y + q.z * q.z ) );
+        }
+    }
+
+    /**
+     * @brief Madgwick gradient descent orientation filter
+     *
+     * @details Gyro rates are integrated and nudged down the gradient of the
+     *          error between where gravity and, if there is a reading, the
+     *          magnetic field should point and where they are measured. The
+     *          error terms are worked out once and shared by the four
+     *          gradient components. Without a magnetometer, all zeros, yaw
+     *          only comes from the gyros and drifts
+     *
+     *          ahrs::Madgwick<> filter( 1000.0f );  // Updated at 1 kHz
+     *          filter.update( imu );                // Raw fields
+     *          filter.attitude( imu );              // Fills yaw, pitch, roll
+     *
+     * @tparam Sqrt Exact or Fast inverse square root
+     */
+    template< typename Sqrt = Exact >
+    class Madgwick
+    {
+    public:
+        /**
+         * @brief Constructor, starts level and pointing north
+         *
+         * @param rate_hz Update rate for the fixed step update()
+         * @param beta Gradient step, higher trusts the accelerometer and magnetometer more
+         */
+        explicit Madgwick( float rate_hz, float beta = 0.1f ) : m_beta( beta )
+        {
+            rate( rate_hz );
+            reset();
+        }
+
+        /**
+         * @brief Change the update rate of the fixed step update()
+         */
+        void rate( float rate_hz ) { m_half_dt = 0.5f / rate_hz; }
+
+        /**
+         * @brief Go back to level and pointing north
+         */
+        void reset( void )
+        {
+            Quaternion q = { 1.0f, 0.0f, 0.0f, 0.0f };
+            m_q = q;
+        }
+
+        /**
+         * @brief Update with one fixed step at the rate given
+         *
+         * @param imu Accelerations in g, rates in deg/s and field in uT
+         */
+        void update( const def::IMU_t& imu ) { step( imu, m_half_dt ); }
+
+        /**
+         * @brief Update with a step of any length
+         *
+         * @param imu Accelerations in g, rates in deg/s and field in uT
+         * @param dt Time since the last update in seconds
+         */
+        void update( const def::IMU_t& imu, float dt ) { step( imu, 0.5f * dt ); }
+
+        /**
+         * @brief Write the attitude into the yaw, pitch and roll fields
+         */
+        void attitude( def::IMU_t& imu ) const { detail::euler( m_q, imu ); }
+
+        /**
+         * @brief Current orientation
+         */
+        const Quaternion& quaternion( void ) const { return m_q; }
+
+    private:
+        void step( const def::IMU_t& imu, float half_dt )
+        {
+            float q0 = m_q.w, q1 = m_q.x, q2 = m_q.y, q3 = m_q.z;
+            float gx = imu.gx * RAD_PER_DEG, gy = imu.gy * RAD_PER_DEG, gz = imu.gz * RAD_PER_DEG;
+
+            // Rate of change from the gyros, halved when applied
+            float dq0 = -q1 * gx - q2 * gy - q3 * gz;
+            float dq1 = q0 * gx + q2 * gz - q3 * gy;
+            float dq2 = q0 * gy - q1 * gz + q3 * gx;
+            float dq3 = q0 * gz + q1 * gy - q2 * gx;
+
+            float ax = imu.ax, ay = imu.ay, az = imu.az;
+            if( detail::normalize< Sqrt >( ax, ay, az ) )
+            {
+                float q0q0 = q0 * q0, q1q1 = q1 * q1, q2q2 = q2 * q2, q3q3 = q3 * q3;
+                float q0q1 = q0 * q1, q0q2 = q0 * q2, q0q3 = q0 * q3;
+                float q1q2 = q1 * q2, q1q3 = q1 * q3, q2q3 = q2 * q3;
+                float _2q0 = 2.0f * q0, _2q1 = 2.0f * q1, _2q2 = 2.0f * q2, _2q3 = 2.0f * q3;
+
+                // Error between predicted and measured gravity
+                float f1 = 2.0f * ( q1q3 - q0q2 ) - ax;
+                float f2 = 2.0f * ( q0q1 + q2q3 ) - ay;
+                float f3 = 1.0f - 2.0f * ( q1q1 + q2q2 ) - az;
+
+                float s0 = -_2q2 * f1 + _2q1 * f2;
+                float s1 = _2q3 * f1 + _2q0 * f2 - 4.0f * q1 * f3;
+                float s2 = -_2q0 * f1 + _2q3 * f2 - 4.0f * q2 * f3;
+                float s3 = _2q1 * f1 + _2q2 * f2;
+
+                float mx = imu.mx, my = imu.my, mz = imu.mz;
+                if( detail::normalize< Sqrt >( mx, my, mz ) )
+                {
+                    // Field in the earth frame, flattened onto north and down
+                    float hx = mx * ( q0q0 + q1q1 - q2q2 - q3q3 ) + 2.0f * ( my * ( q1q2 - q0q3 ) + mz * ( q0q2 + q1q3 ) );
+                    float hy = 2.0f * ( mx * ( q0q3 + q1q2 ) + mz * ( q2q3 - q0q1 ) ) + my * ( q0q0 - q1q1 + q2q2 - q3q3 );
+                    float _2bx = sqrtf( hx * hx + hy * hy );
+                    float _2bz = 2.0f * ( mx * ( q1q3 - q0q2 ) + my * ( q0q1 + q2q3 ) ) + mz * ( q0q0 - q1q1 - q2q2 + q3q3 );
+                    float _4bx = 2.0f * _2bx, _4bz = 2.0f * _2bz;
+
+                    // Error between predicted and measured field
+                    float f4 = _2bx * ( 0.5f - q2q2 - q3q3 ) + _2bz * ( q1q3 - q0q2 ) - mx;
+                    float f5 = _2bx * ( q1q2 - q0q3 ) + _2bz * ( q0q1 + q2q3 ) - my;
+                    float f6 = _2bx * ( q0q2 + q1q3 ) + _2bz * ( 0.5f - q1q1 - q2q2 ) - mz;
+
+                    s0 += -_2bz * q2 * f4 + ( _2bz * q1 - _2bx * q3 ) * f5 + _2bx * q2 * f6;
+                    s1 += _2bz * q3 * f4 + ( _2bx * q2 + _2bz * q0 ) * f5 + ( _2bx * q3 - _4bz * q1 ) * f6;
+                    s2 += ( -_4bx * q2 - _2bz * q0 ) * f4 + ( _2bx * q1 + _2bz * q3 ) * f5 + ( _2bx * q0 - _4bz * q2 ) * f6;
+                    s3 += ( _2bz * q1 - _4bx * q3 ) * f4 + ( _2bz * q2 - _2bx * q0 ) * f5 + _2bx * q1 * f6;
+                }
+
+                float norm = s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3;
+                if( norm > 0.0f )
+                {
+                    // Twice the step, undone by the half applied below
+                    norm = 2.0f * m_beta * Sqrt::inv_sqrt( norm );
+                    dq0 -= norm * s0;
+                    dq1 -= norm * s1;
+                    dq2 -= norm * s2;
+                    dq3 -= norm * s3;
+                }
+            }
+
+            m_q.w = q0 + dq0 * half_dt;
+            m_q.x = q1 + dq1 * half_dt;
+            m_q.y = q2 + dq2 * half_dt;
+            m_q.z = q3 + dq3 * half_dt;
+            detail::normalize< Sqrt >( m_q );
+        }
+
+        Quaternion m_q;     // Orientation
+        float m_beta;       // Gradient step
+        float m_half_dt;    // Half the fixed step [ s ]
+    };
+
+    /**
+     * @brief Mahony complementary filter on the rotation group
+     *
+     * @details The cross product between predicted and measured gravity and
+     *          field is fed back into the gyro rates through a proportional
+     *          and an integral gain. The integral learns the gyro bias.
+     *          Cheaper than Madgwick, about half the multiplies
+     *
+     * @tparam Sqrt Exact or Fast inverse square root
+     */
+    template< typename Sqrt = Exact >
+    class Mahony
+    {
+    public:
+        /**
+         * @brief Constructor, starts level and pointing north
+         *
+         * @param rate_hz Update rate for the fixed step update()
+         * @param kp Proportional gain
+         * @param ki Integral gain, 0 to not learn the gyro bias
+         */
+        explicit Mahony( float rate_hz, float kp = 1.0f, float ki = 0.0f ) : m_kp( kp ), m_ki( ki )
+        {
+            rate( rate_hz );
+            reset();
+        }
+
+        /**
+         * @brief Change the update rate of the fixed step update()
+         */
+        void rate( float rate_hz ) { m_dt = 1.0f / rate_hz; }
+
+        /**
+         * @brief Go back to level and pointing north and forget the bias
+         */
+        void reset( void )
+        {
+            Quaternion q = { 1.0f, 0.0f, 0.0f, 0.0f };
+            m_q = q;
+            m_bias[ 0 ] = m_bias[ 1 ] = m_bias[ 2 ] = 0.0f;
+        }
+
+        /**
+         * @brief Update with one fixed step at the rate given
+         *
+         * @param imu Accelerations in g, rates in deg/s and field in uT
+         */
+        void update( const def::IMU_t& imu ) { step( imu, m_dt ); }
+
+        /**
+         * @brief Update with a step of any length
+         *
+         * @param imu Accelerations in g, rates in deg/s and field in uT
+         * @param dt Time since the last update in seconds
+         */
+        void update( const def::IMU_t& imu, float dt ) { step( imu, dt ); }
+
+        /**
+         * @brief Write the attitude into the yaw, pitch and roll fields
+         */
+        void attitude( def::IMU_t& imu ) const { detail::euler( m_q, imu ); }
+
+        /**
+         * @brief Current orientation
+         */
+        const Quaternion& quaternion( void ) const { return m_q; }
+
+    private:
+        void step( const def::IMU_t& imu, float dt )
+        {
+            float q0 = m_q.w, q1 = m_q.x, q2 = m_q.y, q3 = m_q.z;
+            float gx = imu.gx * RAD_PER_DEG, gy = imu.gy * RAD_PER_DEG, gz = imu.gz * RAD_PER_DEG;
+
+            float ax = imu.ax, ay = imu.ay, az = imu.az;
+            if( detail::normalize< Sqrt >( ax, ay, az ) )
+            {
+                float q0q0 = q0 * q0, q1q1 = q1 * q1, q2q2 = q2 * q2, q3q3 = q3 * q3;
+                float q0q1 = q0 * q1, q0q2 = q0 * q2, q0q3 = q0 * q3;
+                float q1q2 = q1 * q2, q1q3 = q1 * q3, q2q3 = q2 * q3;
+
+                // Half of gravity in the sensor frame
+                float vx = q1q3 - q0q2;
+                float vy = q0q1 + q2q3;
+                float vz = q0q0 - 0.5f + q3q3;
+
+                // Half the error, measured cross predicted
+                float ex = ay * vz - az * vy;
+                float ey = az * vx - ax * vz;
+                float ez = ax * vy - ay * vx;
+
+                float mx = imu.mx, my = imu.my, mz = imu.mz;
+                if( detail::normalize< Sqrt >( mx, my, mz ) )
+                {
+                    // Field in the earth frame, flattened onto north and down
+                    float hx = 2.0f * ( mx * ( 0.5f - q2q2 - q3q3 ) + my * ( q1q2 - q0q3 ) + mz * ( q1q3 + q0q2 ) );
+                    float hy = 2.0f * ( mx * ( q1q2 + q0q3 ) + my * ( 0.5f - q1q1 - q3q3 ) + mz * ( q2q3 - q0q1 ) );
+                    float bx = sqrtf( hx * hx + hy * hy );
+                    float bz = 2.0f * ( mx * ( q1q3 - q0q2 ) + my * ( q2q3 + q0q1 ) + mz * ( 0.5f - q1q1 - q2q2 ) );
+
+                    // Half of it back in the sensor frame
+                    float wx = bx * ( 0.5f - q2q2 - q3q3 ) + bz * ( q1q3 - q0q2 );
+                    float wy = bx * ( q1q2 - q0q3 ) + bz * ( q0q1 + q2q3 );
+                    float wz = bx * ( q0q2 + q1q3 ) + bz * ( 0.5f - q1q1 - q2q2 );
+
+                    ex += my * wz - mz * wy;
+                    ey += mz * wx - mx * wz;
+                    ez += mx * wy - my * wx;
+                }
+
+                if( m_ki > 0.0f )
+                {
+                    float gain = 2.0f * m_ki * dt;
+                    m_bias[ 0 ] += gain * ex;
+                    m_bias[ 1 ] += gain * ey;
+                    m_bias[ 2 ] += gain * ez;
+                    gx += m_bias[ 0 ];
+                    gy += m_bias[ 1 ];
+                    gz += m_bias[ 2 ];
+                }
+
+                float gain = 2.0f * m_kp;
+                gx += gain * ex;
+                gy += gain * ey;
+                gz += gain * ez;
+            }
+
+            float half_dt = 0.5f * dt;
+            gx *= half_dt;
+            gy *= half_dt;
+            gz *= half_dt;
+
+            m_q.w = q0 - q1 * gx - q2 * gy - q3 * gz;
+            m_q.x = q1 + q0 * gx + q2 * gz - q3 * gy;
+            m_q.y = q2 + q0 * gy - q1 * gz + q3 * gx;
+            m_q.z = q3 + q0 * gz + q1 * gy - q2 * gx;
+            detail::normalize< Sqrt >( m_q );
+        }
+
+        Quaternion m_q;     // Orientation
+        float m_kp;         // Proportional gain
+        float m_ki;         // Integral gain
+        float m_bias[ 3 ];  // Learned gyro bias correction [ rad/s ]
+        float m_dt;         // Fixed step [ s ]
+    };
+
+    /**
+     * @brief Run a filter on every sample an IMU publishes
+     *
+     * @details The IMU's publish() updates the filter with the fixed step
+     *          and writes yaw, pitch and roll before readers see the sample.
+     *          Give the filter the rate update() is called at
+     *
+     * @param imu IMU whose driver calls publish() from update()
+     * @param filter Madgwick or Mahony, must outlive the IMU
+     */
+    template< typename Filter >
+    void attach( sensor::IMU& imu, Filter& filter )
+    {
+        imu.fuse( []( def::IMU_t& data, void* context )
+        {
+            Filter* f = static_cast< Filter* >( context );
+            f->update( data );
+            f->attitude( data );
+        }, &filter );
+    }
+
+    /**
+     * @brief Run a filter over a recorded log at its fixed step
+     *
+     * @param filter Madgwick or Mahony, continues from its current state
+     * @param samples Samples in order, yaw, pitch and roll are written
+     * @param n Number of samples
+     */
+    template< typename Filter >
+    void process( Filter& filter, def::IMU_t* samples, size_t n )
+    {
+        for( size_t i = 0; i < n; ++i )
+        {
+            filter.update( samples[ i ] );
+            filter.attitude( samples[ i ] );
+        }
+    }
+
+    /**
+     * @brief Run a filter over a recorded log, stepping by its timestamps
+     *
+     * @details The first sample uses the filter's fixed step, the rest the
+     *          time since the one before, so gaps in a log are integrated
+     *          over rather than squeezed
+     *
+     * @param filter Madgwick or Mahony, continues from its current state
+     * @param samples Samples in order, yaw, pitch and roll are written
+     * @param times_us Receive time of each sample in microseconds
+     * @param n Number of samples
+     */
+    template< typename Filter >
+    void process( Filter& filter, def::IMU_t* samples, const uint64_t* times_us, size_t n )
+    {
+        for( size_t i = 0; i < n; ++i )
+        {
+            if( i == 0 )
+                filter.update( samples[ i ] );
+            else
+                filter.update( samples[ i ], static_cast< float >( times_us[ i ] - times_us[ i - 1 ] ) * 1e-6f );
+
+            filter.attitude( samples[ i ] );
+        }
+    }
+} // End of namespace ahrs
+
+/*! @} End of Doxygen Groups*/
+
+} // End of namespace aero
+
+/*! @} End of Doxygen Groups*/
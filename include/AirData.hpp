@@ -0,0 +1,265 @@
+#pragma once
+
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    #include "Arduino.h"
+#else
+    #include <cstddef>
+    #include <cstdint>
+    #include <cmath>
+#endif
+
+#include "Data.hpp"
+#include "Fixed.hpp"
+#include "Snapshot.hpp"
+#include "Utility.hpp"
+
+/*!
+ *  \addtogroup aero
+ *  @{
+ */
+
+//! Aero library code
+namespace aero
+{
+
+/*!
+ *  \addtogroup convert
+ *  @{
+ */
+
+//! Data conversion helper functions
+namespace convert
+{
+    /**
+     * @brief Fills every field of AirData_t from pitot and environment samples
+     *
+     * @details Speeds and altitudes come from the convert:: functions, with
+     *          tas from ias like fixed::compute, agl from the ground set by
+     *          ground() and approx_temp at agl, and give the same bits as
+     *          calling them one by one. Terms they share are worked out once:
+     *          the pressure altitude behind agl, msl and approx_temp takes one
+     *          powf instead of three, and the temperature in kelvin is turned
+     *          into its inverse and root once for tas, density and density
+     *          altitude. Multiplying by the inverse moves density and
+     *          density_alt by up to a part in 10^5 from the convert:: values
+     *
+     *          Inputs are compared with the last update and only the outputs
+     *          that depend on one that changed are worked out again. Pitots
+     *          usually report several times per environment reading, which
+     *          then costs two powf and a sqrtf instead of six powf
+     *
+     *          Fields hold Q16.16 bits, read them back with
+     *          fixed::Q16_16::from_raw. Speeds in m/s, altitudes in m,
+     *          approx_temp in Celsius and density in kg/m^3
+     */
+    class AirDataComputer
+    {
+    public:
+        /**
+         * @brief Outputs worked out again by an update, as bit flags
+         */
+        enum Changed : uint8_t
+        {
+            IAS = 1 << 0,
+            EAS = 1 << 1,
+            TAS = 1 << 2,
+            ALTITUDE = 1 << 3,      // pressure_alt, agl and msl
+            DENSITY = 1 << 4        // density_alt, approx_temp and density
+        };
+
+        /** @brief Defines where altitudes are measured from */
+        struct Config_t
+        {
+            float ground_altitude;  // Pressure altitude of the ground, agl is 0 there [ m ]
+            float start_altitude;   // Height of the ground above sea level, for msl   [ m ]
+        };
+
+        /**
+         * @brief Constructor, the ground starts at standard sea level
+         */
+        AirDataComputer( ) : m_config(), m_data(),
+            m_inverse_kelvin( 0.0f ), m_root_theta( 0.0f ), m_ias( 0.0f ), m_agl( 0.0f )
+        {
+            invalidate();
+        }
+
+        /**
+         * @brief Constructor
+         *
+         * @param config Where altitudes are measured from
+         */
+        explicit AirDataComputer( const Config_t& config ) : m_config( config ), m_data(),
+            m_inverse_kelvin( 0.0f ), m_root_theta( 0.0f ), m_ias( 0.0f ), m_agl( 0.0f )
+        {
+            invalidate();
+        }
+
+        /**
+         * @brief Change where altitudes are measured from
+         */
+        void config( const Config_t& config )
+        {
+            m_config = config;
+            invalidate();
+        }
+
+        const Config_t& config( void ) const { return m_config; }
+
+        /**
+         * @brief Make the current pressure the ground, so agl reads 0 there
+         *
+         * @param enviro Reading taken on the ground, pressure in Pa
+         * @param start_altitude Height of the ground above sea level in m
+         */
+        void ground( const def::Enviro_t& enviro, float start_altitude )
+        {
+            m_config.ground_altitude = pressure_altitude( enviro.pressure );
+            m_config.start_altitude = start_altitude;
+            invalidate();
+        }
+
+        /**
+         * @brief Work out the outputs whose inputs changed
+         *
+         * @param pitot Differential pressure in Pa
+         * @param enviro Pressure in Pa and temperature in Celsius
+         * @param out Segment to fill, every field is written
+         * @return uint8_t Changed flags of the outputs worked out again
+         */
+        uint8_t update( const def::Pitot_t& pitot, const def::Enviro_t& enviro, def::AirData_t& out )
+        {
+            uint8_t changed = update( pitot, enviro );
+            out = m_data;
+            return changed;
+        }
+
+        /**
+         * @brief Work out the outputs whose inputs changed, from published samples
+         *
+         * @details Samples whose sequence numbers were seen last time are
+         *          skipped without looking at their values
+         *
+         * @param pitot Latest pitot sample
+         * @param enviro Latest environmental sensor sample
+         * @param out Segment to fill, every field is written
+         * @return uint8_t Changed flags of the outputs worked out again
+         */
+        uint8_t update( const Sample< def::Pitot_t >& pitot, const Sample< def::Enviro_t >& enviro, def::AirData_t& out )
+        {
+            uint8_t changed = 0;
+            if( pitot.sequence != m_pitot_sequence || enviro.sequence != m_enviro_sequence )
+                changed = update( pitot.data, enviro.data );
+
+            m_pitot_sequence = pitot.sequence;
+            m_enviro_sequence = enviro.sequence;
+            out = m_data;
+            return changed;
+        }
+
+        /**
+         * @brief Outputs of the last update
+         */
+        const def::AirData_t& data( void ) const { return m_data; }
+
+    private:
+        static uint32_t bits( float value ) { return static_cast< uint32_t >( fixed::Q16_16::from_float( value ).raw ); }
+
+        /**
+         * @brief Forget the last inputs so the next update works out everything
+         */
+        void invalidate( void )
+        {
+            m_dp = m_pressure = m_temperature = NAN;
+            m_pitot_sequence = m_enviro_sequence = UINT32_MAX;
+        }
+
+        uint8_t update( const def::Pitot_t& pitot, const def::Enviro_t& enviro )
+        {
+            const float dp = pitot.differential_pressure;
+            const float p = enviro.pressure;
+            const float t = enviro.temperature;
+
+            // NaN never compares equal, so invalidate() forces every group
+            const bool dp_changed = !( dp == m_dp );
+            const bool p_changed = !( p == m_pressure );
+            const bool t_changed = !( t == m_temperature );
+            uint8_t changed = 0;
+
+            m_dp = dp;
+            m_pressure = p;
+            m_temperature = t;
+
+            if( t_changed )
+            {
+                float kelvin = t + 273.15f;
+                m_inverse_kelvin = 1.0f / kelvin;
+                m_root_theta = sqrtf( kelvin / sl_temperature );
+            }
+
+            if( dp_changed )
+            {
+                m_ias = cal_as( dp );
+                m_data.ias = bits( m_ias );
+                changed |= IAS;
+            }
+
+            if( dp_changed || p_changed )
+            {
+                m_data.eas = bits( equiv_as( dp, p ) );
+                changed |= EAS;
+            }
+
+            if( dp_changed || t_changed )
+            {
+                m_data.tas = bits( m_ias * m_root_theta );
+                changed |= TAS;
+            }
+
+            if( p_changed )
+            {
+                float altitude = pressure_altitude( p );
+                m_agl = altitude - m_config.ground_altitude;
+
+                m_data.pressure_alt = bits( altitude );
+                m_data.agl = bits( m_agl );
+                m_data.msl = bits( m_agl + m_config.start_altitude );
+                changed |= ALTITUDE;
+            }
+
+            if( p_changed || t_changed )
+            {
+                float ratio = p * ( 1.0f / sl_pressure ) * ( sl_temperature * m_inverse_kelvin );
+                float exponent = ( lapse * gas_const ) / ( air_mass * gravity - lapse * gas_const );
+
+                m_data.density_alt = bits( ( sl_temperature / lapse ) * ( 1.0f - powf( ratio, exponent ) ) );
+                m_data.approx_temp = bits( t - lapse * m_agl );
+                m_data.density = bits( ( air_mass / gas_const ) * p * m_inverse_kelvin );
+                changed |= DENSITY;
+            }
+
+            return changed;
+        }
+
+        Config_t m_config;          // Where altitudes are measured from
+        def::AirData_t m_data;      // Outputs in Q16.16
+
+        // Inputs of the last update
+        float m_dp;                 // Differential pressure    [ Pa ]
+        float m_pressure;           // Static pressure          [ Pa ]
+        float m_temperature;        // Temperature              [ C ]
+        uint32_t m_pitot_sequence;  // Last pitot sample seen
+        uint32_t m_enviro_sequence; // Last environment sample seen
+
+        // Terms shared between outputs
+        float m_inverse_kelvin;     // 1 / temperature          [ 1/K ]
+        float m_root_theta;         // sqrt( T / T0 ), scales ias to tas
+        float m_ias;                // Calibrated airspeed      [ m/s ]
+        float m_agl;                // Above ground level       [ m ]
+    };
+} // End of namespace convert
+
+/*! @} End of Doxygen Groups*/
+
+} // End of namespace aero
+
+/*! @} End of Doxygen Groups*/
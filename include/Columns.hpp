@@ -0,0 +1,658 @@
+#pragma once
+
+// Columns are for analysis on a host, the boards only produce frames
+#if !defined(ARDUINO) && !defined(CORE_TEENSY)
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "Message.hpp"
+#include "Reflect.hpp"
+#include "Schema.hpp"
+
+/*!
+ *  \addtogroup aero
+ *  @{
+ */
+
+//! Aero library code
+namespace aero
+{
+
+/*
+    Export layout, all values little endian
+
+    | header | fields ... | times | column 0 | column 1 | ... |
+
+    Each field is its type and name
+
+    | type u8 | name length u8 | name |
+
+    Times are the first timestamp in microseconds followed by the change
+    from the previous row as a zigzag varint, two bytes a row at 200 Hz.
+    Each column is its values packed back to back with no padding
+*/
+
+//! Per-field layout of segments for the column store
+namespace columns
+{
+    const uint64_t MAGIC = 0x314C4F434F524541ULL;   // "AEROCOL1"
+    const uint32_t VERSION = 1;
+
+    /**
+     * @brief Start of an export
+     */
+    struct Header
+    {
+        uint64_t magic;             // MAGIC
+        uint32_t version;           // VERSION
+        uint16_t signature;         // Segment bit of the columns
+        uint16_t fields;            // Number of columns
+        uint64_t rows;              // Number of rows
+    };
+
+    static_assert( sizeof( Header ) == 24, "Column structures must not be padded" );
+
+    /**
+     * @brief Swap a header between host order and file order, either way
+     */
+    inline void byte_order( Header& header )
+    {
+        header.magic = bit::to_little_endian( header.magic );
+        header.version = bit::to_little_endian( header.version );
+        header.signature = bit::to_little_endian( header.signature );
+        header.fields = bit::to_little_endian( header.fields );
+        header.rows = bit::to_little_endian( header.rows );
+    }
+
+    /**
+     * @brief Swap packed values of a width between host order and file order, either way
+     */
+    inline void byte_order( uint8_t* data, size_t width, size_t count )
+    {
+        if( bit::HOST_ORDER == bit::Order::Little )
+            return;
+
+        if( width == 2 )
+            bit::swap_endian( reinterpret_cast< uint16_t* >( data ), count );
+        else if( width == 4 )
+            bit::swap_endian( reinterpret_cast< uint32_t* >( data ), count );
+    }
+
+    using reflect::Type;
+    using reflect::TypeOf;
+    using reflect::width;
+
+    /**
+     * @brief One field of a segment
+     */
+    struct Field
+    {
+        const char* name;   // Member name
+        size_t offset;      // Offset in the segment
+        Type type;          // Storage type
+    };
+
+    /**
+     * @brief Fields of a segment struct, taken from its reflect::Describe
+     *
+     * @tparam T segment struct
+     */
+    template< typename T >
+    struct Layout
+    {
+        static const size_t count = reflect::count< T >();
+
+        static const Field* fields( void )
+        {
+            static const Table table;
+            return table.list;
+        }
+
+    private:
+        struct Table
+        {
+            Table( )
+            {
+                size_t i = 0;
+                reflect::for_each< T >( [ & ]( const auto& field ) { list[ i++ ] = { field.name, field.offset, field.type }; } );
+            }
+
+            Field list[ count ];
+        };
+    };
+
+    template< typename T > const size_t Layout< T >::count;
+
+    /**
+     * @brief Contiguous run of column values, valid until the store is cleared
+     */
+    template< typename V >
+    struct Span
+    {
+        const V* data;
+        size_t size;
+    };
+
+    /**
+     * @brief Summary of a column over a range of rows
+     */
+    struct Stats
+    {
+        double min;
+        double max;
+        double mean;
+        size_t count;   // Rows in the range, the rest is 0 when there are none
+    };
+} // End of namespace columns
+
+/**
+ * @brief Column store for one segment type with a timestamp per row
+ *
+ * @details Every field of the segment gets its own contiguous column, so a
+ *          scan over one field reads only that field. Columns grow in chunks
+ *          of CHUNK rows that never move, spans stay valid while rows are
+ *          appended. Rows should be appended in time order for range()
+ *
+ * @tparam T Segment struct with a reflect::Describe
+ * @tparam CHUNK Rows per chunk
+ */
+template< typename T, size_t CHUNK = 4096 >
+class TelemetryColumns
+{
+public:
+    typedef columns::Layout< T > Layout;
+
+    static const size_t COLUMNS = Layout::count;
+
+    /**
+     * @brief Constructor
+     */
+    TelemetryColumns( ) : m_rows( 0 ) {}
+
+    TelemetryColumns( const TelemetryColumns& ) = delete;
+    TelemetryColumns& operator=( const TelemetryColumns& ) = delete;
+
+    /**
+     * @brief Add a row
+     *
+     * @param time_us Timestamp in microseconds
+     * @param segment Segment to split into the columns
+     */
+    void append( uint64_t time_us, const T& segment )
+    {
+        size_t slot = m_rows % CHUNK;
+
+        if( slot == 0 )
+            m_chunks.push_back( Chunk() );
+
+        Chunk& chunk = m_chunks.back();
+        const uint8_t* src = reinterpret_cast< const uint8_t* >( &segment );
+
+        chunk.times[ slot ] = time_us;
+
+        // Unrolled per field so every copy has a constant size
+        size_t i = 0;
+        reflect::for_each< T >( [ & ]( const auto& field )
+        {
+            const size_t size = sizeof( typename std::remove_reference< decltype( field ) >::type::value_type );
+            memcpy( chunk.column( i++ ) + slot * size, src + field.offset, size );
+        } );
+
+        ++m_rows;
+    }
+
+    /**
+     * @brief Add a row from a frame if it has the segment
+     *
+     * @param time_us Timestamp in microseconds
+     * @param view Frame to read from
+     * @return true if the frame had the segment
+     */
+    bool append( uint64_t time_us, const MessageView& view )
+    {
+        T segment;
+
+        if( !view.copy( segment ) )
+            return false;
+
+        append( time_us, segment );
+        return true;
+    }
+
+    /**
+     * @brief Remove every row
+     */
+    void clear( void )
+    {
+        m_chunks.clear();
+        m_rows = 0;
+    }
+
+    /**
+     * @brief Number of rows
+     */
+    size_t rows( void ) const { return m_rows; }
+
+    /**
+     * @brief Number of chunks, each a span of up to CHUNK rows
+     */
+    size_t chunks( void ) const { return m_chunks.size(); }
+
+    /**
+     * @brief Description of a column
+     */
+    const columns::Field& field( size_t column ) const { return Layout::fields()[ column ]; }
+
+    /**
+     * @brief Find a column by field name
+     *
+     * @param name Member name such as "az"
+     * @return int Column index, -1 if there is no such field
+     */
+    int find( const char* name ) const
+    {
+        for( size_t i = 0; i < COLUMNS; ++i )
+            if( strcmp( Layout::fields()[ i ].name, name ) == 0 )
+                return static_cast< int >( i );
+
+        return -1;
+    }
+
+    /**
+     * @brief Timestamps of a chunk without copying
+     *
+     * @param chunk Chunk index
+     * @return columns::Span< uint64_t > Timestamps in microseconds
+     */
+    columns::Span< uint64_t > times( size_t chunk ) const
+    {
+        columns::Span< uint64_t > span = { m_chunks[ chunk ].times.get(), chunk_rows( chunk ) };
+        return span;
+    }
+
+    /**
+     * @brief Values of a column in a chunk without copying
+     *
+     * @tparam V Field type, must match the column
+     * @param column Column index
+     * @param chunk Chunk index
+     * @return columns::Span< V > Values, empty if V is not the column type
+     */
+    template< typename V >
+    columns::Span< V > span( size_t column, size_t chunk ) const
+    {
+        columns::Span< V > span = { NULL, 0 };
+
+        if( columns::TypeOf< V >::type != field( column ).type )
+            return span;
+
+        span.data = reinterpret_cast< const V* >( m_chunks[ chunk ].column( column ) );
+        span.size = chunk_rows( chunk );
+        return span;
+    }
+
+    /**
+     * @brief Timestamp of a row
+     */
+    uint64_t time( size_t row ) const { return m_chunks[ row / CHUNK ].times[ row % CHUNK ]; }
+
+    /**
+     * @brief Value of one cell as a double
+     */
+    double value( size_t column, size_t row ) const
+    {
+        const uint8_t* data = m_chunks[ row / CHUNK ].column( column );
+        size_t slot = row % CHUNK;
+
+        switch( field( column ).type )
+        {
+            case columns::Type::Bool:   return load< bool >( data, slot );
+            case columns::Type::U8:     return load< uint8_t >( data, slot );
+            case columns::Type::U16:    return load< uint16_t >( data, slot );
+            case columns::Type::U32:    return load< uint32_t >( data, slot );
+            case columns::Type::I16:    return load< int16_t >( data, slot );
+            case columns::Type::I32:    return load< int32_t >( data, slot );
+            default:                    return load< float >( data, slot );
+        }
+    }
+
+    /**
+     * @brief Rows with a timestamp in [from_us, to_us]
+     *
+     * @param from_us Earliest timestamp
+     * @param to_us Latest timestamp
+     * @param first First row in the range
+     * @param last One past the last row in the range
+     */
+    void range( uint64_t from_us, uint64_t to_us, size_t& first, size_t& last ) const
+    {
+        first = lower_bound( from_us );
+        last = to_us == UINT64_MAX ? m_rows : lower_bound( to_us + 1 );
+
+        if( last < first )
+            last = first;
+    }
+
+    /**
+     * @brief Minimum, maximum and mean of a column over rows [first, last)
+     *
+     * @param column Column index
+     * @param first First row
+     * @param last One past the last row
+     * @return columns::Stats Summary of the rows
+     */
+    columns::Stats stats( size_t column, size_t first, size_t last ) const
+    {
+        columns::Stats result = { 0.0, 0.0, 0.0, 0 };
+        double sum = 0.0;
+
+        if( last > m_rows )
+            last = m_rows;
+
+        while( first < last )
+        {
+            size_t chunk = first / CHUNK;
+            size_t slot = first % CHUNK;
+            size_t n = std::min( last - first, CHUNK - slot );
+            const uint8_t* data = m_chunks[ chunk ].column( column );
+
+            switch( field( column ).type )
+            {
+                case columns::Type::Bool:   scan< bool >( data, slot, n, result, sum ); break;
+                case columns::Type::U8:     scan< uint8_t >( data, slot, n, result, sum ); break;
+                case columns::Type::U16:    scan< uint16_t >( data, slot, n, result, sum ); break;
+                case columns::Type::U32:    scan< uint32_t >( data, slot, n, result, sum ); break;
+                case columns::Type::I16:    scan< int16_t >( data, slot, n, result, sum ); break;
+                case columns::Type::I32:    scan< int32_t >( data, slot, n, result, sum ); break;
+                default:                    scan< float >( data, slot, n, result, sum ); break;
+            }
+
+            first += n;
+        }
+
+        if( result.count > 0 )
+            result.mean = sum / result.count;
+
+        return result;
+    }
+
+    /**
+     * @brief Minimum, maximum and mean of a column over a time range
+     *
+     * @param column Column index
+     * @param from_us Earliest timestamp
+     * @param to_us Latest timestamp
+     * @return columns::Stats Summary of the rows
+     */
+    columns::Stats stats_between( size_t column, uint64_t from_us, uint64_t to_us ) const
+    {
+        size_t first, last;
+        range( from_us, to_us, first, last );
+        return stats( column, first, last );
+    }
+
+    /**
+     * @brief Export every row, see the layout above
+     *
+     * @param file File opened for binary writing
+     * @return true if everything was written
+     */
+    bool write( FILE* file ) const
+    {
+        columns::Header header;
+        header.magic = columns::MAGIC;
+        header.version = columns::VERSION;
+        header.signature = schema::bit_of< T >();
+        header.fields = static_cast< uint16_t >( COLUMNS );
+        header.rows = m_rows;
+        columns::byte_order( header );
+
+        if( fwrite( &header, sizeof( header ), 1, file ) != 1 )
+            return false;
+
+        for( size_t i = 0; i < COLUMNS; ++i )
+        {
+            uint8_t info[ 2 ] = { static_cast< uint8_t >( field( i ).type ),
+                                  static_cast< uint8_t >( strlen( field( i ).name ) ) };
+
+            if( fwrite( info, 2, 1, file ) != 1 || fwrite( field( i ).name, info[ 1 ], 1, file ) != 1 )
+                return false;
+        }
+
+        // Times as zigzag varint deltas, the first against 0
+        std::vector< uint8_t > buf;
+        uint64_t previous = 0;
+
+        for( size_t row = 0; row < m_rows; ++row )
+        {
+            uint64_t now = time( row );
+            int64_t delta = static_cast< int64_t >( now - previous );
+            uint64_t zigzag = ( static_cast< uint64_t >( delta ) << 1 ) ^ static_cast< uint64_t >( delta >> 63 );
+
+            while( zigzag >= 0x80 )
+            {
+                buf.push_back( static_cast< uint8_t >( zigzag | 0x80 ) );
+                zigzag >>= 7;
+            }
+
+            buf.push_back( static_cast< uint8_t >( zigzag ) );
+            previous = now;
+        }
+
+        if( !buf.empty() && fwrite( buf.data(), buf.size(), 1, file ) != 1 )
+            return false;
+
+        for( size_t i = 0; i < COLUMNS; ++i )
+        {
+            size_t size = columns::width( field( i ).type );
+
+            for( size_t c = 0; c < m_chunks.size(); ++c )
+            {
+                const uint8_t* data = m_chunks[ c ].column( i );
+
+                // Little endian hosts write the columns as they are
+                if( bit::HOST_ORDER != bit::Order::Little )
+                {
+                    buf.assign( data, data + size * chunk_rows( c ) );
+                    columns::byte_order( buf.data(), size, chunk_rows( c ) );
+                    data = buf.data();
+                }
+
+                if( fwrite( data, size, chunk_rows( c ), file ) != chunk_rows( c ) )
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Replace the contents with an export
+     *
+     * @param file File opened for binary reading
+     * @return true if the export was for T and read completely
+     */
+    bool read( FILE* file )
+    {
+        columns::Header header;
+
+        clear();
+
+        if( fread( &header, sizeof( header ), 1, file ) != 1 )
+            return false;
+
+        columns::byte_order( header );
+        if( header.magic != columns::MAGIC || header.version != columns::VERSION
+            || header.signature != schema::bit_of< T >() || header.fields != COLUMNS )
+            return false;
+
+        for( size_t i = 0; i < COLUMNS; ++i )
+        {
+            uint8_t info[ 2 ];
+            char name[ 256 ];
+
+            if( fread( info, 2, 1, file ) != 1 || fread( name, info[ 1 ], 1, file ) != 1 )
+                return false;
+
+            if( info[ 0 ] != static_cast< uint8_t >( field( i ).type ) || strlen( field( i ).name ) != info[ 1 ]
+                || memcmp( name, field( i ).name, info[ 1 ] ) != 0 )
+                return false;
+        }
+
+        uint64_t previous = 0;
+
+        for( uint64_t row = 0; row < header.rows; ++row )
+        {
+            uint64_t zigzag = 0;
+            int c;
+
+            for( int shift = 0; ; shift += 7 )
+            {
+                if( shift > 63 || ( c = fgetc( file ) ) == EOF )
+                    return fail();
+
+                zigzag |= static_cast< uint64_t >( c & 0x7F ) << shift;
+
+                if( !( c & 0x80 ) )
+                    break;
+            }
+
+            previous += ( zigzag >> 1 ) ^ ( ~( zigzag & 1 ) + 1 );
+
+            if( m_rows % CHUNK == 0 )
+                m_chunks.push_back( Chunk() );
+
+            m_chunks.back().times[ m_rows % CHUNK ] = previous;
+            ++m_rows;
+        }
+
+        for( size_t i = 0; i < COLUMNS; ++i )
+        {
+            size_t size = columns::width( field( i ).type );
+
+            for( size_t c = 0; c < m_chunks.size(); ++c )
+            {
+                if( fread( m_chunks[ c ].column( i ), size, chunk_rows( c ), file ) != chunk_rows( c ) )
+                    return fail();
+
+                columns::byte_order( m_chunks[ c ].column( i ), size, chunk_rows( c ) );
+            }
+        }
+
+        return true;
+    }
+
+private:
+    struct Chunk
+    {
+        Chunk( ) : times( new uint64_t[ CHUNK ] )
+        {
+            // Allocated as words so every column type is aligned
+            for( size_t i = 0; i < COLUMNS; ++i )
+                words[ i ].reset( new uint32_t[ ( CHUNK * columns::width( Layout::fields()[ i ].type ) + 3 ) / 4 ] );
+        }
+
+        uint8_t* column( size_t i ) const { return reinterpret_cast< uint8_t* >( words[ i ].get() ); }
+
+        std::unique_ptr< uint64_t[] > times;            // Timestamps
+        std::unique_ptr< uint32_t[] > words[ COLUMNS ]; // Column storage
+    };
+
+    // Rows in a chunk, only the last can be partly filled
+    size_t chunk_rows( size_t chunk ) const
+    {
+        return chunk + 1 < m_chunks.size() ? CHUNK : m_rows - chunk * CHUNK;
+    }
+
+    // First row with a timestamp of at least time_us
+    size_t lower_bound( uint64_t time_us ) const
+    {
+        size_t lo = 0, hi = m_rows;
+
+        while( lo < hi )
+        {
+            size_t mid = lo + ( hi - lo ) / 2;
+
+            if( time( mid ) < time_us )
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+
+        return lo;
+    }
+
+    template< typename V >
+    static V load( const uint8_t* data, size_t slot )
+    {
+        return reinterpret_cast< const V* >( data )[ slot ];
+    }
+
+    // Fold n values starting at slot into the running stats. Four lanes so
+    // the double sums don't wait on each other
+    template< typename V >
+    static void scan( const uint8_t* data, size_t slot, size_t n, columns::Stats& result, double& sum )
+    {
+        const V* values = reinterpret_cast< const V* >( data ) + slot;
+        V lo[ 4 ] = { values[ 0 ], values[ 0 ], values[ 0 ], values[ 0 ] };
+        V hi[ 4 ] = { values[ 0 ], values[ 0 ], values[ 0 ], values[ 0 ] };
+        double total[ 4 ] = { 0.0, 0.0, 0.0, 0.0 };
+        size_t i = 0;
+
+        for( ; i + 4 <= n; i += 4 )
+        {
+            for( int k = 0; k < 4; ++k )
+            {
+                lo[ k ] = values[ i + k ] < lo[ k ] ? values[ i + k ] : lo[ k ];
+                hi[ k ] = values[ i + k ] > hi[ k ] ? values[ i + k ] : hi[ k ];
+                total[ k ] += values[ i + k ];
+            }
+        }
+
+        for( ; i < n; ++i )
+        {
+            lo[ 0 ] = values[ i ] < lo[ 0 ] ? values[ i ] : lo[ 0 ];
+            hi[ 0 ] = values[ i ] > hi[ 0 ] ? values[ i ] : hi[ 0 ];
+            total[ 0 ] += values[ i ];
+        }
+
+        for( int k = 1; k < 4; ++k )
+        {
+            lo[ 0 ] = lo[ k ] < lo[ 0 ] ? lo[ k ] : lo[ 0 ];
+            hi[ 0 ] = hi[ k ] > hi[ 0 ] ? hi[ k ] : hi[ 0 ];
+        }
+
+        if( result.count == 0 || lo[ 0 ] < result.min )
+            result.min = lo[ 0 ];
+        if( result.count == 0 || hi[ 0 ] > result.max )
+            result.max = hi[ 0 ];
+
+        sum += ( total[ 0 ] + total[ 1 ] ) + ( total[ 2 ] + total[ 3 ] );
+        result.count += n;
+    }
+
+    // Leave the store empty after a bad read
+    bool fail( void )
+    {
+        clear();
+        return false;
+    }
+
+    std::vector< Chunk > m_chunks;  // Column chunks, the last may be partly filled
+    size_t m_rows;                  // Number of rows
+};
+
+/*! @} End of Doxygen Groups*/
+
+} // End of namespace aero
+
+/*! @} End of Doxygen Groups*/
+
+#endif
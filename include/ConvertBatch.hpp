@@ -0,0 +1,588 @@
+#pragma once
+
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    #include "Arduino.h"
+#else
+    #include <cstddef>
+    #include <cstdint>
+    #include <cstring>
+    #include <cmath>
+#endif
+
+#include "Simd.hpp"      // Picks AERO_SIMD_X86 or AERO_SIMD_NEON
+
+// The kernels are always inlined into their AVX2 entry points, so the
+// warning about passing AVX vectors to non AVX code never applies. Kernels
+// take and hand back vectors by reference all the same, GCC reports a
+// returned vector at the end of the translation unit where this can't
+// reach it
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+/*!
+ *  \addtogroup aero
+ *  @{
+ */
+
+//! Aero library code
+namespace aero
+{
+
+/*!
+ *  \addtogroup convert
+ *  @{
+ */
+
+//! Data conversion helper functions
+namespace convert
+{
+
+//! Vector backends and kernels behind the batch conversions
+namespace simd
+{
+    // Kernels are forced inline so they take on the target of the entry
+    // point that uses them. Backend operations are plain inline, GCC
+    // refuses to force AVX2 code into a kernel before that happens
+    #define AERO_SIMD_INLINE inline __attribute__(( always_inline ))
+
+    /**
+     * @brief One lane backend, used on boards and for the tail of every batch
+     */
+    struct Scalar
+    {
+        typedef float F;
+        static const size_t width = 1;
+
+        static inline F set( float a ) { return a; }
+        static inline F load( const float* p ) { return *p; }
+        static inline void store( float* p, F a ) { *p = a; }
+        static inline F add( F a, F b ) { return a + b; }
+        static inline F sub( F a, F b ) { return a - b; }
+        static inline F mul( F a, F b ) { return a * b; }
+        static inline F div( F a, F b ) { return a / b; }
+        static inline F sqrt( F a ) { return sqrtf( a ); }
+
+        // Same NaN behaviour as minps and maxps, the second operand wins
+        static inline F min( F a, F b ) { return a < b ? a : b; }
+        static inline F max( F a, F b ) { return a > b ? a : b; }
+
+        // Pick a where a > b holds, otherwise c
+        static inline F select_gt( F a, F b, F x, F y ) { return a > b ? x : y; }
+
+        // Round to the nearest integer, ties to even
+        static inline F round( F a ) { return nearbyintf( a ); }
+
+        // Mantissa in [ 1, 2 ) and unbiased exponent of a positive normal value
+        static inline F frexp( F a, F& e )
+        {
+            uint32_t bits;
+            memcpy( &bits, &a, sizeof( bits ) );
+            e = static_cast< float >( static_cast< int32_t >( ( bits >> 23 ) & 0xFF ) - 127 );
+            bits = ( bits & 0x007FFFFF ) | 0x3F800000;
+            memcpy( &a, &bits, sizeof( bits ) );
+            return a;
+        }
+
+        // 2^n for an integral n in [ -126, 127 ]
+        static inline F exp2i( F n )
+        {
+            uint32_t bits = static_cast< uint32_t >( static_cast< int32_t >( n ) + 127 ) << 23;
+            float a;
+            memcpy( &a, &bits, sizeof( bits ) );
+            return a;
+        }
+    };
+
+#if defined(AERO_SIMD_X86)
+    /**
+     * @brief Four lane backend, SSE2 is part of every x86-64 processor
+     */
+    struct Sse2
+    {
+        typedef __m128 F;
+        static const size_t width = 4;
+
+        static inline F set( float a ) { return _mm_set1_ps( a ); }
+        static inline F load( const float* p ) { return _mm_loadu_ps( p ); }
+        static inline void store( float* p, F a ) { _mm_storeu_ps( p, a ); }
+        static inline F add( F a, F b ) { return _mm_add_ps( a, b ); }
+        static inline F sub( F a, F b ) { return _mm_sub_ps( a, b ); }
+        static inline F mul( F a, F b ) { return _mm_mul_ps( a, b ); }
+        static inline F div( F a, F b ) { return _mm_div_ps( a, b ); }
+        static inline F sqrt( F a ) { return _mm_sqrt_ps( a ); }
+        static inline F min( F a, F b ) { return _mm_min_ps( a, b ); }
+        static inline F max( F a, F b ) { return _mm_max_ps( a, b ); }
+
+        static inline F select_gt( F a, F b, F x, F y )
+        {
+            F mask = _mm_cmpgt_ps( a, b );
+            return _mm_or_ps( _mm_and_ps( mask, x ), _mm_andnot_ps( mask, y ) );
+        }
+
+        static inline F round( F a ) { return _mm_cvtepi32_ps( _mm_cvtps_epi32( a ) ); }
+
+        static inline F frexp( F a, F& e )
+        {
+            __m128i bits = _mm_castps_si128( a );
+            e = _mm_cvtepi32_ps( _mm_sub_epi32( _mm_srli_epi32( bits, 23 ), _mm_set1_epi32( 127 ) ) );
+            bits = _mm_or_si128( _mm_and_si128( bits, _mm_set1_epi32( 0x007FFFFF ) ), _mm_set1_epi32( 0x3F800000 ) );
+            return _mm_castsi128_ps( bits );
+        }
+
+        static inline F exp2i( F n )
+        {
+            __m128i bits = _mm_add_epi32( _mm_cvtps_epi32( n ), _mm_set1_epi32( 127 ) );
+            return _mm_castsi128_ps( _mm_slli_epi32( bits, 23 ) );
+        }
+    };
+
+    #define AERO_AVX2 __attribute__(( target( "avx2" ) ))
+
+    /**
+     * @brief Eight lane backend, only called after has_avx2()
+     */
+    struct Avx2
+    {
+        typedef __m256 F;
+        static const size_t width = 8;
+
+        static AERO_AVX2 inline F set( float a ) { return _mm256_set1_ps( a ); }
+        static AERO_AVX2 inline F load( const float* p ) { return _mm256_loadu_ps( p ); }
+        static AERO_AVX2 inline void store( float* p, F a ) { _mm256_storeu_ps( p, a ); }
+        static AERO_AVX2 inline F add( F a, F b ) { return _mm256_add_ps( a, b ); }
+        static AERO_AVX2 inline F sub( F a, F b ) { return _mm256_sub_ps( a, b ); }
+        static AERO_AVX2 inline F mul( F a, F b ) { return _mm256_mul_ps( a, b ); }
+        static AERO_AVX2 inline F div( F a, F b ) { return _mm256_div_ps( a, b ); }
+        static AERO_AVX2 inline F sqrt( F a ) { return _mm256_sqrt_ps( a ); }
+        static AERO_AVX2 inline F min( F a, F b ) { return _mm256_min_ps( a, b ); }
+        static AERO_AVX2 inline F max( F a, F b ) { return _mm256_max_ps( a, b ); }
+
+        static AERO_AVX2 inline F select_gt( F a, F b, F x, F y )
+        {
+            return _mm256_blendv_ps( y, x, _mm256_cmp_ps( a, b, _CMP_GT_OQ ) );
+        }
+
+        static AERO_AVX2 inline F round( F a )
+        {
+            return _mm256_round_ps( a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC );
+        }
+
+        static AERO_AVX2 inline F frexp( F a, F& e )
+        {
+            __m256i bits = _mm256_castps_si256( a );
+            e = _mm256_cvtepi32_ps( _mm256_sub_epi32( _mm256_srli_epi32( bits, 23 ), _mm256_set1_epi32( 127 ) ) );
+            bits = _mm256_or_si256( _mm256_and_si256( bits, _mm256_set1_epi32( 0x007FFFFF ) ), _mm256_set1_epi32( 0x3F800000 ) );
+            return _mm256_castsi256_ps( bits );
+        }
+
+        static AERO_AVX2 inline F exp2i( F n )
+        {
+            __m256i bits = _mm256_add_epi32( _mm256_cvtps_epi32( n ), _mm256_set1_epi32( 127 ) );
+            return _mm256_castsi256_ps( _mm256_slli_epi32( bits, 23 ) );
+        }
+    };
+
+    /**
+     * @brief Check if the processor has AVX2
+     */
+    inline bool has_avx2( void )
+    {
+        static const bool supported = __builtin_cpu_supports( "avx2" );
+        return supported;
+    }
+#elif defined(AERO_SIMD_NEON)
+    /**
+     * @brief Four lane backend for ARMv8
+     */
+    struct Neon
+    {
+        typedef float32x4_t F;
+        static const size_t width = 4;
+
+        static inline F set( float a ) { return vdupq_n_f32( a ); }
+        static inline F load( const float* p ) { return vld1q_f32( p ); }
+        static inline void store( float* p, F a ) { vst1q_f32( p, a ); }
+        static inline F add( F a, F b ) { return vaddq_f32( a, b ); }
+        static inline F sub( F a, F b ) { return vsubq_f32( a, b ); }
+        static inline F mul( F a, F b ) { return vmulq_f32( a, b ); }
+        static inline F div( F a, F b ) { return vdivq_f32( a, b ); }
+        static inline F sqrt( F a ) { return vsqrtq_f32( a ); }
+
+        static inline F select_gt( F a, F b, F x, F y ) { return vbslq_f32( vcgtq_f32( a, b ), x, y ); }
+        static inline F min( F a, F b ) { return select_gt( b, a, a, b ); }
+        static inline F max( F a, F b ) { return select_gt( a, b, a, b ); }
+        static inline F round( F a ) { return vrndnq_f32( a ); }
+
+        static inline F frexp( F a, F& e )
+        {
+            uint32x4_t bits = vreinterpretq_u32_f32( a );
+            e = vcvtq_f32_s32( vsubq_s32( vreinterpretq_s32_u32( vshrq_n_u32( bits, 23 ) ), vdupq_n_s32( 127 ) ) );
+            bits = vorrq_u32( vandq_u32( bits, vdupq_n_u32( 0x007FFFFF ) ), vdupq_n_u32( 0x3F800000 ) );
+            return vreinterpretq_f32_u32( bits );
+        }
+
+        static inline F exp2i( F n )
+        {
+            int32x4_t bits = vaddq_s32( vcvtnq_s32_f32( n ), vdupq_n_s32( 127 ) );
+            return vreinterpretq_f32_s32( vshlq_n_s32( bits, 23 ) );
+        }
+    };
+#endif
+
+    /**
+     * @brief log( 1 + x ), accurate for x near zero
+     *
+     * @details Cephes logf polynomial on the mantissa reduced to
+     *          [ sqrt( 1/2 ), sqrt( 2 ) ), with the rounding of 1 + x
+     *          folded back in. Returns NaN for x <= -1
+     */
+    template< typename V >
+    AERO_SIMD_INLINE void log1p( typename V::F& out, const typename V::F& x )
+    {
+        typedef typename V::F F;
+
+        F u = V::add( V::set( 1.0f ), x );
+        F e;
+        F m = V::frexp( u, e );
+
+        // Keep the mantissa centred on 1
+        F big = V::sub( m, V::set( 1.41421356f ) );
+        m = V::select_gt( big, V::set( 0.0f ), V::mul( m, V::set( 0.5f ) ), m );
+        e = V::select_gt( big, V::set( 0.0f ), V::add( e, V::set( 1.0f ) ), e );
+
+        F f = V::sub( m, V::set( 1.0f ) );
+        F c = V::div( V::sub( x, V::sub( u, V::set( 1.0f ) ) ), u );
+        F z = V::mul( f, f );
+
+        F p = V::set( 7.0376836292e-2f );
+        p = V::add( V::mul( p, f ), V::set( -1.1514610310e-1f ) );
+        p = V::add( V::mul( p, f ), V::set( 1.1676998740e-1f ) );
+        p = V::add( V::mul( p, f ), V::set( -1.2420140846e-1f ) );
+        p = V::add( V::mul( p, f ), V::set( 1.4249322787e-1f ) );
+        p = V::add( V::mul( p, f ), V::set( -1.6668057665e-1f ) );
+        p = V::add( V::mul( p, f ), V::set( 2.0000714765e-1f ) );
+        p = V::add( V::mul( p, f ), V::set( -2.4999993993e-1f ) );
+        p = V::add( V::mul( p, f ), V::set( 3.3333331174e-1f ) );
+
+        // ln 2 is split so e * ln2_hi is exact
+        F y = V::mul( V::mul( p, f ), z );
+        y = V::add( y, V::mul( e, V::set( -2.12194440e-4f ) ) );
+        y = V::sub( y, V::mul( z, V::set( 0.5f ) ) );
+        y = V::add( y, c );
+        F r = V::add( V::add( f, y ), V::mul( e, V::set( 0.693359375f ) ) );
+
+        out = V::select_gt( u, V::set( 0.0f ), r, V::set( NAN ) );
+    }
+
+    /**
+     * @brief exp( y ) - 1, accurate for y near zero
+     *
+     * @details y = n ln2 + r with | r | <= ln2 / 2, expm1( r ) from its
+     *          Taylor series to r^8, then scaled by 2^n. Inputs are clamped
+     *          to [ -88, 88 ]
+     */
+    template< typename V >
+    AERO_SIMD_INLINE void expm1( typename V::F& out, const typename V::F& x )
+    {
+        typedef typename V::F F;
+
+        F y = V::min( V::set( 88.0f ), V::max( V::set( -88.0f ), x ) );
+
+        F n = V::round( V::mul( y, V::set( 1.44269504f ) ) );
+        F r = V::sub( y, V::mul( n, V::set( 0.693359375f ) ) );
+        r = V::sub( r, V::mul( n, V::set( -2.12194440e-4f ) ) );
+
+        F p = V::set( 1.0f / 40320.0f );
+        p = V::add( V::mul( p, r ), V::set( 1.0f / 5040.0f ) );
+        p = V::add( V::mul( p, r ), V::set( 1.0f / 720.0f ) );
+        p = V::add( V::mul( p, r ), V::set( 1.0f / 120.0f ) );
+        p = V::add( V::mul( p, r ), V::set( 1.0f / 24.0f ) );
+        p = V::add( V::mul( p, r ), V::set( 1.0f / 6.0f ) );
+        p = V::add( V::mul( p, r ), V::set( 0.5f ) );
+        p = V::add( V::mul( V::mul( p, r ), r ), r );
+
+        // 2^n expm1( r ) + 2^n - 1, exact when n is 0
+        F s = V::exp2i( n );
+        out = V::add( V::mul( s, p ), V::sub( s, V::set( 1.0f ) ) );
+    }
+
+    // Exponents of the standard atmosphere
+    const float AIRSPEED_EXPONENT = 2.0f / 7.0f;
+    const float PRESSURE_EXPONENT = ( lapse * gas_const ) / ( air_mass * gravity );
+    const float DENSITY_EXPONENT = ( lapse * gas_const ) / ( air_mass * gravity - lapse * gas_const );
+
+    //! Kernels for each batch conversion, same arguments as the scalar versions
+    struct CalAs
+    {
+        template< typename V >
+        static AERO_SIMD_INLINE void apply( typename V::F& out, const typename V::F& dp )
+        {
+            typename V::F ln, ratio;
+            log1p< V >( ln, V::div( dp, V::set( sl_pressure ) ) );
+            expm1< V >( ratio, V::mul( V::set( AIRSPEED_EXPONENT ), ln ) );
+            out = V::mul( V::set( sl_sound_speed ), V::sqrt( V::mul( V::set( 5.0f ), ratio ) ) );
+        }
+    };
+
+    struct EquivAs
+    {
+        template< typename V >
+        static AERO_SIMD_INLINE void apply( typename V::F& out, const typename V::F& dp, const typename V::F& p )
+        {
+            typename V::F ln, ratio;
+            log1p< V >( ln, V::div( dp, p ) );
+            expm1< V >( ratio, V::mul( V::set( AIRSPEED_EXPONENT ), ln ) );
+            typename V::F scale = V::div( V::mul( V::set( 5.0f ), p ), V::set( sl_pressure ) );
+            out = V::mul( V::set( sl_sound_speed ), V::sqrt( V::mul( scale, ratio ) ) );
+        }
+    };
+
+    struct TrueAs
+    {
+        template< typename V >
+        static AERO_SIMD_INLINE void apply( typename V::F& out, const typename V::F& airspeed, const typename V::F& temperature )
+        {
+            typename V::F ratio = V::div( V::add( temperature, V::set( 273.15f ) ), V::set( sl_temperature ) );
+            out = V::mul( airspeed, V::sqrt( ratio ) );
+        }
+    };
+
+    struct PressureAltitude
+    {
+        template< typename V >
+        static AERO_SIMD_INLINE void apply( typename V::F& out, const typename V::F& p )
+        {
+            // log( p / p0 ) taken from p - p0, which is exact near sea level
+            typename V::F ln, ratio;
+            log1p< V >( ln, V::div( V::sub( p, V::set( sl_pressure ) ), V::set( sl_pressure ) ) );
+            expm1< V >( ratio, V::mul( V::set( PRESSURE_EXPONENT ), ln ) );
+            out = V::mul( V::set( -sl_temperature / lapse ), ratio );
+        }
+    };
+
+    struct DensityAltitude
+    {
+        template< typename V >
+        static AERO_SIMD_INLINE void apply( typename V::F& out, const typename V::F& p, const typename V::F& temperature )
+        {
+            // p / p0 = 1 + a and ( T + 273.15 ) / T0 = 1 + b, T + 273.15 - T0 being T - 15
+            typedef typename V::F F;
+            F a = V::div( V::sub( p, V::set( sl_pressure ) ), V::set( sl_pressure ) );
+            F b = V::div( V::sub( temperature, V::set( sl_temperature - 273.15f ) ), V::set( sl_temperature ) );
+            F ln, ratio;
+            log1p< V >( ln, V::div( V::sub( a, b ), V::add( V::set( 1.0f ), b ) ) );
+            expm1< V >( ratio, V::mul( V::set( DENSITY_EXPONENT ), ln ) );
+            out = V::mul( V::set( -sl_temperature / lapse ), ratio );
+        }
+    };
+
+    struct ApproxDensity
+    {
+        template< typename V >
+        static AERO_SIMD_INLINE void apply( typename V::F& out, const typename V::F& p, const typename V::F& temperature )
+        {
+            out = V::div( V::mul( V::set( air_mass ), p ), V::mul( V::set( gas_const ), V::add( temperature, V::set( 273.15f ) ) ) );
+        }
+    };
+
+    /**
+     * @brief Apply a one input kernel to a batch, the tail one lane at a time
+     */
+    template< typename V, typename K >
+    AERO_SIMD_INLINE void map( const float* a, float* out, size_t n )
+    {
+        const size_t whole = n - n % V::width;
+        size_t i = 0;
+        typename V::F y;
+        for( ; i < whole; i += V::width )
+        {
+            K::template apply< V >( y, V::load( a + i ) );
+            V::store( out + i, y );
+        }
+
+        for( ; i < n; ++i )
+            K::template apply< Scalar >( out[ i ], a[ i ] );
+    }
+
+    /**
+     * @brief Apply a two input kernel to a batch, the tail one lane at a time
+     */
+    template< typename V, typename K >
+    AERO_SIMD_INLINE void map( const float* a, const float* b, float* out, size_t n )
+    {
+        const size_t whole = n - n % V::width;
+        size_t i = 0;
+        typename V::F y;
+        for( ; i < whole; i += V::width )
+        {
+            K::template apply< V >( y, V::load( a + i ), V::load( b + i ) );
+            V::store( out + i, y );
+        }
+
+        for( ; i < n; ++i )
+            K::template apply< Scalar >( out[ i ], a[ i ], b[ i ] );
+    }
+
+    // Entry points with every operation inlined into them
+    template< typename V, typename K >
+    __attribute__(( flatten, noinline )) void run( const float* a, float* out, size_t n )
+    {
+        map< V, K >( a, out, n );
+    }
+
+    template< typename V, typename K >
+    __attribute__(( flatten, noinline )) void run( const float* a, const float* b, float* out, size_t n )
+    {
+        map< V, K >( a, b, out, n );
+    }
+
+#if defined(AERO_SIMD_X86)
+    // Same for AVX2, compiled for it whatever the rest of the program targets
+    template< typename K >
+    __attribute__(( target( "avx2" ), flatten, noinline )) void map_avx2( const float* a, float* out, size_t n )
+    {
+        map< Avx2, K >( a, out, n );
+    }
+
+    template< typename K >
+    __attribute__(( target( "avx2" ), flatten, noinline )) void map_avx2( const float* a, const float* b, float* out, size_t n )
+    {
+        map< Avx2, K >( a, b, out, n );
+    }
+#endif
+
+    /**
+     * @brief Apply a kernel with the widest backend this processor has
+     */
+    template< typename K >
+    inline void dispatch( const float* a, float* out, size_t n )
+    {
+#if defined(AERO_SIMD_X86)
+        if( has_avx2() )
+            map_avx2< K >( a, out, n );
+        else
+            run< Sse2, K >( a, out, n );
+#elif defined(AERO_SIMD_NEON)
+        run< Neon, K >( a, out, n );
+#else
+        run< Scalar, K >( a, out, n );
+#endif
+    }
+
+    template< typename K >
+    inline void dispatch( const float* a, const float* b, float* out, size_t n )
+    {
+#if defined(AERO_SIMD_X86)
+        if( has_avx2() )
+            map_avx2< K >( a, b, out, n );
+        else
+            run< Sse2, K >( a, b, out, n );
+#elif defined(AERO_SIMD_NEON)
+        run< Neon, K >( a, b, out, n );
+#else
+        run< Scalar, K >( a, b, out, n );
+#endif
+    }
+
+    #undef AERO_SIMD_INLINE
+} // End of namespace simd
+
+/*
+    Batch versions of the scalar conversions. Every backend gives the same
+    bits. Over the flight envelope airspeeds and density are within 4 ULP of
+    the exact values, pressure altitude within 8 ULP and density altitude
+    within 5 mm, checked in tests/test_ConvertBatch.cpp. powf is replaced with log1p and expm1 of
+    the pressure ratios, which keeps precision at low airspeed where the
+    scalar versions lose it to cancellation. out may be the same array as an
+    input
+*/
+
+/**
+ * @brief Calculates calibrated airspeed in m/s for a batch of samples
+ *
+ * @param diff_pressure Differential pressures in Pa
+ * @param out Resulting calibrated airspeeds
+ * @param n Number of samples
+ */
+inline void cal_as( const float* diff_pressure, float* out, size_t n )
+{
+    simd::dispatch< simd::CalAs >( diff_pressure, out, n );
+}
+
+/**
+ * @brief Calculates equivalent airspeed in m/s for a batch of samples
+ *
+ * @param diff_pressure Differential pressures in Pa
+ * @param pressure Static pressures in Pa
+ * @param out Resulting equivalent airspeeds
+ * @param n Number of samples
+ */
+inline void equiv_as( const float* diff_pressure, const float* pressure, float* out, size_t n )
+{
+    simd::dispatch< simd::EquivAs >( diff_pressure, pressure, out, n );
+}
+
+/**
+ * @brief Calculates true airspeed in m/s for a batch of samples
+ *
+ * @param airspeed Indicated or equivalent airspeeds in m/s
+ * @param temperature Air temperatures in Celsius
+ * @param out Resulting true airspeeds
+ * @param n Number of samples
+ */
+inline void true_as( const float* airspeed, const float* temperature, float* out, size_t n )
+{
+    simd::dispatch< simd::TrueAs >( airspeed, temperature, out, n );
+}
+
+/**
+ * @brief Calculates pressure altitude in m for a batch of samples
+ *
+ * @param pressure Static pressures in Pa
+ * @param out Resulting pressure altitudes
+ * @param n Number of samples
+ */
+inline void pressure_altitude( const float* pressure, float* out, size_t n )
+{
+    simd::dispatch< simd::PressureAltitude >( pressure, out, n );
+}
+
+/**
+ * @brief Calculates density altitude in m for a batch of samples
+ *
+ * @param pressure Static pressures in Pa
+ * @param temperature Temperatures in Celsius
+ * @param out Resulting density altitudes
+ * @param n Number of samples
+ */
+inline void density_altitude( const float* pressure, const float* temperature, float* out, size_t n )
+{
+    simd::dispatch< simd::DensityAltitude >( pressure, temperature, out, n );
+}
+
+/**
+ * @brief Calculates air density in kg/m^3 for a batch of samples
+ *
+ * @param pressure Static pressures in Pa
+ * @param temperature Temperatures in Celsius
+ * @param out Resulting air densities
+ * @param n Number of samples
+ */
+inline void approx_density( const float* pressure, const float* temperature, float* out, size_t n )
+{
+    simd::dispatch< simd::ApproxDensity >( pressure, temperature, out, n );
+}
+
+} // End of namespace convert
+
+/*! @} End of Doxygen Groups*/
+
+} // End of namespace aero
+
+/*! @} End of Doxygen Groups*/
+
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic pop
+#endif
@@ -0,0 +1,376 @@
+#pragma once
+
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    #include "Arduino.h"
+#else
+    #include <cstddef>
+    #include <cstdint>
+    #include <cstring>
+#endif
+
+// Tables AVR reads stay in flash
+#if defined(__AVR__)
+    #include <avr/pgmspace.h>
+    #define AERO_CRC_FLASH PROGMEM
+#else
+    #define AERO_CRC_FLASH
+#endif
+
+// Hardware CRC32C instructions
+#if !defined(ARDUINO) && defined(__x86_64__) && ( defined(__GNUC__) || defined(__clang__) )
+    #include <nmmintrin.h>
+    #define AERO_CRC32C_X86
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+    #include <arm_acle.h>
+    #define AERO_CRC32C_ARM
+#endif
+
+/*!
+ *  \addtogroup aero
+ *  @{
+ */
+
+//! Aero library code
+namespace aero
+{
+
+/*!
+ *  \addtogroup crc
+ *  @{
+ */
+
+//! Cyclic redundancy checks for frame integrity
+namespace crc
+{
+    // Namespace constants
+    namespace
+    {
+        const uint16_t crc16_poly = 0x1021;         // CRC-16/CCITT polynomial, MSB first
+        const uint16_t crc16_init = 0xFFFF;         // CRC-16/CCITT-FALSE start value
+        const uint32_t crc32c_poly = 0x82F63B78;    // CRC-32C Castagnoli polynomial, reflected
+    }
+
+    //! Compile time table generation, C++11 constexpr so it builds with the AVR core
+    namespace detail
+    {
+        template< size_t... I > struct Indices {};
+        template< size_t N, size_t... I > struct MakeIndices : MakeIndices< N - 1, N - 1, I... > {};
+        template< size_t... I > struct MakeIndices< 0, I... > { typedef Indices< I... > type; };
+
+        /**
+         * @brief CRC-16 register after shifting bits through the polynomial
+         */
+        constexpr uint16_t crc16_shift( uint16_t c, int bits )
+        {
+            return bits == 0 ? c : crc16_shift( static_cast< uint16_t >( ( c & 0x8000 ) ? ( c << 1 ) ^ crc16_poly : c << 1 ), bits - 1 );
+        }
+
+        /**
+         * @brief CRC-32C register after shifting bits through the reflected polynomial
+         */
+        constexpr uint32_t crc32c_shift( uint32_t c, int bits )
+        {
+            return bits == 0 ? c : crc32c_shift( ( c & 1 ) ? ( c >> 1 ) ^ crc32c_poly : c >> 1, bits - 1 );
+        }
+
+        /**
+         * @brief One more zero byte through a CRC-32C table entry
+         */
+        constexpr uint32_t crc32c_next( uint32_t c )
+        {
+            return ( c >> 8 ) ^ crc32c_shift( c & 0xFF, 8 );
+        }
+
+        /**
+         * @brief Effect of byte i followed by k zero bytes
+         */
+        constexpr uint32_t crc32c_slice( uint32_t i, int k )
+        {
+            return k == 0 ? crc32c_shift( i, 8 ) : crc32c_next( crc32c_slice( i, k - 1 ) );
+        }
+    }
+
+    /**
+     * @brief Lookup tables, each its own object so a target only keeps the ones it reads
+     *
+     * @details CRC-16 uses one 256 entry table, except on AVR where the 16
+     *          entry nibble table is used instead. CRC-32C uses eight tables
+     *          so eight bytes are folded per step, AVR only the first. The
+     *          tables AVR reads are in flash, read them with detail::read()
+     */
+    struct Crc16Table       { uint16_t entry[ 256 ]; };
+    struct Crc16NibbleTable { uint16_t entry[ 16 ]; };
+    struct Crc32cTable      { uint32_t entry[ 256 ]; };
+    struct Crc32cSlices     { Crc32cTable slice[ 8 ]; };
+
+    namespace detail
+    {
+        typedef MakeIndices< 256 >::type Bytes;
+
+        template< size_t... I >
+        constexpr Crc16Table crc16_table( Indices< I... > )
+        {
+            return Crc16Table{ { crc16_shift( static_cast< uint16_t >( I << 8 ), 8 )... } };
+        }
+
+        // A nibble only goes through four shifts, not the eight of a byte
+        template< size_t... I >
+        constexpr Crc16NibbleTable crc16_nibble_table( Indices< I... > )
+        {
+            return Crc16NibbleTable{ { crc16_shift( static_cast< uint16_t >( I << 12 ), 4 )... } };
+        }
+
+        template< size_t... I >
+        constexpr Crc32cTable crc32c_table( int k, Indices< I... > )
+        {
+            return Crc32cTable{ { crc32c_slice( I, k )... } };
+        }
+
+        template< size_t... K >
+        constexpr Crc32cSlices crc32c_slices( Indices< K... > )
+        {
+            return Crc32cSlices{ { crc32c_table( K, Bytes() )... } };
+        }
+
+        /**
+         * @brief Read a table entry, from flash on AVR
+         */
+        inline uint16_t read( const uint16_t* entry )
+        {
+            #if defined(__AVR__)
+                return pgm_read_word( entry );
+            #else
+                return *entry;
+            #endif
+        }
+
+        inline uint32_t read( const uint32_t* entry )
+        {
+            #if defined(__AVR__)
+                return pgm_read_dword( entry );
+            #else
+                return *entry;
+            #endif
+        }
+    }
+
+    /**
+     * @brief Single instance of the host tables shared by every translation unit
+     */
+    template< typename T = void >
+    struct Lookup
+    {
+        static constexpr Crc16Table crc16 = detail::crc16_table( detail::Bytes() );
+        static constexpr Crc32cSlices crc32c_slices = detail::crc32c_slices( detail::MakeIndices< 8 >::type() );
+    };
+
+    template< typename T > constexpr Crc16Table Lookup< T >::crc16;
+    template< typename T > constexpr Crc32cSlices Lookup< T >::crc32c_slices;
+
+    // Tables AVR reads. Flash only takes plain namespace scope objects, the
+    // attribute is dropped on template members
+    namespace
+    {
+        constexpr Crc16NibbleTable crc16_nibbles AERO_CRC_FLASH = detail::crc16_nibble_table( detail::MakeIndices< 16 >::type() );
+        constexpr Crc32cTable crc32c_bytes AERO_CRC_FLASH = detail::crc32c_table( 0, detail::Bytes() );
+    }
+
+    /**
+     * @brief CRC-16/CCITT-FALSE four bits at a time with the 16 entry table
+     *
+     * @param buf Bytes to check
+     * @param len Number of bytes
+     * @param crc Result of a previous call to continue a check, leave default to start
+     * @return uint16_t CRC of the bytes
+     */
+    inline uint16_t crc16_nibblewise( const uint8_t* buf, size_t len, uint16_t crc = crc16_init )
+    {
+        const uint16_t* table = crc16_nibbles.entry;
+
+        for( size_t i = 0; i < len; ++i )
+        {
+            crc = static_cast< uint16_t >( ( crc << 4 ) ^ detail::read( table + ( ( ( crc >> 12 ) ^ ( buf[ i ] >> 4 ) ) & 0x0F ) ) );
+            crc = static_cast< uint16_t >( ( crc << 4 ) ^ detail::read( table + ( ( ( crc >> 12 ) ^ buf[ i ] ) & 0x0F ) ) );
+        }
+
+        return crc;
+    }
+
+    /**
+     * @brief CRC-16/CCITT-FALSE. Cheap enough for small MCUs
+     *
+     * @param buf Bytes to check
+     * @param len Number of bytes
+     * @param crc Result of a previous call to continue a check, leave default to start
+     * @return uint16_t CRC of the bytes
+     */
+    inline uint16_t crc16( const uint8_t* buf, size_t len, uint16_t crc = crc16_init )
+    {
+        #if defined(__AVR__)
+            return crc16_nibblewise( buf, len, crc );
+        #else
+            for( size_t i = 0; i < len; ++i )
+                crc = static_cast< uint16_t >( ( crc << 8 ) ^ Lookup<>::crc16.entry[ ( ( crc >> 8 ) ^ buf[ i ] ) & 0xFF ] );
+
+            return crc;
+        #endif
+    }
+
+    /**
+     * @brief CRC-32C one byte at a time
+     *
+     * @param buf Bytes to check
+     * @param len Number of bytes
+     * @param crc Result of a previous call to continue a check, leave default to start
+     * @return uint32_t CRC of the bytes
+     */
+    inline uint32_t crc32c_bytewise( const uint8_t* buf, size_t len, uint32_t crc = 0 )
+    {
+        const uint32_t* table = crc32c_bytes.entry;
+        crc = ~crc;
+
+        for( size_t i = 0; i < len; ++i )
+            crc = ( crc >> 8 ) ^ detail::read( table + ( ( crc ^ buf[ i ] ) & 0xFF ) );
+
+        return ~crc;
+    }
+
+    /**
+     * @brief CRC-32C eight bytes at a time with the slice-by-8 tables
+     *
+     * @param buf Bytes to check
+     * @param len Number of bytes
+     * @param crc Result of a previous call to continue a check, leave default to start
+     * @return uint32_t CRC of the bytes
+     */
+    inline uint32_t crc32c_slice8( const uint8_t* buf, size_t len, uint32_t crc = 0 )
+    {
+        const Crc32cTable* table = Lookup<>::crc32c_slices.slice;
+        crc = ~crc;
+
+        for( ; len >= 8; len -= 8, buf += 8 )
+        {
+            // Bytes are assembled little endian so this is endian independent
+            uint32_t lo = crc ^ ( buf[ 0 ] | ( buf[ 1 ] << 8 ) | ( buf[ 2 ] << 16 ) | ( (uint32_t) buf[ 3 ] << 24 ) );
+
+            crc = table[ 7 ].entry[ lo & 0xFF ] ^ table[ 6 ].entry[ ( lo >> 8 ) & 0xFF ]
+                ^ table[ 5 ].entry[ ( lo >> 16 ) & 0xFF ] ^ table[ 4 ].entry[ lo >> 24 ]
+                ^ table[ 3 ].entry[ buf[ 4 ] ] ^ table[ 2 ].entry[ buf[ 5 ] ]
+                ^ table[ 1 ].entry[ buf[ 6 ] ] ^ table[ 0 ].entry[ buf[ 7 ] ];
+        }
+
+        for( ; len > 0; --len, ++buf )
+            crc = ( crc >> 8 ) ^ table[ 0 ].entry[ ( crc ^ *buf ) & 0xFF ];
+
+        return ~crc;
+    }
+
+#if defined(AERO_CRC32C_X86)
+    /**
+     * @brief CRC-32C with the SSE4.2 crc32 instruction
+     *
+     * @details Only call this when the CPU supports SSE4.2, crc32c() checks
+     *
+     * @param buf Bytes to check
+     * @param len Number of bytes
+     * @param crc Result of a previous call to continue a check, leave default to start
+     * @return uint32_t CRC of the bytes
+     */
+    __attribute__(( target( "sse4.2" ) ))
+    inline uint32_t crc32c_hardware( const uint8_t* buf, size_t len, uint32_t crc = 0 )
+    {
+        uint64_t c = ~crc;
+
+        for( ; len >= 8; len -= 8, buf += 8 )
+        {
+            uint64_t word;
+            memcpy( &word, buf, sizeof( word ) );
+            c = _mm_crc32_u64( c, word );
+        }
+
+        uint32_t c32 = static_cast< uint32_t >( c );
+
+        for( ; len > 0; --len, ++buf )
+            c32 = _mm_crc32_u8( c32, *buf );
+
+        return ~c32;
+    }
+
+    /**
+     * @brief Check once if the CPU has the crc32 instruction
+     */
+    inline bool has_hardware( void )
+    {
+        static const bool supported = __builtin_cpu_supports( "sse4.2" );
+        return supported;
+    }
+#elif defined(AERO_CRC32C_ARM)
+    /**
+     * @brief CRC-32C with the ARMv8 crc32c instructions
+     *
+     * @param buf Bytes to check
+     * @param len Number of bytes
+     * @param crc Result of a previous call to continue a check, leave default to start
+     * @return uint32_t CRC of the bytes
+     */
+    inline uint32_t crc32c_hardware( const uint8_t* buf, size_t len, uint32_t crc = 0 )
+    {
+        crc = ~crc;
+
+        for( ; len >= 8; len -= 8, buf += 8 )
+        {
+            uint64_t word;
+            memcpy( &word, buf, sizeof( word ) );
+            crc = __crc32cd( crc, word );
+        }
+
+        for( ; len > 0; --len, ++buf )
+            crc = __crc32cb( crc, *buf );
+
+        return ~crc;
+    }
+
+    /**
+     * @brief The instructions are part of the build target
+     */
+    inline bool has_hardware( void ) { return true; }
+#else
+    /**
+     * @brief No crc32c instruction on this target
+     */
+    inline bool has_hardware( void ) { return false; }
+#endif
+
+    /**
+     * @brief CRC-32C using the fastest method available on this target
+     *
+     * @param buf Bytes to check
+     * @param len Number of bytes
+     * @param crc Result of a previous call to continue a check, leave default to start
+     * @return uint32_t CRC of the bytes
+     */
+    inline uint32_t crc32c( const uint8_t* buf, size_t len, uint32_t crc = 0 )
+    {
+        #if defined(AERO_CRC32C_X86) || defined(AERO_CRC32C_ARM)
+            if( has_hardware() )
+                return crc32c_hardware( buf, len, crc );
+        #endif
+
+        // Slicing only pays off once there are a few words to fold, and
+        // its 8 KB of tables don't fit an AVR
+        #if defined(__AVR__)
+            return crc32c_bytewise( buf, len, crc );
+        #else
+            if( len < 16 )
+                return crc32c_bytewise( buf, len, crc );
+
+            return crc32c_slice8( buf, len, crc );
+        #endif
+    }
+} // End of namespace crc
+
+/*! @} End of Doxygen Groups*/
+
+} // End of namespace aero
+
+/*! @} End of Doxygen Groups*/
@@ -33,16 +33,16 @@ struct Pitot_t
  */
 struct IMU_t
 {
-    float ax;
+    float ax;       // Acceleration     [ g ]
     float ay;
     float az;
-    float gx;
+    float gx;       // Angular rate     [ deg/s ]
     float gy;
     float gz;
-    float mx;
+    float mx;       // Magnetic field   [ uT ]
     float my;
     float mz;
-    float yaw;
+    float yaw;      // Attitude         [ deg ]
     float pitch;
     float roll;
 };
@@ -135,6 +135,9 @@ struct Servos_t
 
 /**
  * @brief Processed flight data from raw sensor sources
+ *
+ * @details fixed::compute fills ias, tas, pressure_alt and density with
+ *          Q16.16 bits in m/s, m and kg/m^3
  */
 struct AirData_t
 {
@@ -168,6 +171,44 @@ struct DropAlgo_t
     uint16_t distance;
 };
 
+/**
+ * @brief IMU data quantized for the wire. Ranges and resolutions are in
+ *        quant::imu, values outside a range saturate
+ */
+struct IMUCompact_t
+{
+    int16_t ax;     // 1 mg
+    int16_t ay;
+    int16_t az;
+    int16_t gx;     // 0.1 deg/s
+    int16_t gy;
+    int16_t gz;
+    int16_t mx;     // 0.1 uT
+    int16_t my;
+    int16_t mz;
+    int16_t yaw;    // 0.01 deg
+    int16_t pitch;
+    int16_t roll;
+};
+
+/**
+ * @brief GPS data quantized for the wire. Ranges and resolutions are in
+ *        quant::gps, values outside a range saturate
+ */
+struct __attribute__(( packed )) GPSCompact_t
+{
+    uint8_t fix;
+    int32_t lat;            // 1e-7 deg
+    int32_t lon;            // 1e-7 deg
+    uint16_t speed;         // 0.01 m/s
+    uint8_t satellites;
+    uint16_t altitude;      // 0.1 m above -500 m
+    uint32_t time;
+    uint32_t date;
+    uint16_t HDOP;
+    uint8_t quality;
+};
+
 } // End of namespace def
 
 /*! @} End of Doxygen Groups*/
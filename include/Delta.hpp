@@ -0,0 +1,316 @@
+#pragma once
+
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    #include "Arduino.h"
+#else
+    #include <cstddef>
+    #include <cstdint>
+    #include <cstring>
+#endif
+
+#include "Message.hpp"
+
+/*!
+ *  \addtogroup aero
+ *  @{
+ */
+
+//! Aero library code
+namespace aero
+{
+
+/*
+    Delta frames have def::DELTA_FLAG set and this payload
+
+    | index | changed word bitmap | varint XOR of each changed word |
+    |   1   | ( words + 7 ) / 8   | 1 to 5 bytes each               |
+
+    The plain payload is treated as 32 bit little endian words, the last
+    one zero padded. index counts frames since the last keyframe, so a
+    receiver knows when it missed one. Keyframes are ordinary frames
+*/
+
+//! Helpers shared by the delta encoder and decoder
+namespace delta
+{
+    // Read a little endian word from a payload, zero padded past len
+    inline uint32_t load( const uint8_t* payload, size_t word, size_t len )
+    {
+        uint32_t value = 0;
+        size_t start = word * 4;
+
+        for( size_t i = 0; i < 4 && start + i < len; ++i )
+            value |= (uint32_t) payload[ start + i ] << ( 8 * i );
+
+        return value;
+    }
+
+    // Write a little endian word into a payload, dropping bytes past len
+    inline void store( uint8_t* payload, size_t word, size_t len, uint32_t value )
+    {
+        size_t start = word * 4;
+
+        for( size_t i = 0; i < 4 && start + i < len; ++i )
+            payload[ start + i ] = static_cast< uint8_t >( value >> ( 8 * i ) );
+    }
+
+    // Number of 32 bit words in a payload
+    inline size_t words( size_t len ) { return ( len + 3 ) / 4; }
+} // End of namespace delta
+
+/**
+ * @brief Stateful encoder that sends keyframes and changed words in between
+ *
+ * @details Every keyframe_interval frames, or when the signature changes,
+ *          the frame is sent unchanged as a keyframe. Other frames only
+ *          carry the words that changed since the previous frame. If the
+ *          delta would not be smaller the plain frame is sent instead,
+ *          which also counts as a keyframe. Use one encoder per schema
+ */
+class DeltaEncoder
+{
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param keyframe_interval Most frames between keyframes. A receiver
+     *        that loses a frame recovers within this many frames
+     */
+    explicit DeltaEncoder( uint8_t keyframe_interval = 10 )
+        : m_interval( keyframe_interval ), m_index( 0 ), m_signature( 0 ), m_length( 0 ),
+          m_have( false ), m_plain_bytes( 0 ), m_sent_bytes( 0 ) {}
+
+    /**
+     * @brief Encode a frame
+     *
+     * @param frame Plain frame to send
+     * @param out Buffer of at least def::MAX_FRAME_SIZE bytes for the frame to send
+     * @return size_t Size of the frame written to out, 0 if the input is invalid
+     */
+    size_t encode( const MessageView& frame, uint8_t* out )
+    {
+        if( !frame.valid() || frame.delta() )
+            return 0;
+
+        uint16_t signature = frame.signature() | frame.flags();
+        size_t size = 0;
+
+        if( m_have && signature == m_signature && m_index < m_interval )
+            size = encode_delta( frame, out );
+
+        if( size == 0 )
+        {
+            size = frame.size();
+            memcpy( out, frame.data(), size );
+            m_index = 0;
+        }
+
+        m_have = true;
+        m_signature = signature;
+        m_length = frame.length();
+        memcpy( m_prev, frame.payload(), m_length );
+
+        m_plain_bytes += frame.size();
+        m_sent_bytes += size;
+
+        return size;
+    }
+
+    /**
+     * @brief Make the next frame a keyframe
+     */
+    void keyframe( void ) { m_have = false; }
+
+    /**
+     * @brief Total size of the frames given to encode
+     */
+    uint32_t plain_bytes( void ) const { return m_plain_bytes; }
+
+    /**
+     * @brief Total size of the frames encode produced
+     */
+    uint32_t sent_bytes( void ) const { return m_sent_bytes; }
+
+private:
+    /**
+     * @brief Write a delta frame
+     *
+     * @return size_t Frame size or 0 if a keyframe should be sent instead
+     */
+    size_t encode_delta( const MessageView& frame, uint8_t* out )
+    {
+        const size_t len = frame.length();
+        const size_t words = delta::words( len );
+        const size_t bitmap = ( words + 7 ) / 8;
+
+        uint8_t* payload = out + def::HEADER_SIZE;
+        size_t pos = 1 + bitmap;
+
+        payload[ 0 ] = m_index + 1;
+        memset( payload + 1, 0, bitmap );
+
+        for( size_t w = 0; w < words; ++w )
+        {
+            uint32_t change = delta::load( frame.payload(), w, len ) ^ delta::load( m_prev, w, len );
+
+            if( change == 0 )
+                continue;
+
+            if( pos + 5 > def::MAX_PAYLOAD_SIZE )
+                return 0;
+
+            payload[ 1 + w / 8 ] |= static_cast< uint8_t >( 1 << ( w % 8 ) );
+
+            for( ; change >= 0x80; change >>= 7 )
+                payload[ pos++ ] = static_cast< uint8_t >( change | 0x80 );
+            payload[ pos++ ] = static_cast< uint8_t >( change );
+
+            // Give up once the delta is no smaller than the frame
+            if( pos >= len )
+                return 0;
+        }
+
+        uint16_t signature = m_signature | def::DELTA_FLAG;
+        uint16_t length = static_cast< uint16_t >( pos );
+
+        out[ 0 ] = def::START_BYTE;
+        out[ 1 ] = frame.data()[ 1 ];
+        def::store_u16( out + 2, signature );
+        def::store_u16( out + 4, length );
+        def::seal( out, signature, length );
+
+        ++m_index;
+        return def::frame_size( signature, length );
+    }
+
+    uint8_t m_prev[ def::MAX_PAYLOAD_SIZE ];    // Payload of the previous frame
+    uint8_t m_interval;                         // Most frames between keyframes
+    uint8_t m_index;                            // Frames since the last keyframe
+    uint16_t m_signature;                       // Signature and flags of the previous frame
+    uint16_t m_length;                          // Payload length of the previous frame
+    bool m_have;                                // False until a keyframe is sent
+    uint32_t m_plain_bytes;                     // Bytes in
+    uint32_t m_sent_bytes;                      // Bytes out
+};
+
+/**
+ * @brief Restores plain frames from a DeltaEncoder stream
+ *
+ * @details Plain frames pass straight through and become the new base.
+ *          After a lost or damaged frame, delta frames are rejected until
+ *          the next keyframe arrives
+ */
+class DeltaDecoder
+{
+public:
+    /**
+     * @brief Constructor
+     */
+    DeltaDecoder( ) : m_index( 0 ), m_signature( 0 ), m_length( 0 ), m_have( false ), m_lost( 0 ) {}
+
+    /**
+     * @brief Decode a received frame
+     *
+     * @param frame Frame as received, plain or delta encoded
+     * @return true if a restored plain frame is available from frame()
+     * @return false if the frame can't be decoded until the next keyframe
+     */
+    bool decode( const MessageView& frame )
+    {
+        if( !frame.valid() )
+            return false;
+
+        // Keyframe
+        if( !frame.delta() )
+        {
+            memcpy( m_buf, frame.data(), frame.size() );
+            m_index = 0;
+            m_signature = frame.signature() | frame.flags();
+            m_length = frame.length();
+            m_have = true;
+            return true;
+        }
+
+        // Delta for another stream
+        if( m_have && ( frame.signature() | ( frame.flags() & ~def::DELTA_FLAG ) ) != m_signature )
+            return false;
+
+        if( !m_have || frame.payload()[ 0 ] != static_cast< uint8_t >( m_index + 1 ) || !apply( frame ) )
+        {
+            m_have = false;
+            ++m_lost;
+            return false;
+        }
+
+        ++m_index;
+        m_buf[ 1 ] = frame.data()[ 1 ];
+        def::seal( m_buf, m_signature, m_length );
+        return true;
+    }
+
+    /**
+     * @brief The last restored plain frame
+     */
+    MessageView frame( void ) const
+    {
+        return m_have ? MessageView( m_buf, def::frame_size( m_signature, m_length ) ) : MessageView( NULL, 0 );
+    }
+
+    /**
+     * @brief Number of delta frames that could not be decoded
+     */
+    uint32_t lost( void ) const { return m_lost; }
+
+private:
+    /**
+     * @brief XOR the changed words of a delta frame into the previous payload
+     *
+     * @return false if the delta payload is malformed
+     */
+    bool apply( const MessageView& frame )
+    {
+        const uint8_t* payload = frame.payload();
+        const size_t end = frame.length();
+        const size_t words = delta::words( m_length );
+        const size_t bitmap = ( words + 7 ) / 8;
+        uint8_t* plain = m_buf + def::HEADER_SIZE;
+        size_t pos = 1 + bitmap;
+
+        if( pos > end )
+            return false;
+
+        for( size_t w = 0; w < words; ++w )
+        {
+            if( ( ( payload[ 1 + w / 8 ] >> ( w % 8 ) ) & 0x01 ) == 0 )
+                continue;
+
+            uint32_t change = 0;
+            for( int shift = 0; ; shift += 7 )
+            {
+                if( pos >= end || shift > 28 )
+                    return false;
+
+                uint8_t byte = payload[ pos++ ];
+                change |= (uint32_t) ( byte & 0x7F ) << shift;
+
+                if( ( byte & 0x80 ) == 0 )
+                    break;
+            }
+
+            delta::store( plain, w, m_length, delta::load( plain, w, m_length ) ^ change );
+        }
+
+        return pos == end;
+    }
+
+    uint8_t m_buf[ def::MAX_FRAME_SIZE ];   // Last restored plain frame
+    uint8_t m_index;                        // Frames since the last keyframe
+    uint16_t m_signature;                   // Signature and flags of the plain frame
+    uint16_t m_length;                      // Payload length of the plain frame
+    bool m_have;                            // False until a keyframe arrives
+    uint32_t m_lost;                        // Delta frames rejected
+};
+
+} // End of namespace aero
+
+/*! @} End of Doxygen Groups*/
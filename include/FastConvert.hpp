@@ -0,0 +1,366 @@
+#pragma once
+
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    #include "Arduino.h"
+#else
+    #include <cstddef>
+    #include <cstdint>
+    #include <cmath>
+#endif
+
+#include "Utility.hpp"
+
+/*!
+ *  \addtogroup aero
+ *  @{
+ */
+
+//! Aero library code
+namespace aero
+{
+
+/*!
+ *  \addtogroup convert
+ *  @{
+ */
+
+//! Conversion functions for various sensor values
+namespace convert
+{
+
+/*!
+ *  \addtogroup fast
+ *  @{
+ */
+
+/*
+    Opt in replacements for the air data conversions that call powf. Each
+    one is a piecewise cubic over the flight envelope, built at compile time
+    from the exact formula and its slope, so a call costs a few multiplies
+    instead of a powf. Switch a whole file over with
+
+        namespace conv = aero::convert::fast;
+
+    Inputs outside the envelope fall back to the exact functions. Largest
+    errors against the exact formulas in double over the envelope, checked
+    in tests/test_FastConvert.cpp
+
+        cal_as              0.0001 m/s  for dp from 0 to 25 kPa
+        equiv_as            0.0001 m/s  for dp up to a quarter of p
+        pressure_altitude   0.002 m     for p from 35 to 110 kPa
+        density_altitude    0.005 m     for p from 35 to 110 kPa, -50 to 60 C
+
+    That is as close as the exact float versions get, which lose up to
+    0.016 m/s to cancellation at low airspeed. The tables take 2.5 KB
+*/
+
+//! Fast bounded error air data conversions
+namespace fast
+{
+    // Namespace constants
+    namespace
+    {
+        constexpr double ln2 = 0.693147180559945309;
+        constexpr double table_sl_pressure = 101325.0;                              // sl_pressure for the generator
+        constexpr double altitude_scale = 288.15 / 0.0065;                          // sl_temperature / lapse
+        constexpr double airspeed_exponent = 2.0 / 7.0;
+        constexpr double pressure_exponent = ( 0.0065 * 8.314 ) / ( 0.02895 * 9.807 );
+        constexpr double density_exponent = ( 0.0065 * 8.314 ) / ( 0.02895 * 9.807 - 0.0065 * 8.314 );
+    }
+
+    //! Math for the table generator, run by the compiler
+    namespace detail
+    {
+        /**
+         * @brief Natural log, x must be positive
+         */
+        constexpr double ln( double x )
+        {
+            double shift = 0.0;
+
+            while( x > 1.5 )  { x /= 2.0; shift += 1.0; }
+            while( x < 0.75 ) { x *= 2.0; shift -= 1.0; }
+
+            // ln( x ) = 2 atanh( z ) with z at most 0.2
+            double z = ( x - 1.0 ) / ( x + 1.0 ), term = z, sum = 0.0;
+            for( int n = 1; n < 40; n += 2 )
+            {
+                sum += term / n;
+                term *= z * z;
+            }
+
+            return 2.0 * sum + shift * ln2;
+        }
+
+        /**
+         * @brief e to the power of x
+         */
+        constexpr double exp( double x )
+        {
+            int n = static_cast< int >( x / ln2 + ( x < 0.0 ? -0.5 : 0.5 ) );
+            double r = x - n * ln2, term = 1.0, sum = 1.0;
+
+            for( int k = 1; k < 24; ++k )
+            {
+                term *= r / k;
+                sum += term;
+            }
+
+            for( ; n > 0; --n ) sum *= 2.0;
+            for( ; n < 0; ++n ) sum /= 2.0;
+
+            return sum;
+        }
+
+        /**
+         * @brief x to the power of k, x must be positive
+         */
+        constexpr double power( double x, double k )
+        {
+            return exp( k * ln( x ) );
+        }
+
+        // ( ( 1 + q )^( 2 / 7 ) - 1 ) / q from its binomial series, which has
+        // no cancellation near q = 0. Airspeed is a0 sqrt( 5 q impact( q ) )
+        struct Impact
+        {
+            static constexpr double value( double q )
+            {
+                double coeff = airspeed_exponent, qn = 1.0, sum = 0.0;
+
+                for( int n = 1; n < 40; ++n )
+                {
+                    sum += coeff * qn;
+                    coeff *= ( airspeed_exponent - n ) / ( n + 1 );
+                    qn *= q;
+                }
+
+                return sum;
+            }
+
+            static constexpr double slope( double q )
+            {
+                double coeff = airspeed_exponent * ( airspeed_exponent - 1.0 ) / 2.0, qn = 1.0, sum = 0.0;
+
+                for( int n = 2; n < 40; ++n )
+                {
+                    sum += ( n - 1 ) * coeff * qn;
+                    coeff *= ( airspeed_exponent - n ) / ( n + 1 );
+                    qn *= q;
+                }
+
+                return sum;
+            }
+        };
+
+        // Pressure altitude in m against static pressure in Pa
+        struct PressureAltitude
+        {
+            static constexpr double value( double p )
+            {
+                return altitude_scale * ( 1.0 - power( p / table_sl_pressure, pressure_exponent ) );
+            }
+
+            static constexpr double slope( double p )
+            {
+                return -altitude_scale * pressure_exponent / table_sl_pressure
+                       * power( p / table_sl_pressure, pressure_exponent - 1.0 );
+            }
+        };
+
+        // Density altitude in m against the density ratio ( p / p0 ) ( T0 / T )
+        struct DensityAltitude
+        {
+            static constexpr double value( double x )
+            {
+                return altitude_scale * ( 1.0 - power( x, density_exponent ) );
+            }
+
+            static constexpr double slope( double x )
+            {
+                return -altitude_scale * density_exponent * power( x, density_exponent - 1.0 );
+            }
+        };
+    }
+
+    /**
+     * @brief Piecewise cubic through a function over [lo, hi]
+     *
+     * @details Each segment is the Hermite cubic matching the value and
+     *          slope at both ends, stored as polynomial coefficients in the
+     *          position within the segment
+     */
+    template< int SEGMENTS >
+    struct Curve
+    {
+        float lo;                   // Start of the range
+        float hi;                   // End of the range
+        float scale;                // Segments per unit of input
+        float c[ SEGMENTS ][ 4 ];   // Coefficients, constant term first
+
+        template< typename F >
+        constexpr Curve( F, double first, double last )
+            : lo( static_cast< float >( first ) ), hi( static_cast< float >( last ) ),
+              scale( static_cast< float >( SEGMENTS / ( last - first ) ) ), c()
+        {
+            double h = ( last - first ) / SEGMENTS;
+
+            for( int i = 0; i < SEGMENTS; ++i )
+            {
+                double x = first + i * h;
+                double f0 = F::value( x ), f1 = F::value( x + h );
+                double d0 = h * F::slope( x ), d1 = h * F::slope( x + h );
+
+                c[ i ][ 0 ] = static_cast< float >( f0 );
+                c[ i ][ 1 ] = static_cast< float >( d0 );
+                c[ i ][ 2 ] = static_cast< float >( 3.0 * ( f1 - f0 ) - 2.0 * d0 - d1 );
+                c[ i ][ 3 ] = static_cast< float >( 2.0 * ( f0 - f1 ) + d0 + d1 );
+            }
+        }
+
+        /**
+         * @brief Check if x is inside the range
+         */
+        bool contains( float x ) const { return x >= lo && x <= hi; }
+
+        /**
+         * @brief Evaluate the curve, x must be inside the range
+         */
+        float operator()( float x ) const
+        {
+            float u = ( x - lo ) * scale;
+            int i = static_cast< int >( u );
+
+            if( i > SEGMENTS - 1 )
+                i = SEGMENTS - 1;
+
+            float t = u - static_cast< float >( i );
+            const float* k = c[ i ];
+
+            return k[ 0 ] + t * ( k[ 1 ] + t * ( k[ 2 ] + t * k[ 3 ] ) );
+        }
+    };
+
+    /**
+     * @brief Curves generated at compile time
+     */
+    struct Tables
+    {
+        Curve< 32 > impact;
+        Curve< 64 > pressure_altitude;
+        Curve< 64 > density_altitude;
+
+        constexpr Tables( )
+            : impact( detail::Impact(), 0.0, 0.25 ),
+              pressure_altitude( detail::PressureAltitude(), 35000.0, 110000.0 ),
+              density_altitude( detail::DensityAltitude(), 0.29, 1.45 )
+        {
+        }
+    };
+
+    /**
+     * @brief Single instance of the tables shared by every translation unit
+     */
+    template< typename T = void >
+    struct Lookup
+    {
+        static constexpr Tables tables = Tables();
+    };
+
+    template< typename T > constexpr Tables Lookup< T >::tables;
+
+    /**
+     * @brief Calculates calibrated airspeed in m/s
+     *
+     * @param diff_pressure Differential pressure in Pa
+     * @return float Resulting calibrated air speed
+     */
+    inline float cal_as( float diff_pressure )
+    {
+        float q = diff_pressure / sl_pressure;
+
+        if( !Lookup<>::tables.impact.contains( q ) )
+            return convert::cal_as( diff_pressure );
+
+        return sl_sound_speed * sqrtf( 5.0f * q * Lookup<>::tables.impact( q ) );
+    }
+
+    /**
+     * @brief Calculates equivalent air speed in m/s
+     *
+     * @param diff_pressure Differential pressure in Pa
+     * @param pressure Static pressure in Pa
+     * @return float Resulting equivalent air speed
+     */
+    inline float equiv_as( float diff_pressure, float pressure )
+    {
+        float q = diff_pressure / pressure;
+
+        if( !Lookup<>::tables.impact.contains( q ) )
+            return convert::equiv_as( diff_pressure, pressure );
+
+        return sl_sound_speed * sqrtf( 5.0f * diff_pressure / sl_pressure * Lookup<>::tables.impact( q ) );
+    }
+
+    /**
+     * @brief Calculates pressure altitude in m
+     *
+     * @param pressure Static Pressure in Pa
+     * @return float Resulting pressure altitude
+     */
+    inline float pressure_altitude( float pressure )
+    {
+        if( !Lookup<>::tables.pressure_altitude.contains( pressure ) )
+            return convert::pressure_altitude( pressure );
+
+        return Lookup<>::tables.pressure_altitude( pressure );
+    }
+
+    /**
+     * @brief Calculates above ground level in m given an offet
+     *
+     * @param pressure Static pressure in Pa
+     * @param offset Level offset in m
+     * @return float Resulting above ground level altitude in m
+     */
+    inline float above_gnd_altitude( float pressure, float offset )
+    {
+        return pressure_altitude( pressure ) - offset;
+    }
+
+    /**
+     * @brief Calculates density altitude in m which is based on standard atmosphere
+     *
+     * @param pressure Static pressure in Pa
+     * @param temperature Temperature in Celsius
+     * @return float Resulting density altitude
+     */
+    inline float density_altitude( float pressure, float temperature )
+    {
+        float ratio = ( pressure / sl_pressure ) * ( sl_temperature / ( temperature + 273.15f ) );
+
+        if( !Lookup<>::tables.density_altitude.contains( ratio ) )
+            return convert::density_altitude( pressure, temperature );
+
+        return Lookup<>::tables.density_altitude( ratio );
+    }
+
+    // The rest have no powf, the exact versions are already fast
+    using convert::Unit;
+    using convert::metric;
+    using convert::true_as;
+    using convert::mean_sl_altitude;
+    using convert::approx_temp;
+    using convert::approx_density;
+
+} // End of namespace fast
+
+/*! @} End of Doxygen Groups*/
+
+} // End of namespace convert
+
+/*! @} End of Doxygen Groups*/
+
+} // End of namespace aero
+
+/*! @} End of Doxygen Groups*/
@@ -0,0 +1,421 @@
+#pragma once
+
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    #include "Arduino.h"
+#else
+    #include <cstddef>
+    #include <cstdint>
+    #include <cstring>
+#endif
+
+#include "Data.hpp"
+#include "Utility.hpp"
+
+/*!
+ *  \addtogroup aero
+ *  @{
+ */
+
+//! Aero library code
+namespace aero
+{
+
+/*!
+ *  \addtogroup reflect
+ *  @{
+ */
+
+/*
+    Compile time descriptions of the def:: structs. Each struct lists its
+    fields once in a Describe specialization and the generic routines
+    (endian swaps, quant::pack, and on a host the text writers in
+    Reflect.hpp) are expanded from that list by the compiler, one statement
+    per field with no loop and no allocation. Adding a struct means adding
+    one Describe
+
+    Fields are read and written through their offset with memcpy, never
+    through a reference to the member, so packed structs like GPSCompact_t
+    are safe to visit. Everything here builds as C++11 for the boards
+*/
+
+//! Compile time field reflection for segment structs
+namespace reflect
+{
+    /**
+     * @brief Range and resolution of a quantized field
+     */
+    struct Scale
+    {
+        float min;          // Smallest value that can be sent
+        float max;          // Largest value that can be sent
+        float resolution;   // Value of one count, 0 if the field is not scaled
+    };
+
+    /**
+     * @brief Scale of a field that holds its value as is
+     */
+    constexpr Scale UNSCALED = { 0.0f, 0.0f, 0.0f };
+
+    /**
+     * @brief Storage type of a field
+     */
+    enum class Type : uint8_t { Bool, U8, U16, U32, I16, I32, Float };
+
+    /**
+     * @brief Bytes per value of a field type
+     */
+    constexpr size_t width( Type type )
+    {
+        return type == Type::Bool || type == Type::U8 ? 1
+             : type == Type::U16 || type == Type::I16 ? 2
+             : 4;
+    }
+
+    /**
+     * @brief Field type of a member type
+     */
+    template< typename V > struct TypeOf;
+
+    template<> struct TypeOf< bool >     { static constexpr Type type = Type::Bool; };
+    template<> struct TypeOf< uint8_t >  { static constexpr Type type = Type::U8; };
+    template<> struct TypeOf< uint16_t > { static constexpr Type type = Type::U16; };
+    template<> struct TypeOf< uint32_t > { static constexpr Type type = Type::U32; };
+    template<> struct TypeOf< int16_t >  { static constexpr Type type = Type::I16; };
+    template<> struct TypeOf< int32_t >  { static constexpr Type type = Type::I32; };
+    template<> struct TypeOf< float >    { static constexpr Type type = Type::Float; };
+
+    /**
+     * @brief One field of a struct
+     *
+     * @tparam S Struct
+     * @tparam M Member type
+     */
+    template< typename S, typename M >
+    struct Field
+    {
+        typedef S owner_type;
+        typedef M value_type;
+
+        const char* name;   // Member name
+        M S::* member;      // Pointer to the member, gives the type only
+        size_t offset;      // Offset in the struct, how the member is reached
+        Scale scale;        // Quantization, UNSCALED for most fields
+
+        static constexpr Type type = TypeOf< M >::type;
+    };
+
+    template< typename S, typename M > constexpr Type Field< S, M >::type;
+
+    /**
+     * @brief Build a field description, use AERO_FIELD instead
+     */
+    template< typename S, typename M >
+    constexpr Field< S, M > field( const char* name, M S::* member, size_t offset, Scale scale = UNSCALED )
+    {
+        return { name, member, offset, scale };
+    }
+
+    #define AERO_FIELD( Struct, member ) \
+        ::aero::reflect::field( #member, &Struct::member, offsetof( Struct, member ) )
+
+    #define AERO_SCALED_FIELD( Struct, member, scale ) \
+        ::aero::reflect::field( #member, &Struct::member, offsetof( Struct, member ), scale )
+
+    /**
+     * @brief Fixed list of fields with different types
+     */
+    template< typename... Fs > struct List;
+
+    template<> struct List<>
+    {
+        static constexpr size_t size = 0;
+    };
+
+    template< typename F, typename... Fs >
+    struct List< F, Fs... >
+    {
+        static constexpr size_t size = 1 + sizeof...( Fs );
+
+        F head;
+        List< Fs... > tail;
+    };
+
+    /**
+     * @brief Build a field list
+     */
+    constexpr List<> list( void ) { return {}; }
+
+    template< typename F, typename... Fs >
+    constexpr List< F, Fs... > list( F head, Fs... tail )
+    {
+        return { head, list( tail... ) };
+    }
+
+    // Declares fields() for a Describe, C++11 needs the list type spelled out
+    #define AERO_FIELDS( ... ) \
+        static constexpr auto fields( void ) -> decltype( ::aero::reflect::list( __VA_ARGS__ ) ) \
+        { \
+            return ::aero::reflect::list( __VA_ARGS__ ); \
+        }
+
+    /**
+     * @brief Fields of a struct in declaration order. Only specialized for
+     *        the structs that can be reflected
+     *
+     * @details A specialization has name() and fields(), see the ones below
+     *
+     * @tparam T struct
+     */
+    template< typename T > struct Describe;
+
+    /**
+     * @brief Number of fields in a struct
+     */
+    template< typename T >
+    constexpr size_t count( void )
+    {
+        return decltype( Describe< T >::fields() )::size;
+    }
+
+    /**
+     * @brief Call f( field ) for every field of a list, unrolled
+     */
+    template< typename F >
+    inline void for_each( const List<>&, F&& ) {}
+
+    template< typename F, typename H, typename... Ts >
+    inline void for_each( const List< H, Ts... >& fields, F&& f )
+    {
+        f( fields.head );
+        for_each( fields.tail, f );
+    }
+
+    /**
+     * @brief Call f( field ) for every field of T
+     */
+    template< typename T, typename F >
+    inline void for_each( F&& f )
+    {
+        for_each( Describe< T >::fields(), f );
+    }
+
+    /**
+     * @brief Read a field of an object by its offset
+     */
+    template< typename T, typename M >
+    inline M get( const T& object, const Field< T, M >& field )
+    {
+        M value;
+        memcpy( &value, reinterpret_cast< const uint8_t* >( &object ) + field.offset, sizeof( value ) );
+        return value;
+    }
+
+    /**
+     * @brief Write a field of an object by its offset
+     */
+    template< typename T, typename M >
+    inline void set( T& object, const Field< T, M >& field, M value )
+    {
+        memcpy( reinterpret_cast< uint8_t* >( &object ) + field.offset, &value, sizeof( value ) );
+    }
+
+    //! Visitors behind visit() and swap()
+    namespace detail
+    {
+        // Hands the visitor a copy of each member and writes it back
+        template< typename T, typename F >
+        struct Visit
+        {
+            T& object;
+            F& f;
+
+            template< typename M >
+            void operator()( const Field< T, M >& field ) const
+            {
+                M value = get( object, field );
+                f( field, value );
+                set( object, field, value );
+            }
+        };
+
+        template< typename T, typename F >
+        struct ConstVisit
+        {
+            const T& object;
+            F& f;
+
+            template< typename M >
+            void operator()( const Field< T, M >& field ) const
+            {
+                const M value = get( object, field );
+                f( field, value );
+            }
+        };
+
+        struct SwapField
+        {
+            template< typename F, typename V >
+            void operator()( const F&, V& value ) const { value = bit::swap_endian( value ); }
+        };
+    }
+
+    /**
+     * @brief Call f( field, value ) for every field of an object
+     *
+     * @details The value is a copy of the member, changes to it are written
+     *          back after f returns
+     *
+     * @param object Struct to visit
+     * @param f Visitor taking the field description and a reference to the value
+     */
+    template< typename T, typename F >
+    inline void visit( T& object, F&& f )
+    {
+        detail::Visit< T, F > visitor = { object, f };
+        for_each< T >( visitor );
+    }
+
+    template< typename T, typename F >
+    inline void visit( const T& object, F&& f )
+    {
+        detail::ConstVisit< T, F > visitor = { object, f };
+        for_each< T >( visitor );
+    }
+
+    /**
+     * @brief Call f( a, b ) for matching fields of two lists of the same size
+     */
+    template< typename F >
+    inline void zip( const List<>&, const List<>&, F&& ) {}
+
+    template< typename F, typename A, typename... As, typename B, typename... Bs >
+    inline void zip( const List< A, As... >& a, const List< B, Bs... >& b, F&& f )
+    {
+        static_assert( sizeof...( As ) == sizeof...( Bs ), "Structs must have the same number of fields" );
+        f( a.head, b.head );
+        zip( a.tail, b.tail, f );
+    }
+
+    /**
+     * @brief Reverse the byte order of every field
+     *
+     * @param object Struct to swap in place
+     */
+    template< typename T >
+    inline void swap( T& object )
+    {
+        visit( object, detail::SwapField() );
+    }
+
+    /**
+     * @brief Put every field in little endian order, nothing to do on little
+     *        endian hosts
+     *
+     * @param object Struct to convert in place, converting twice undoes it
+     */
+    template< typename T >
+    inline void to_little_endian( T& object )
+    {
+        if( bit::HOST_ORDER != bit::WIRE_ORDER )
+            swap( object );
+    }
+
+    template<> struct Describe< def::Pitot_t >
+    {
+        static constexpr const char* name( void ) { return "Pitot"; }
+        AERO_FIELDS( AERO_FIELD( def::Pitot_t, differential_pressure ) )
+    };
+
+    template<> struct Describe< def::IMU_t >
+    {
+        static constexpr const char* name( void ) { return "IMU"; }
+        AERO_FIELDS( AERO_FIELD( def::IMU_t, ax ), AERO_FIELD( def::IMU_t, ay ), AERO_FIELD( def::IMU_t, az ),
+                     AERO_FIELD( def::IMU_t, gx ), AERO_FIELD( def::IMU_t, gy ), AERO_FIELD( def::IMU_t, gz ),
+                     AERO_FIELD( def::IMU_t, mx ), AERO_FIELD( def::IMU_t, my ), AERO_FIELD( def::IMU_t, mz ),
+                     AERO_FIELD( def::IMU_t, yaw ), AERO_FIELD( def::IMU_t, pitch ), AERO_FIELD( def::IMU_t, roll ) )
+    };
+
+    template<> struct Describe< def::GPS_t >
+    {
+        static constexpr const char* name( void ) { return "GPS"; }
+        AERO_FIELDS( AERO_FIELD( def::GPS_t, fix ), AERO_FIELD( def::GPS_t, lat ), AERO_FIELD( def::GPS_t, lon ),
+                     AERO_FIELD( def::GPS_t, speed ), AERO_FIELD( def::GPS_t, satellites ),
+                     AERO_FIELD( def::GPS_t, altitude ), AERO_FIELD( def::GPS_t, time ),
+                     AERO_FIELD( def::GPS_t, date ), AERO_FIELD( def::GPS_t, HDOP ),
+                     AERO_FIELD( def::GPS_t, quality ) )
+    };
+
+    template<> struct Describe< def::Enviro_t >
+    {
+        static constexpr const char* name( void ) { return "Enviro"; }
+        AERO_FIELDS( AERO_FIELD( def::Enviro_t, altitude ), AERO_FIELD( def::Enviro_t, temperature ),
+                     AERO_FIELD( def::Enviro_t, pressure ) )
+    };
+
+    template<> struct Describe< def::Battery_t >
+    {
+        static constexpr const char* name( void ) { return "Battery"; }
+        AERO_FIELDS( AERO_FIELD( def::Battery_t, voltage ), AERO_FIELD( def::Battery_t, current ) )
+    };
+
+    template<> struct Describe< def::Radio_t >
+    {
+        static constexpr const char* name( void ) { return "Radio"; }
+        AERO_FIELDS( AERO_FIELD( def::Radio_t, rssi ), AERO_FIELD( def::Radio_t, frequencyError ),
+                     AERO_FIELD( def::Radio_t, snr ) )
+    };
+
+    template<> struct Describe< def::SystemConfig_t >
+    {
+        static constexpr const char* name( void ) { return "Config"; }
+        AERO_FIELDS()
+    };
+
+    template<> struct Describe< def::Status_t >
+    {
+        static constexpr const char* name( void ) { return "Status"; }
+        AERO_FIELDS( AERO_FIELD( def::Status_t, rssi ), AERO_FIELD( def::Status_t, state ) )
+    };
+
+    template<> struct Describe< def::Servos_t >
+    {
+        static constexpr const char* name( void ) { return "Servos"; }
+        AERO_FIELDS( AERO_FIELD( def::Servos_t, servo0 ), AERO_FIELD( def::Servos_t, servo1 ),
+                     AERO_FIELD( def::Servos_t, servo2 ), AERO_FIELD( def::Servos_t, servo3 ),
+                     AERO_FIELD( def::Servos_t, servo4 ), AERO_FIELD( def::Servos_t, servo5 ),
+                     AERO_FIELD( def::Servos_t, servo6 ), AERO_FIELD( def::Servos_t, servo7 ),
+                     AERO_FIELD( def::Servos_t, servo8 ), AERO_FIELD( def::Servos_t, servo9 ),
+                     AERO_FIELD( def::Servos_t, servo10 ), AERO_FIELD( def::Servos_t, servo11 ),
+                     AERO_FIELD( def::Servos_t, servo12 ), AERO_FIELD( def::Servos_t, servo13 ),
+                     AERO_FIELD( def::Servos_t, servo14 ), AERO_FIELD( def::Servos_t, servo15 ) )
+    };
+
+    template<> struct Describe< def::AirData_t >
+    {
+        static constexpr const char* name( void ) { return "AirData"; }
+        AERO_FIELDS( AERO_FIELD( def::AirData_t, ias ), AERO_FIELD( def::AirData_t, eas ),
+                     AERO_FIELD( def::AirData_t, tas ), AERO_FIELD( def::AirData_t, agl ),
+                     AERO_FIELD( def::AirData_t, pressure_alt ), AERO_FIELD( def::AirData_t, msl ),
+                     AERO_FIELD( def::AirData_t, density_alt ), AERO_FIELD( def::AirData_t, approx_temp ),
+                     AERO_FIELD( def::AirData_t, density ) )
+    };
+
+    template<> struct Describe< def::Commands_t >
+    {
+        static constexpr const char* name( void ) { return "Commands"; }
+        AERO_FIELDS( AERO_FIELD( def::Commands_t, drop ), AERO_FIELD( def::Commands_t, servos ),
+                     AERO_FIELD( def::Commands_t, pitch ) )
+    };
+
+    template<> struct Describe< def::DropAlgo_t >
+    {
+        static constexpr const char* name( void ) { return "DropAlgo"; }
+        AERO_FIELDS( AERO_FIELD( def::DropAlgo_t, heading ), AERO_FIELD( def::DropAlgo_t, distance ) )
+    };
+} // End of namespace reflect
+
+/*! @} End of Doxygen Groups*/
+
+} // End of namespace aero
+
+/*! @} End of Doxygen Groups*/
@@ -0,0 +1,467 @@
+#pragma once
+
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    #include "Arduino.h"
+#else
+    #include <cstddef>
+    #include <cstdint>
+    #include <cstring>
+    #include <cmath>
+#endif
+
+#include "ConvertBatch.hpp"     // Vector backends
+
+/*!
+ *  \addtogroup aero
+ *  @{
+ */
+
+//! Aero library code
+namespace aero
+{
+
+/*!
+ *  \addtogroup filter
+ *  @{
+ */
+
+//! Streaming filters over several sensor channels at once
+namespace filter
+{
+    // Widest backend every processor of the target has. The filters step a
+    // handful of channels at a time, too few to pay for run time dispatch
+#if defined(AERO_SIMD_X86)
+    typedef convert::simd::Sse2 Lanes;
+#elif defined(AERO_SIMD_NEON)
+    typedef convert::simd::Neon Lanes;
+#else
+    typedef convert::simd::Scalar Lanes;
+#endif
+
+    typedef convert::simd::Scalar Scalar;
+
+    /*
+     * Every filter takes C channels per step as an array of C floats and
+     * keeps its history in fixed arrays, sample by sample with the channels
+     * of a sample next to each other. A step runs the channels V::width at
+     * a time and the ones left over one at a time. The first step fills the
+     * history with its input, so there is no ramp up from zero
+     *
+     *     filter::Median< 3, 5 > spikes;           // Pitot, pressure, temperature
+     *     filter::Biquad< 12 > smooth( filter::Coefficients::lowpass( 20.0f, 1000.0f ) );
+     *     filter::apply( smooth, imu );            // Every field of an IMU_t
+     */
+
+    /**
+     * @brief Mean of the last N samples of each channel
+     *
+     * @details A running sum, one add and one subtract per channel a step.
+     *          The sum is added up again from the history each time the
+     *          ring wraps, so rounding never builds up
+     *
+     * @tparam C Number of channels
+     * @tparam N Number of samples averaged
+     * @tparam V Vector backend
+     */
+    template< size_t C, size_t N, typename V = Lanes >
+    class MovingAverage
+    {
+    public:
+        static_assert( C > 0 && N > 0, "Filters need at least one channel and sample" );
+
+        static const size_t channels = C;    // Values a step takes
+
+        MovingAverage( ) { reset(); }
+
+        /**
+         * @brief Forget the history, the next step fills it again
+         */
+        void reset( void )
+        {
+            m_head = 0;
+            m_primed = false;
+        }
+
+        /**
+         * @brief Add a sample and get the mean
+         *
+         * @param in C new values
+         * @param out C filtered values, may be in
+         */
+        void step( const float* in, float* out )
+        {
+            if( !m_primed )
+                prime( in );
+
+            float* slot = m_ring[ m_head ];
+            // Whole vectors, then the channels left over one at a time
+            const size_t whole = C - C % V::width;
+            for( size_t i = 0; i < whole; i += V::width )
+                lane< V >( i, in, slot, out );
+            for( size_t i = whole; i < C; ++i )
+                lane< Scalar >( i, in, slot, out );
+
+            if( ++m_head == N )
+            {
+                m_head = 0;
+                resum();
+            }
+        }
+
+    private:
+        template< typename W >
+        void lane( size_t i, const float* in, float* slot, float* out )
+        {
+            typename W::F x = W::load( in + i );
+            typename W::F sum = W::add( W::sub( W::load( m_sum + i ), W::load( slot + i ) ), x );
+
+            W::store( slot + i, x );
+            W::store( m_sum + i, sum );
+            W::store( out + i, W::mul( sum, W::set( 1.0f / N ) ) );
+        }
+
+        void prime( const float* in )
+        {
+            for( size_t n = 0; n < N; ++n )
+                memcpy( m_ring[ n ], in, sizeof( m_ring[ n ] ) );
+            resum();
+            m_primed = true;
+        }
+
+        void resum( void )
+        {
+            for( size_t i = 0; i < C; ++i )
+                m_sum[ i ] = 0.0f;
+            for( size_t n = 0; n < N; ++n )
+                for( size_t i = 0; i < C; ++i )
+                    m_sum[ i ] += m_ring[ n ][ i ];
+        }
+
+        float m_ring[ N ][ C ];     // Last N samples
+        float m_sum[ C ];           // Sum of the ring
+        size_t m_head;              // Slot the next sample goes in
+        bool m_primed;              // Ring holds real samples
+    };
+
+    /**
+     * @brief Median of the last N samples of each channel, removes spikes
+     *
+     * @details The history is sorted with min and max only, an odd-even
+     *          transposition network, so it runs on vectors without
+     *          branches. Fine for the small N spike removal wants
+     *
+     * @tparam C Number of channels
+     * @tparam N Number of samples, odd
+     * @tparam V Vector backend
+     */
+    template< size_t C, size_t N, typename V = Lanes >
+    class Median
+    {
+    public:
+        static_assert( C > 0 && N % 2 == 1, "Median needs at least one channel and an odd number of samples" );
+
+        static const size_t channels = C;    // Values a step takes
+
+        Median( ) { reset(); }
+
+        /**
+         * @brief Forget the history, the next step fills it again
+         */
+        void reset( void )
+        {
+            m_head = 0;
+            m_primed = false;
+        }
+
+        /**
+         * @brief Add a sample and get the median
+         *
+         * @param in C new values
+         * @param out C filtered values, may be in
+         */
+        void step( const float* in, float* out )
+        {
+            if( !m_primed )
+            {
+                for( size_t n = 0; n < N; ++n )
+                    memcpy( m_ring[ n ], in, sizeof( m_ring[ n ] ) );
+                m_primed = true;
+            }
+
+            memcpy( m_ring[ m_head ], in, sizeof( m_ring[ m_head ] ) );
+            m_head = m_head + 1 == N ? 0 : m_head + 1;
+
+            // Whole vectors, then the channels left over one at a time
+            const size_t whole = C - C % V::width;
+            for( size_t i = 0; i < whole; i += V::width )
+                lane< V >( i, out );
+            for( size_t i = whole; i < C; ++i )
+                lane< Scalar >( i, out );
+        }
+
+    private:
+        template< typename W >
+        void lane( size_t i, float* out )
+        {
+            typename W::F v[ N ];
+            for( size_t n = 0; n < N; ++n )
+                v[ n ] = W::load( m_ring[ n ] + i );
+
+            for( size_t round = 0; round < N; ++round )
+                for( size_t n = round & 1; n + 1 < N; n += 2 )
+                {
+                    typename W::F low = W::min( v[ n ], v[ n + 1 ] );
+                    v[ n + 1 ] = W::max( v[ n ], v[ n + 1 ] );
+                    v[ n ] = low;
+                }
+
+            W::store( out + i, v[ N / 2 ] );
+        }
+
+        float m_ring[ N ][ C ];     // Last N samples
+        size_t m_head;              // Slot the next sample goes in
+        bool m_primed;              // Ring holds real samples
+    };
+
+    /**
+     * @brief Biquad coefficients, normalized so a0 is 1
+     */
+    struct Coefficients
+    {
+        float b0, b1, b2;   // Feed forward
+        float a1, a2;       // Feedback
+
+        /**
+         * @brief Second order low pass, from the Audio EQ Cookbook
+         *
+         * @param cutoff_hz Corner frequency, below half the rate
+         * @param rate_hz Sample rate
+         * @param q Quality, the default is Butterworth
+         */
+        static Coefficients lowpass( float cutoff_hz, float rate_hz, float q = 0.70710678f )
+        {
+            float w = 6.28318531f * cutoff_hz / rate_hz, c = cosf( w ), alpha = sinf( w ) / ( 2.0f * q );
+            return normalize( 0.5f * ( 1.0f - c ), 1.0f - c, 0.5f * ( 1.0f - c ), 1.0f + alpha, -2.0f * c, 1.0f - alpha );
+        }
+
+        /**
+         * @brief Second order high pass, from the Audio EQ Cookbook
+         */
+        static Coefficients highpass( float cutoff_hz, float rate_hz, float q = 0.70710678f )
+        {
+            float w = 6.28318531f * cutoff_hz / rate_hz, c = cosf( w ), alpha = sinf( w ) / ( 2.0f * q );
+            return normalize( 0.5f * ( 1.0f + c ), -( 1.0f + c ), 0.5f * ( 1.0f + c ), 1.0f + alpha, -2.0f * c, 1.0f - alpha );
+        }
+
+        /**
+         * @brief Notch, for a motor or propeller frequency
+         *
+         * @param q Quality, higher is narrower
+         */
+        static Coefficients notch( float centre_hz, float rate_hz, float q = 5.0f )
+        {
+            float w = 6.28318531f * centre_hz / rate_hz, c = cosf( w ), alpha = sinf( w ) / ( 2.0f * q );
+            return normalize( 1.0f, -2.0f * c, 1.0f, 1.0f + alpha, -2.0f * c, 1.0f - alpha );
+        }
+
+        /**
+         * @brief Gain for a constant input
+         */
+        float dc_gain( void ) const { return ( b0 + b1 + b2 ) / ( 1.0f + a1 + a2 ); }
+
+    private:
+        static Coefficients normalize( float b0, float b1, float b2, float a0, float a1, float a2 )
+        {
+            Coefficients k = { b0 / a0, b1 / a0, b2 / a0, a1 / a0, a2 / a0 };
+            return k;
+        }
+    };
+
+    /**
+     * @brief Second order IIR filter, the same one on every channel
+     *
+     * @details Transposed direct form II, two state values per channel.
+     *          Starts in the steady state of the first sample
+     *
+     * @tparam C Number of channels
+     * @tparam V Vector backend
+     */
+    template< size_t C, typename V = Lanes >
+    class Biquad
+    {
+    public:
+        static_assert( C > 0, "Filters need at least one channel" );
+
+        static const size_t channels = C;    // Values a step takes
+
+        /**
+         * @brief Constructor
+         *
+         * @param k Coefficients from Coefficients::lowpass and friends
+         */
+        explicit Biquad( const Coefficients& k ) : m_k( k ), m_z1(), m_z2() { reset(); }
+
+        /**
+         * @brief Forget the state, the next step starts from its input
+         */
+        void reset( void ) { m_primed = false; }
+
+        /**
+         * @brief Filter a sample
+         *
+         * @param in C new values
+         * @param out C filtered values, may be in
+         */
+        void step( const float* in, float* out )
+        {
+            if( !m_primed )
+                prime( in );
+
+            // Whole vectors, then the channels left over one at a time
+            const size_t whole = C - C % V::width;
+            for( size_t i = 0; i < whole; i += V::width )
+                lane< V >( i, in, out );
+            for( size_t i = whole; i < C; ++i )
+                lane< Scalar >( i, in, out );
+        }
+
+        const Coefficients& coefficients( void ) const { return m_k; }
+
+    private:
+        template< typename W >
+        void lane( size_t i, const float* in, float* out )
+        {
+            typedef typename W::F F;
+            F x = W::load( in + i );
+            F y = W::add( W::mul( W::set( m_k.b0 ), x ), W::load( m_z1 + i ) );
+
+            F z1 = W::add( W::sub( W::mul( W::set( m_k.b1 ), x ), W::mul( W::set( m_k.a1 ), y ) ), W::load( m_z2 + i ) );
+            F z2 = W::sub( W::mul( W::set( m_k.b2 ), x ), W::mul( W::set( m_k.a2 ), y ) );
+
+            W::store( m_z1 + i, z1 );
+            W::store( m_z2 + i, z2 );
+            W::store( out + i, y );
+        }
+
+        void prime( const float* in )
+        {
+            float gain = m_k.dc_gain();
+            for( size_t i = 0; i < C; ++i )
+            {
+                float x = in[ i ], y = gain * x;
+                m_z2[ i ] = m_k.b2 * x - m_k.a2 * y;
+                m_z1[ i ] = m_k.b1 * x - m_k.a1 * y + m_z2[ i ];
+            }
+            m_primed = true;
+        }
+
+        Coefficients m_k;       // Shared by every channel
+        float m_z1[ C ];        // State
+        float m_z2[ C ];
+        bool m_primed;          // State follows real samples
+    };
+
+    /**
+     * @brief Blends the integral of a rate with a measurement of the value
+     *
+     * @details out = a ( out + rate dt ) + ( 1 - a ) measurement with
+     *          a = tau / ( tau + dt ). The rate is trusted for changes
+     *          faster than tau and the measurement for slower ones, like
+     *          gyro rates and accelerometer angles or climb rate and
+     *          barometric altitude
+     *
+     * @tparam C Number of channels
+     * @tparam V Vector backend
+     */
+    template< size_t C, typename V = Lanes >
+    class Complementary
+    {
+    public:
+        static_assert( C > 0, "Filters need at least one channel" );
+
+        static const size_t channels = C;    // Values a step takes
+
+        /**
+         * @brief Constructor
+         *
+         * @param tau Time constant in seconds
+         * @param rate_hz Sample rate
+         */
+        Complementary( float tau, float rate_hz )
+        {
+            m_dt = 1.0f / rate_hz;
+            m_alpha = tau / ( tau + m_dt );
+            reset();
+        }
+
+        /**
+         * @brief Forget the state, the next step starts from its measurement
+         */
+        void reset( void ) { m_primed = false; }
+
+        /**
+         * @brief Blend a sample
+         *
+         * @param rate C rates of change, per second
+         * @param measurement C measured values
+         * @param out C blended values, may be either input
+         */
+        void step( const float* rate, const float* measurement, float* out )
+        {
+            if( !m_primed )
+            {
+                memcpy( m_value, measurement, sizeof( m_value ) );
+                m_primed = true;
+            }
+
+            // Whole vectors, then the channels left over one at a time
+            const size_t whole = C - C % V::width;
+            for( size_t i = 0; i < whole; i += V::width )
+                lane< V >( i, rate, measurement, out );
+            for( size_t i = whole; i < C; ++i )
+                lane< Scalar >( i, rate, measurement, out );
+        }
+
+    private:
+        template< typename W >
+        void lane( size_t i, const float* rate, const float* measurement, float* out )
+        {
+            typedef typename W::F F;
+            F predicted = W::add( W::load( m_value + i ), W::mul( W::load( rate + i ), W::set( m_dt ) ) );
+            F value = W::add( W::mul( W::set( m_alpha ), W::sub( predicted, W::load( measurement + i ) ) ), W::load( measurement + i ) );
+
+            W::store( m_value + i, value );
+            W::store( out + i, value );
+        }
+
+        float m_value[ C ];     // Blended values
+        float m_alpha;          // Weight of the integrated rate
+        float m_dt;             // Sample period [ s ]
+        bool m_primed;          // State follows real samples
+    };
+
+    /**
+     * @brief Filter every field of an all float segment in place
+     *
+     * @details For IMU_t with 12 channels, Enviro_t with 3 or Pitot_t with 1
+     *
+     * @param filter Any filter with a step( in, out ) and one channel per field
+     * @param sample Segment to filter
+     */
+    template< typename Filter, typename T >
+    void apply( Filter& filter, T& sample )
+    {
+        static_assert( Filter::channels * sizeof( float ) == sizeof( T ), "The filter needs one channel per float of the segment" );
+
+        float values[ Filter::channels ];
+        memcpy( values, &sample, sizeof( values ) );
+        filter.step( values, values );
+        memcpy( &sample, values, sizeof( values ) );
+    }
+} // End of namespace filter
+
+/*! @} End of Doxygen Groups*/
+
+} // End of namespace aero
+
+/*! @} End of Doxygen Groups*/
@@ -0,0 +1,370 @@
+#pragma once
+
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    #include "Arduino.h"
+#else
+    #include <cstddef>
+    #include <cstdint>
+#endif
+
+#include "Data.hpp"
+
+/*!
+ *  \addtogroup aero
+ *  @{
+ */
+
+//! Aero library code
+namespace aero
+{
+
+/*!
+ *  \addtogroup fixed
+ *  @{
+ */
+
+//! Fixed-point numbers and air data for boards without an FPU
+namespace fixed
+{
+    /**
+     * @brief Integer type twice as wide as a storage type, for products
+     */
+    template< typename Rep > struct Wide;
+
+    template<> struct Wide< int16_t > { typedef int32_t type; typedef uint32_t unsigned_type; };
+    template<> struct Wide< int32_t > { typedef int64_t type; typedef uint64_t unsigned_type; };
+
+    /**
+     * @brief Signed fixed-point number with FRAC fraction bits
+     *
+     * @details Every operation saturates at the limits of Rep instead of
+     *          wrapping. Products and quotients use the wide type, so on AVR
+     *          a Q1.15 multiply is a single 16 x 16 bit hardware multiply.
+     *          A plain struct so it can go straight into a segment
+     *
+     * @tparam Rep Storage type, int16_t or int32_t
+     * @tparam FRAC Number of fraction bits
+     */
+    template< typename Rep, int FRAC >
+    struct Fixed
+    {
+        typedef typename Wide< Rep >::type wide_type;
+        static const int FRAC_BITS = FRAC;
+        static const wide_type RAW_MAX = ( wide_type( 1 ) << ( 8 * sizeof( Rep ) - 1 ) ) - 1;
+        static const wide_type RAW_MIN = -RAW_MAX - 1;
+
+        Rep raw;    // Value times 2^FRAC
+
+        /**
+         * @brief Build from the scaled integer
+         */
+        static constexpr Fixed from_raw( Rep value )
+        {
+            return { value };
+        }
+
+        /**
+         * @brief Build from a wide integer, saturating at the limits of Rep
+         */
+        static constexpr Fixed saturate( wide_type value )
+        {
+            return value > RAW_MAX ? max() : value < RAW_MIN ? min() : from_raw( static_cast< Rep >( value ) );
+        }
+
+        /**
+         * @brief Nearest value to a float. Saturates, NaN becomes 0
+         */
+        static constexpr Fixed from_float( float value )
+        {
+            return from_scaled( value * static_cast< float >( wide_type( 1 ) << FRAC ) );
+        }
+
+        /**
+         * @brief Nearest value to a float already times 2^FRAC
+         */
+        static constexpr Fixed from_scaled( float scaled )
+        {
+            return !( scaled == scaled ) ? from_raw( 0 )
+                 : scaled >= static_cast< float >( RAW_MAX ) ? max()
+                 : scaled <= static_cast< float >( RAW_MIN ) ? min()
+                 : from_raw( static_cast< Rep >( scaled >= 0.0f ? scaled + 0.5f : scaled - 0.5f ) );
+        }
+
+        /**
+         * @brief Value of an integer, saturating
+         */
+        static constexpr Fixed from_int( int32_t value )
+        {
+            return saturate( static_cast< wide_type >( value ) * ( wide_type( 1 ) << FRAC ) );
+        }
+
+        /**
+         * @brief Largest value
+         */
+        static constexpr Fixed max( void ) { return from_raw( static_cast< Rep >( RAW_MAX ) ); }
+
+        /**
+         * @brief Smallest value
+         */
+        static constexpr Fixed min( void ) { return from_raw( static_cast< Rep >( RAW_MIN ) ); }
+
+        /**
+         * @brief One, or the largest value if one does not fit
+         */
+        static constexpr Fixed one( void ) { return saturate( wide_type( 1 ) << FRAC ); }
+
+        /**
+         * @brief Convert to float
+         */
+        float to_float( void ) const { return static_cast< float >( raw ) / static_cast< float >( wide_type( 1 ) << FRAC ); }
+
+        Fixed operator+( Fixed rhs ) const { return saturate( static_cast< wide_type >( raw ) + rhs.raw ); }
+        Fixed operator-( Fixed rhs ) const { return saturate( static_cast< wide_type >( raw ) - rhs.raw ); }
+        Fixed operator-( void ) const { return saturate( -static_cast< wide_type >( raw ) ); }
+
+        /**
+         * @brief Product rounded to nearest
+         */
+        Fixed operator*( Fixed rhs ) const
+        {
+            wide_type product = static_cast< wide_type >( raw ) * rhs.raw;
+            return saturate( ( product + ( wide_type( 1 ) << ( FRAC - 1 ) ) ) >> FRAC );
+        }
+
+        /**
+         * @brief Quotient rounded toward zero. Dividing by zero saturates
+         *        toward the sign of the dividend
+         */
+        Fixed operator/( Fixed rhs ) const
+        {
+            if( rhs.raw == 0 )
+                return raw > 0 ? max() : raw < 0 ? min() : from_raw( 0 );
+
+            return saturate( ( static_cast< wide_type >( raw ) * ( wide_type( 1 ) << FRAC ) ) / rhs.raw );
+        }
+
+        Fixed& operator+=( Fixed rhs ) { return *this = *this + rhs; }
+        Fixed& operator-=( Fixed rhs ) { return *this = *this - rhs; }
+        Fixed& operator*=( Fixed rhs ) { return *this = *this * rhs; }
+        Fixed& operator/=( Fixed rhs ) { return *this = *this / rhs; }
+
+        bool operator==( Fixed rhs ) const { return raw == rhs.raw; }
+        bool operator!=( Fixed rhs ) const { return raw != rhs.raw; }
+        bool operator<( Fixed rhs ) const  { return raw < rhs.raw; }
+        bool operator<=( Fixed rhs ) const { return raw <= rhs.raw; }
+        bool operator>( Fixed rhs ) const  { return raw > rhs.raw; }
+        bool operator>=( Fixed rhs ) const { return raw >= rhs.raw; }
+    };
+
+    typedef Fixed< int32_t, 16 > Q16_16;    // -32768 to 32768 in steps of 1.5e-5
+    typedef Fixed< int16_t, 15 > Q1_15;     // -1 to 1 in steps of 3.1e-5
+    typedef Fixed< int32_t, 30 > Q2_30;     // -2 to 2 in steps of 9.3e-10, for constants
+
+    /**
+     * @brief Change format, rounding to nearest and saturating
+     *
+     * @tparam To Format to convert to
+     * @param value Value to convert
+     * @return To Converted value
+     */
+    template< typename To, typename Rep, int FRAC >
+    inline To rescale( Fixed< Rep, FRAC > value )
+    {
+        typedef int64_t wide;
+        const int up = To::FRAC_BITS > FRAC ? To::FRAC_BITS - FRAC : 0;
+        const int down = FRAC > To::FRAC_BITS ? FRAC - To::FRAC_BITS : 0;
+
+        wide scaled = static_cast< wide >( value.raw ) * ( wide( 1 ) << up );
+        return To::saturate( ( scaled + ( ( wide( 1 ) << down ) >> 1 ) ) >> down );
+    }
+
+    /**
+     * @brief Multiply by a value in another format, keeping the format of
+     *        the first. Used to scale by precise Q2.30 constants
+     *
+     * @param value Value to scale
+     * @param factor Scale factor
+     * @return Fixed Product rounded to nearest
+     */
+    template< typename Rep, int FRAC, typename Rep2, int FRAC2 >
+    inline Fixed< Rep, FRAC > mul( Fixed< Rep, FRAC > value, Fixed< Rep2, FRAC2 > factor )
+    {
+        int64_t product = static_cast< int64_t >( value.raw ) * factor.raw;
+        return Fixed< Rep, FRAC >::saturate( ( product + ( int64_t( 1 ) << ( FRAC2 - 1 ) ) ) >> FRAC2 );
+    }
+
+    /**
+     * @brief Square root rounded to nearest, 0 for negative values
+     *
+     * @param value Value to take the root of
+     * @return Fixed Square root
+     */
+    template< typename Rep, int FRAC >
+    inline Fixed< Rep, FRAC > sqrt( Fixed< Rep, FRAC > value )
+    {
+        typedef typename Wide< Rep >::unsigned_type U;
+
+        if( value.raw <= 0 )
+            return Fixed< Rep, FRAC >::from_raw( 0 );
+
+        // Integer root of raw * 2^FRAC, one result bit per step
+        U n = static_cast< U >( value.raw ) << FRAC;
+        U root = 0;
+        U bit = U( 1 ) << ( 8 * sizeof( U ) - 2 );
+
+        while( bit > n )
+            bit >>= 2;
+
+        while( bit != 0 )
+        {
+            if( n >= root + bit )
+            {
+                n -= root + bit;
+                root = ( root >> 1 ) + bit;
+            }
+            else
+            {
+                root >>= 1;
+            }
+
+            bit >>= 2;
+        }
+
+        if( n > root )
+            ++root;
+
+        return Fixed< Rep, FRAC >::saturate( static_cast< typename Wide< Rep >::type >( root ) );
+    }
+
+    // Namespace constants
+    namespace
+    {
+        // Fit of sqrt( ( ( 1 + q )^( 2/7 ) - 1 ) / ( 2q/7 ) ) = 1 + q s( q ) for
+        // q = dp / p0 from 0 to 0.33, coefficients of s from q^0 up
+        const int16_t compressibility[] = { -5851, 2816, -1681, 793 };
+
+        // Pressure altitude fit over x = p / p0 from 0.34 to 1.1, Q16.16 m,
+        // coefficients from t^0 up with t = ( p - 729.54 hPa ) / 385.035 hPa
+        const int32_t altitude[] = { 176099205, -274169953, 58579090, -18639576, 6908948, -2834035,
+                                     1202083, -399442, 175893, -207428, 97877 };
+        const int32_t altitude_centre = 47811133;           // 729.54 hPa in Q16.16
+        const int32_t altitude_half_range = 25233654;       // 385.035 hPa in Q16.16
+        const int64_t altitude_scale = 713903689;           // 2^38 / 385.035, takes hPa to t in Q2.30
+
+        const Q16_16 impact_gain = Q16_16::from_raw( 83738 );           // a0 sqrt( 10 / 7 p0 )
+        const Q16_16 celsius_offset = Q16_16::from_raw( 17901158 );     // 273.15
+        const Q2_30 inverse_sl_temperature = Q2_30::from_raw( 3726329 ); // 1 / 288.15 K
+        const Q2_30 density_gain = Q2_30::from_raw( 373885324 );        // air_mass * 100 / gas_const
+    }
+
+    /**
+     * @brief Calculates calibrated airspeed
+     *
+     * @param diff_pressure Differential pressure in Pa
+     * @return Q16_16 Calibrated airspeed in m/s, 0 for negative pressure
+     */
+    inline Q16_16 cal_as( Q16_16 diff_pressure )
+    {
+        if( diff_pressure.raw <= 0 )
+            return Q16_16::from_raw( 0 );
+
+        // dp / p0 in Q1.15, below 0.33 for any Q16.16 pressure
+        Q1_15 q = Q1_15::from_raw( static_cast< int16_t >( diff_pressure.raw / 202650 ) );
+
+        Q1_15 s = Q1_15::from_raw( compressibility[ 3 ] );
+        for( int i = 2; i >= 0; --i )
+            s = s * q + Q1_15::from_raw( compressibility[ i ] );
+
+        Q16_16 correction = Q16_16::one() + rescale< Q16_16 >( s * q );
+        return sqrt( diff_pressure ) * impact_gain * correction;
+    }
+
+    /**
+     * @brief Calculates true airspeed
+     *
+     * @param airspeed Either indicated or equivalent airspeed in m/s
+     * @param temperature Air temperature in Celsius
+     * @return Q16_16 True airspeed in m/s
+     */
+    inline Q16_16 true_as( Q16_16 airspeed, Q16_16 temperature )
+    {
+        return airspeed * sqrt( mul( temperature + celsius_offset, inverse_sl_temperature ) );
+    }
+
+    /**
+     * @brief Calculates pressure altitude
+     *
+     * @param pressure Static pressure in hPa, Pa does not fit in Q16.16.
+     *        Clamped to 344.5 to 1114.6 hPa
+     * @return Q16_16 Pressure altitude in m
+     */
+    inline Q16_16 pressure_altitude( Q16_16 pressure )
+    {
+        int64_t offset = static_cast< int64_t >( pressure.raw ) - altitude_centre;
+
+        if( offset > altitude_half_range )
+            offset = altitude_half_range;
+        else if( offset < -altitude_half_range )
+            offset = -altitude_half_range;
+
+        Q2_30 t = Q2_30::saturate( ( offset * altitude_scale + ( int64_t( 1 ) << 23 ) ) >> 24 );
+
+        Q16_16 result = Q16_16::from_raw( altitude[ 10 ] );
+        for( int i = 9; i >= 0; --i )
+            result = mul( result, t ) + Q16_16::from_raw( altitude[ i ] );
+
+        return result;
+    }
+
+    /**
+     * @brief Calculates air density
+     *
+     * @param pressure Static pressure in hPa
+     * @param temperature Temperature in Celsius
+     * @return Q16_16 Air density in kg/m^3
+     */
+    inline Q16_16 approx_density( Q16_16 pressure, Q16_16 temperature )
+    {
+        return mul( pressure, density_gain ) / ( temperature + celsius_offset );
+    }
+
+    /**
+     * @brief Calculate air data into the integer fields of a segment. Fills
+     *        ias, tas, pressure_alt and density with Q16.16 values, read
+     *        them back with Q16_16::from_raw. The other fields are untouched
+     *
+     * @param diff_pressure Differential pressure in Pa
+     * @param pressure Static pressure in hPa
+     * @param temperature Temperature in Celsius
+     * @param out Segment to fill
+     */
+    inline void compute( Q16_16 diff_pressure, Q16_16 pressure, Q16_16 temperature, def::AirData_t& out )
+    {
+        Q16_16 ias = cal_as( diff_pressure );
+
+        out.ias = static_cast< uint32_t >( ias.raw );
+        out.tas = static_cast< uint32_t >( true_as( ias, temperature ).raw );
+        out.pressure_alt = static_cast< uint32_t >( pressure_altitude( pressure ).raw );
+        out.density = static_cast< uint32_t >( approx_density( pressure, temperature ).raw );
+    }
+
+    /**
+     * @brief Calculate air data from the raw sensor segments
+     *
+     * @param pitot Pitot tube data
+     * @param enviro Environmental sensor data, pressure in Pa
+     * @param out Segment to fill
+     */
+    inline void compute( const def::Pitot_t& pitot, const def::Enviro_t& enviro, def::AirData_t& out )
+    {
+        compute( Q16_16::from_float( pitot.differential_pressure ),
+                 Q16_16::from_float( enviro.pressure * 0.01f ),
+                 Q16_16::from_float( enviro.temperature ), out );
+    }
+} // End of namespace fixed
+
+/*! @} End of Doxygen Groups*/
+
+} // End of namespace aero
+
+/*! @} End of Doxygen Groups*/
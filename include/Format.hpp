@@ -0,0 +1,709 @@
+#pragma once
+
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    #include "Arduino.h"
+#else
+    #include <cstddef>
+    #include <cstdint>
+    #include <cstdio>
+    #include <cstring>
+    #include <cmath>
+    #include <cerrno>
+    #if defined(__unix__) || defined(__APPLE__)
+        #include <unistd.h>
+        #define AERO_FORMAT_FD
+    #endif
+#endif
+
+/*!
+ *  \addtogroup aero
+ *  @{
+ */
+
+//! Aero library code
+namespace aero
+{
+
+/*!
+ *  \addtogroup print
+ *  @{
+ */
+
+//! Printing helper functions to output data to serial monitor/terminal
+namespace print
+{
+    /**
+     * @brief Where a formatter flushes its buffer
+     *
+     * @details Build one with to(), an empty sink keeps the text in the buffer
+     */
+    struct Sink
+    {
+        size_t ( *write )( const Sink& sink, const char* data, size_t len );   // NULL for no sink
+        void* target;   // Stream or FILE
+        int fd;         // File descriptor
+    };
+
+    //! Sink writers
+    namespace detail
+    {
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+        inline size_t write_print( const Sink& sink, const char* data, size_t len )
+        {
+            return static_cast< Print* >( sink.target )->write( reinterpret_cast< const uint8_t* >( data ), len );
+        }
+#else
+        inline size_t write_file( const Sink& sink, const char* data, size_t len )
+        {
+            return fwrite( data, 1, len, static_cast< FILE* >( sink.target ) );
+        }
+#endif
+
+#if defined(AERO_FORMAT_FD)
+        inline size_t write_fd( const Sink& sink, const char* data, size_t len )
+        {
+            size_t done = 0;
+
+            while( done < len )
+            {
+                ssize_t n = ::write( sink.fd, data + done, len - done );
+
+                if( n < 0 && errno == EINTR )
+                    continue;
+                if( n <= 0 )
+                    break;
+
+                done += static_cast< size_t >( n );
+            }
+
+            return done;
+        }
+#endif
+    }
+
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    /**
+     * @brief Flush to a serial port or anything else Arduino can print to
+     */
+    inline Sink to( Print& port ) { return { detail::write_print, &port, -1 }; }
+#else
+    /**
+     * @brief Flush to a stdio stream such as stdout
+     */
+    inline Sink to( FILE* file ) { return { detail::write_file, file, -1 }; }
+#endif
+
+#if defined(AERO_FORMAT_FD)
+    /**
+     * @brief Flush to a file descriptor with write(2), for example a PosixPort
+     */
+    inline Sink to_fd( int fd ) { return { detail::write_fd, NULL, fd }; }
+#endif
+
+    /**
+     * @brief Alignment of a value inside its width
+     */
+    enum class Align : uint8_t { Left, Right };
+
+    //! Number to text conversions
+    namespace detail
+    {
+        // Exact powers of ten in double
+        constexpr double POW10[] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                     1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+        constexpr uint32_t POW10_U32[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+
+        /**
+         * @brief Scale by a power of ten, exact while the power is
+         */
+        inline double scale10( double value, int exponent )
+        {
+            while( exponent > 22 )
+            {
+                value *= 1e22;
+                exponent -= 22;
+            }
+            while( exponent < -22 )
+            {
+                value /= 1e22;
+                exponent += 22;
+            }
+
+            return exponent >= 0 ? value * POW10[ exponent ] : value / POW10[ -exponent ];
+        }
+
+        /**
+         * @brief Write the decimal digits of a number backwards
+         *
+         * @return size_t Number of digits, at least one
+         */
+        template< typename U >
+        inline size_t digits( U value, char* end )
+        {
+            size_t n = 0;
+
+            do
+            {
+                *--end = static_cast< char >( '0' + value % 10 );
+                value /= 10;
+                ++n;
+            } while( value != 0 );
+
+            return n;
+        }
+
+        /**
+         * @brief Shortest decimal digits that read back as the same float
+         *
+         * @details Tries 1 to 9 significant digits in double, the first
+         *          that rounds back to the value wins. Round trips where
+         *          double has 53 bits, boards with a 32 bit double get up
+         *          to 9 digits of a close value
+         *
+         * @param value Finite value above zero
+         * @param exponent Decimal exponent of the first digit
+         * @return uint32_t Significant digits without trailing zeros
+         */
+        inline uint32_t shortest( float value, int& exponent )
+        {
+            double d = value;
+            int k = static_cast< int >( floor( log10( d ) ) );
+            uint32_t best = 0;
+
+            // log10 can be one off right at a power of ten
+            if( scale10( d, -k ) >= 10.0 )
+                ++k;
+            else if( scale10( d, -k ) < 1.0 )
+                --k;
+
+            for( int p = 1; p <= 9; ++p )
+            {
+                int shift = p - 1 - k;
+                uint32_t n = static_cast< uint32_t >( scale10( d, shift ) + 0.5 );
+                int e = k;
+
+                // Rounded up to the next power of ten
+                if( n >= POW10_U32[ p ] )
+                {
+                    n /= 10;
+                    --shift;
+                    ++e;
+                }
+
+                best = n;
+                exponent = e;
+
+                if( static_cast< float >( scale10( n, -shift ) ) == value )
+                    break;
+            }
+
+            while( best != 0 && best % 10 == 0 )
+                best /= 10;
+
+            return best;
+        }
+    }
+
+    /**
+     * @brief Formats text into a fixed buffer that is written out in one go
+     *
+     * @details Nothing is allocated. With a sink the buffer is flushed when
+     *          it fills and by flush(). Without one the text stays in the
+     *          buffer and what doesn't fit is counted but dropped, like
+     *          snprintf. Every call returns the formatter so they chain
+     *
+     *          char line[ 128 ];
+     *          print::Formatter out( line, sizeof( line ), print::to( Serial ) );
+     *          out.text( "alt " ).fixed( altitude, 1 ).text( " m" ).line().flush();
+     */
+    class Formatter
+    {
+    public:
+        /**
+         * @brief Format into a buffer and keep the text there
+         *
+         * @param buf Buffer, one byte is kept for the terminator
+         * @param size Size of buf
+         */
+        Formatter( char* buf, size_t size )
+            : Formatter( buf, size, Sink{ NULL, NULL, -1 } ) {}
+
+        /**
+         * @brief Format into a buffer and write it to a sink
+         *
+         * @param buf Buffer, one byte is kept for the terminator
+         * @param size Size of buf
+         * @param sink Where the text goes, see to()
+         */
+        Formatter( char* buf, size_t size, Sink sink )
+            : m_buf( buf ), m_size( size ), m_used( 0 ), m_length( 0 ), m_dropped( false ),
+              m_sink( sink ), m_width( 0 ), m_align( Align::Right ) {}
+
+        /**
+         * @brief Text in the buffer, terminated
+         */
+        const char* c_str( void )
+        {
+            if( m_size > 0 )
+                m_buf[ m_used ] = '\0';
+            return m_buf;
+        }
+
+        /**
+         * @brief Characters in the buffer waiting for a flush
+         */
+        size_t size( void ) const { return m_used; }
+
+        /**
+         * @brief Characters formatted since construction or clear(), including
+         *        any that were dropped
+         */
+        size_t length( void ) const { return m_length; }
+
+        /**
+         * @brief Check if text was dropped because there was no room or the sink failed
+         */
+        bool truncated( void ) const { return m_dropped; }
+
+        /**
+         * @brief Forget the buffered text
+         */
+        Formatter& clear( void )
+        {
+            m_used = 0;
+            m_length = 0;
+            m_dropped = false;
+            return *this;
+        }
+
+        /**
+         * @brief Write the buffer to the sink in one call
+         *
+         * @return true if everything was written
+         */
+        bool flush( void )
+        {
+            if( m_sink.write == NULL || m_used == 0 )
+                return m_sink.write != NULL;
+
+            bool ok = m_sink.write( m_sink, m_buf, m_used ) == m_used;
+            m_dropped |= !ok;
+            m_used = 0;
+            return ok;
+        }
+
+        /**
+         * @brief Pad the next value to a width
+         *
+         * @param width Minimum characters
+         * @param align Side the value sits on
+         */
+        Formatter& width( uint8_t width, Align align = Align::Right )
+        {
+            m_width = width;
+            m_align = align;
+            return *this;
+        }
+
+        /**
+         * @brief Add one character
+         */
+        Formatter& put( char c )
+        {
+            if( m_used + 1 >= m_size )
+                flush();
+
+            if( m_used + 1 < m_size )
+                m_buf[ m_used++ ] = c;
+            else
+                m_dropped = true;
+
+            ++m_length;
+            return *this;
+        }
+
+        /**
+         * @brief Add a character several times
+         */
+        Formatter& repeat( char c, size_t count )
+        {
+            while( count-- > 0 )
+                put( c );
+            return *this;
+        }
+
+        /**
+         * @brief Add a line break
+         */
+        Formatter& line( void ) { return put( '\n' ); }
+
+        /**
+         * @brief Add text
+         */
+        Formatter& text( const char* s )
+        {
+            return emit( s, strlen( s ) );
+        }
+
+        /**
+         * @brief Add an integer in decimal
+         */
+        template< typename I >
+        Formatter& number( I value )
+        {
+            char tmp[ 21 ];
+            char* end = tmp + sizeof( tmp );
+            bool negative = static_cast< I >( -1 ) < static_cast< I >( 0 ) && static_cast< int64_t >( value ) < 0;
+            size_t n;
+
+            // Stay in 32 bits where the value fits, boards divide 64 bits slowly
+            if( sizeof( I ) <= 4 )
+            {
+                uint32_t magnitude = static_cast< uint32_t >( value );
+                n = detail::digits( negative ? 0u - magnitude : magnitude, end );
+            }
+            else
+            {
+                uint64_t magnitude = static_cast< uint64_t >( value );
+                n = detail::digits( negative ? 0u - magnitude : magnitude, end );
+            }
+
+            if( negative )
+                *( end - ++n ) = '-';
+
+            return emit( end - n, n );
+        }
+
+        /**
+         * @brief Add an unsigned value in upper case hex
+         *
+         * @param value Value to write
+         * @param digits Digits to write with leading zeros, 0 for as few as needed
+         */
+        Formatter& hex( uint32_t value, uint8_t digits = 0 )
+        {
+            static const char HEX_DIGITS[] = "0123456789ABCDEF";
+            char tmp[ 8 ];
+            size_t n = 0;
+
+            do
+            {
+                tmp[ 7 - n++ ] = HEX_DIGITS[ value & 0x0F ];
+                value >>= 4;
+            } while( value != 0 && n < 8 );
+
+            while( n < digits && n < 8 )
+                tmp[ 7 - n++ ] = '0';
+
+            return emit( tmp + 8 - n, n );
+        }
+
+        /**
+         * @brief Add a float with the fewest digits that read back as the same value
+         *
+         * @details Plain notation from 1e-5 to 1e9, scientific with a two
+         *          digit exponent like printf outside it. Writes nan, inf and
+         *          -inf for those values
+         */
+        Formatter& real( float value )
+        {
+            char tmp[ 24 ];
+            size_t n = 0;
+
+            if( special( value, tmp, n ) )
+                return emit( tmp, n );
+
+            if( value < 0.0f )
+            {
+                tmp[ n++ ] = '-';
+                value = -value;
+            }
+
+            if( value == 0.0f )
+            {
+                tmp[ n++ ] = '0';
+                return emit( tmp, n );
+            }
+
+            int exponent;
+            char digits[ 10 ];
+            uint32_t significant = detail::shortest( value, exponent );
+            size_t count = detail::digits( significant, digits + sizeof( digits ) );
+            const char* d = digits + sizeof( digits ) - count;
+
+            if( exponent >= -5 && exponent < 9 )
+            {
+                if( exponent < 0 )
+                {
+                    tmp[ n++ ] = '0';
+                    tmp[ n++ ] = '.';
+                    for( int i = -1; i > exponent; --i )
+                        tmp[ n++ ] = '0';
+                    for( size_t i = 0; i < count; ++i )
+                        tmp[ n++ ] = d[ i ];
+                }
+                else
+                {
+                    for( int i = 0; i <= exponent; ++i )
+                        tmp[ n++ ] = static_cast< size_t >( i ) < count ? d[ i ] : '0';
+                    if( count > static_cast< size_t >( exponent ) + 1 )
+                    {
+                        tmp[ n++ ] = '.';
+                        for( size_t i = exponent + 1; i < count; ++i )
+                            tmp[ n++ ] = d[ i ];
+                    }
+                }
+            }
+            else
+            {
+                tmp[ n++ ] = d[ 0 ];
+                if( count > 1 )
+                {
+                    tmp[ n++ ] = '.';
+                    for( size_t i = 1; i < count; ++i )
+                        tmp[ n++ ] = d[ i ];
+                }
+
+                tmp[ n++ ] = 'e';
+                tmp[ n++ ] = exponent < 0 ? '-' : '+';
+                int e = exponent < 0 ? -exponent : exponent;
+                tmp[ n++ ] = static_cast< char >( '0' + e / 10 );
+                tmp[ n++ ] = static_cast< char >( '0' + e % 10 );
+            }
+
+            return emit( tmp, n );
+        }
+
+        /**
+         * @brief Add a float with a fixed number of decimals, rounded half away from zero
+         *
+         * @details Done in integers, falls back to real() for values too
+         *          large for 64 bits once scaled
+         *
+         * @param value Value to write
+         * @param decimals Digits after the point, up to 9
+         */
+        Formatter& fixed( float value, uint8_t decimals )
+        {
+            char tmp[ 32 ];
+            size_t n = 0;
+
+            if( decimals > 9 )
+                decimals = 9;
+
+            if( special( value, tmp, n ) )
+                return emit( tmp, n );
+
+            double scaled = fabs( static_cast< double >( value ) ) * detail::POW10[ decimals ] + 0.5;
+            if( scaled >= 1.8e19 )
+                return real( value );
+
+            uint64_t counts = static_cast< uint64_t >( scaled );
+            uint64_t whole = counts / detail::POW10_U32[ decimals ];
+            uint32_t part = static_cast< uint32_t >( counts % detail::POW10_U32[ decimals ] );
+            char* end = tmp + sizeof( tmp );
+
+            if( decimals > 0 )
+            {
+                for( uint8_t i = 0; i < decimals; ++i, part /= 10 )
+                    *--end = static_cast< char >( '0' + part % 10 );
+                *--end = '.';
+            }
+
+            end -= detail::digits( whole, end );
+            if( value < 0.0f && counts != 0 )
+                *--end = '-';
+
+            return emit( end, tmp + sizeof( tmp ) - end );
+        }
+
+        /**
+         * @brief Add a hex dump, 16 bytes a line like hexdump -C
+         *
+         * @details 00000010  0a 01 02 00 00 00 00 00  00 00 80 3f 0f        |...........?.|
+         *
+         * @param data Bytes to dump
+         * @param len Number of bytes
+         * @param address Address printed for the first byte
+         */
+        Formatter& hex_dump( const void* data, size_t len, uint32_t address = 0 )
+        {
+            static const char HEX_DIGITS[] = "0123456789abcdef";
+            const uint8_t* bytes = static_cast< const uint8_t* >( data );
+
+            for( size_t row = 0; row < len; row += 16 )
+            {
+                hex( address + static_cast< uint32_t >( row ), 8 );
+                put( ' ' );
+
+                for( size_t i = row; i < row + 16; ++i )
+                {
+                    put( ' ' );
+                    if( i < len )
+                    {
+                        put( HEX_DIGITS[ bytes[ i ] >> 4 ] );
+                        put( HEX_DIGITS[ bytes[ i ] & 0x0F ] );
+                    }
+                    else
+                        repeat( ' ', 2 );
+                    if( i == row + 7 )
+                        put( ' ' );
+                }
+
+                text( "  |" );
+                for( size_t i = row; i < row + 16 && i < len; ++i )
+                    put( bytes[ i ] >= 0x20 && bytes[ i ] < 0x7F ? static_cast< char >( bytes[ i ] ) : '.' );
+                put( '|' ).line();
+            }
+
+            return *this;
+        }
+
+    private:
+        /**
+         * @brief Add characters with the pending width applied
+         */
+        Formatter& emit( const char* s, size_t n )
+        {
+            size_t pad = m_width > n ? m_width - n : 0;
+            m_width = 0;
+
+            if( m_align == Align::Right )
+                repeat( ' ', pad );
+            while( n-- > 0 )
+                put( *s++ );
+            if( m_align == Align::Left )
+                repeat( ' ', pad );
+
+            return *this;
+        }
+
+        /**
+         * @brief Write nan and inf
+         *
+         * @return true if the value was one of them
+         */
+        static bool special( float value, char* tmp, size_t& n )
+        {
+            const char* s = NULL;
+
+            if( value != value )
+                s = "nan";
+            else if( value > 3.4028235e38f )
+                s = "inf";
+            else if( value < -3.4028235e38f )
+                s = "-inf";
+            else
+                return false;
+
+            n = strlen( s );
+            memcpy( tmp, s, n );
+            return true;
+        }
+
+        char* m_buf;            // Caller's buffer
+        size_t m_size;          // Size of the buffer including the terminator
+        size_t m_used;          // Characters in the buffer
+        size_t m_length;        // Characters formatted
+        bool m_dropped;         // Something didn't fit or wasn't written
+        Sink m_sink;            // Where flush writes
+        uint8_t m_width;        // Width of the next value
+        Align m_align;          // Alignment of the next value
+    };
+
+    /**
+     * @brief Column of a table
+     */
+    struct Column
+    {
+        const char* title;  // Header text
+        uint8_t width;      // Characters, values are right aligned in it
+        int8_t decimals;    // Decimals for floats, -1 for the shortest exact form
+    };
+
+    /**
+     * @brief Fixed width table written through a formatter
+     *
+     * @details Columns are separated by a space. Rows take one value per
+     *          column, floats follow the column's decimals
+     *
+     *          const print::Column cols[] = { { "t", 8, -1 }, { "alt", 7, 1 } };
+     *          print::Table< 2 > table( out, cols );
+     *          table.header();
+     *          table.row( time, altitude );
+     *
+     * @tparam N Number of columns
+     */
+    template< size_t N >
+    class Table
+    {
+    public:
+        /**
+         * @brief Construct a table
+         *
+         * @param out Formatter to write to
+         * @param columns Layout of the columns, must outlive the table
+         */
+        Table( Formatter& out, const Column ( &columns )[ N ] ) : m_out( out ), m_columns( columns ) {}
+
+        /**
+         * @brief Write the titles and a rule under them
+         */
+        void header( void )
+        {
+            for( size_t i = 0; i < N; ++i )
+                separate( i ).width( m_columns[ i ].width ).text( m_columns[ i ].title );
+            m_out.line();
+
+            for( size_t i = 0; i < N; ++i )
+                separate( i ).repeat( '-', m_columns[ i ].width );
+            m_out.line();
+        }
+
+        /**
+         * @brief Write one row
+         *
+         * @param values One value per column
+         */
+        template< typename... Vs >
+        void row( const Vs&... values )
+        {
+            static_assert( sizeof...( Vs ) == N, "A row needs one value per column" );
+
+            size_t i = 0;
+            int expand[] = { 0, ( cell( i, values ), ++i, 0 )... };
+            (void) expand;
+            m_out.line();
+        }
+
+    private:
+        Formatter& separate( size_t i ) { return i > 0 ? m_out.put( ' ' ) : m_out; }
+
+        template< typename V >
+        void cell( size_t i, const V& value ) { separate( i ).width( m_columns[ i ].width ).number( value ); }
+
+        void cell( size_t i, const char* value ) { separate( i ).width( m_columns[ i ].width ).text( value ); }
+
+        void cell( size_t i, double value ) { cell( i, static_cast< float >( value ) ); }
+
+        void cell( size_t i, float value )
+        {
+            Formatter& out = separate( i ).width( m_columns[ i ].width );
+
+            if( m_columns[ i ].decimals < 0 )
+                out.real( value );
+            else
+                out.fixed( value, static_cast< uint8_t >( m_columns[ i ].decimals ) );
+        }
+
+        Formatter& m_out;               // Where rows go
+        const Column* m_columns;        // Layout
+    };
+} // End of namespace print
+
+/*! @} End of Doxygen Groups*/
+
+} // End of namespace aero
+
+/*! @} End of Doxygen Groups*/
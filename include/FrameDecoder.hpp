@@ -0,0 +1,255 @@
+#pragma once
+
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    #include "Arduino.h"
+#else
+    #include <cstddef>
+    #include <cstdint>
+    #include <cstring>
+#endif
+
+#include "Message.hpp"
+
+/*!
+ *  \addtogroup aero
+ *  @{
+ */
+
+//! Aero library code
+namespace aero
+{
+
+/**
+ * @brief Incremental frame decoder for byte streams
+ *
+ * @details Bytes can be fed in chunks of any size. Frames that arrive whole
+ *          inside one chunk are validated in place without being copied,
+ *          only a frame split across chunks is buffered until it completes.
+ *          The frame length comes from the header so frames of any schema
+ *          can share a stream. After a bad frame the decoder restarts at the
+ *          next start byte after the false one, and implausible headers are
+ *          rejected after six bytes, so resynchronizing stays linear in
+ *          practice. All state is in the object so each port gets its own
+ */
+class FrameDecoder
+{
+public:
+    /**
+     * @brief Called for every valid frame. The view is only valid during the call
+     *
+     * @param frame View of the valid frame
+     * @param context Pointer given to the constructor
+     */
+    typedef void ( *Callback )( const MessageView& frame, void* context );
+
+    /**
+     * @brief Constructor
+     *
+     * @param callback Function called for every valid frame
+     * @param context Passed through to the callback
+     */
+    explicit FrameDecoder( Callback callback = NULL, void* context = NULL )
+        : m_callback( callback ), m_context( context ), m_have( 0 ), m_size( 0 ),
+          m_frames( 0 ), m_dropped( 0 ) {}
+
+    /**
+     * @brief Decode a chunk of bytes from the stream
+     *
+     * @param data Bytes received
+     * @param len Number of bytes received
+     * @return size_t Number of valid frames found and passed to the callback
+     */
+    size_t feed( const uint8_t* data, size_t len )
+    {
+        size_t found = 0;
+
+        while( len > 0 )
+        {
+            // Continue a frame that was split across chunks
+            if( m_have > 0 )
+            {
+                size_t want = ( m_size == 0 ? def::HEADER_SIZE : m_size ) - m_have;
+                size_t n = want < len ? want : len;
+
+                memcpy( m_buf + m_have, data, n );
+                m_have += n;
+                data += n;
+                len -= n;
+
+                found += settle();
+                continue;
+            }
+
+            // Skip to the next start byte
+            const uint8_t* start = static_cast< const uint8_t* >( memchr( data, def::START_BYTE, len ) );
+
+            if( start == NULL )
+            {
+                m_dropped += len;
+                break;
+            }
+
+            m_dropped += start - data;
+            len -= start - data;
+            data = start;
+
+            // Frame is whole in this chunk so validate it where it is
+            if( len >= def::HEADER_SIZE )
+            {
+                size_t size = frame_size( data );
+
+                if( size == 0 )
+                {
+                    ++m_dropped;
+                    ++data;
+                    --len;
+                    continue;
+                }
+
+                if( len >= size )
+                {
+                    if( emit( MessageView( data, size ) ) )
+                    {
+                        ++found;
+                        data += size;
+                        len -= size;
+                    }
+                    else
+                    {
+                        ++m_dropped;
+                        ++data;
+                        --len;
+                    }
+                    continue;
+                }
+            }
+
+            // Partial frame at the end of the chunk
+            memcpy( m_buf, data, len );
+            m_have = len;
+            found += settle();
+            break;
+        }
+
+        return found;
+    }
+
+    /**
+     * @brief Drop any partially received frame
+     */
+    void reset( void )
+    {
+        m_dropped += m_have;
+        m_have = 0;
+        m_size = 0;
+    }
+
+    /**
+     * @brief Number of valid frames decoded
+     */
+    uint32_t frames( void ) const { return m_frames; }
+
+    /**
+     * @brief Number of bytes discarded while searching for frames
+     */
+    uint32_t dropped( void ) const { return m_dropped; }
+
+    /**
+     * @brief Number of bytes of a partial frame currently buffered
+     */
+    size_t pending( void ) const { return m_have; }
+
+private:
+    /**
+     * @brief Frame size from a header
+     *
+     * @param header At least HEADER_SIZE bytes starting with the start byte
+     * @return size_t Frame size in bytes or 0 if the header can't be right
+     */
+    static size_t frame_size( const uint8_t* header )
+    {
+        uint16_t signature = def::load_u16( header + 2 );
+        uint16_t length = def::load_u16( header + 4 );
+
+        if( !def::plausible( signature, length ) )
+            return 0;
+
+        return def::frame_size( signature, length );
+    }
+
+    /**
+     * @brief Pass a frame to the callback if it is valid
+     */
+    bool emit( const MessageView& view )
+    {
+        if( !view.valid() )
+            return false;
+
+        ++m_frames;
+
+        if( m_callback != NULL )
+            m_callback( view, m_context );
+
+        return true;
+    }
+
+    /**
+     * @brief Act on the buffered bytes until more input is needed
+     *
+     * @details On a bad header or frame the buffer is shifted to the next
+     *          start byte after the current one and checked again
+     *
+     * @return size_t Number of valid frames found
+     */
+    size_t settle( void )
+    {
+        size_t found = 0;
+
+        while( m_have >= def::HEADER_SIZE )
+        {
+            if( m_size == 0 )
+                m_size = frame_size( m_buf );
+
+            if( m_size != 0 && m_have < m_size )
+                break;
+
+            if( m_size != 0 && emit( MessageView( m_buf, m_size ) ) )
+            {
+                ++found;
+                m_have = 0;
+                m_size = 0;
+                break;
+            }
+
+            resync();
+        }
+
+        return found;
+    }
+
+    /**
+     * @brief Discard the false start byte and move to the next candidate
+     */
+    void resync( void )
+    {
+        const uint8_t* next = static_cast< const uint8_t* >( memchr( m_buf + 1, def::START_BYTE, m_have - 1 ) );
+        size_t skip = next == NULL ? m_have : next - m_buf;
+
+        memmove( m_buf, m_buf + skip, m_have - skip );
+        m_have -= skip;
+        m_size = 0;
+        m_dropped += skip;
+    }
+
+    Callback m_callback;                    // Called for each valid frame
+    void* m_context;                        // User pointer for the callback
+    uint8_t m_buf[ def::MAX_FRAME_SIZE ];   // Partial frame split across chunks
+    size_t m_have;                          // Bytes held in m_buf
+    size_t m_size;                          // Size of the buffered frame, 0 until header is read
+    uint32_t m_frames;                      // Valid frame count
+    uint32_t m_dropped;                     // Discarded byte count
+};
+
+} // End of namespace aero
+
+/*! @} End of Doxygen Groups*/
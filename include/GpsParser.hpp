@@ -0,0 +1,630 @@
+#pragma once
+
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    #include "Arduino.h"
+#else
+    #include <cstddef>
+    #include <cstdint>
+#endif
+
+#include "Data.hpp"
+
+/*!
+ *  \addtogroup aero
+ *  @{
+ */
+
+//! Aero library code
+namespace aero
+{
+
+/**
+ * @brief Incremental GPS parser for NMEA GGA and RMC and u-blox UBX NAV-PVT
+ *
+ * @details Bytes can be fed in chunks of any size, split anywhere, and both
+ *          protocols can share a stream. Each byte is looked at once: NMEA
+ *          fields are turned into fixed point numbers as their digits
+ *          arrive and the checksums are kept as the bytes go by, so there
+ *          is no line buffer, no strtok and no atof. Only the 92 byte
+ *          NAV-PVT payload is held until its checksum arrives. Values reach
+ *          data() only from messages whose checksum matched
+ *
+ *          Units follow the rest of the library: lat and lon in degrees,
+ *          south and west negative, speed in m/s, altitude above mean sea
+ *          level in m. time is hhmmsscc and date ddmmyy, both UTC. HDOP is
+ *          in hundredths and quality is the GGA fix quality, NAV-PVT fixes
+ *          are mapped onto it. NAV-PVT has no HDOP so leaves it as it was.
+ *          Empty fields, as sent before a fix, leave their values as well
+ *
+ *          NMEA fractions past 5 digits are dropped, that is 2 cm of
+ *          latitude and keeps ddmm.mmmmm in 32 bits
+ *
+ *          In a GPS sensor's update():
+ *
+ *              size_t n = serial.read( buffer, sizeof( buffer ) );
+ *              if( m_parser.feed( buffer, n ) > 0 )
+ *              {
+ *                  m_data = m_parser.data();
+ *                  publish();
+ *              }
+ */
+class GpsParser
+{
+public:
+    /**
+     * @brief Message types that update the data
+     */
+    enum Message : uint8_t
+    {
+        GGA,
+        RMC,
+        NAV_PVT
+    };
+
+    /**
+     * @brief Called for every message applied to the data
+     *
+     * @param data Data with the message applied
+     * @param message Type of the message
+     * @param context Pointer given to the constructor
+     */
+    typedef void ( *Callback )( const def::GPS_t& data, Message message, void* context );
+
+    /**
+     * @brief Constructor
+     *
+     * @param callback Function called for every message applied
+     * @param context Passed through to the callback
+     */
+    explicit GpsParser( Callback callback = NULL, void* context = NULL )
+        : m_callback( callback ), m_context( context ), m_data(), m_pending(),
+          m_messages( 0 ), m_errors( 0 )
+    {
+        reset();
+    }
+
+    /**
+     * @brief Parse a chunk of bytes from the stream
+     *
+     * @param data Bytes received
+     * @param len Number of bytes received
+     * @return size_t Number of messages applied to the data
+     */
+    size_t feed( const uint8_t* data, size_t len )
+    {
+        const uint8_t* end = data + len;
+        size_t applied = 0;
+
+        while( data < end )
+        {
+            // Most bytes between messages belong to sentences nobody asked for
+            if( m_state == IDLE )
+            {
+                while( data < end && *data != '$' && *data != UBX_SYNC1 )
+                    ++data;
+                if( data == end )
+                    break;
+            }
+
+            // A whole UBX payload at once
+            if( m_state == UBX_PAYLOAD )
+            {
+                size_t n = static_cast< size_t >( end - data );
+                size_t left = static_cast< size_t >( m_length - m_have );
+                if( n > left )
+                    n = left;
+
+                for( const uint8_t* stop = data + n; data < stop; ++data )
+                {
+                    if( m_pvt )
+                        m_payload[ m_have ] = *data;
+                    ++m_have;
+                    m_ck_a = static_cast< uint8_t >( m_ck_a + *data );
+                    m_ck_b = static_cast< uint8_t >( m_ck_b + m_ck_a );
+                }
+
+                if( m_have == m_length )
+                    m_state = UBX_CK_A;
+                continue;
+            }
+
+            applied += step( *data++ );
+        }
+
+        return applied;
+    }
+
+    /**
+     * @brief Drop any partially received message
+     */
+    void reset( void )
+    {
+        m_state = IDLE;
+    }
+
+    /**
+     * @brief Data from every message applied so far
+     */
+    const def::GPS_t& data( void ) const { return m_data; }
+
+    /**
+     * @brief Number of messages applied to the data
+     */
+    uint32_t messages( void ) const { return m_messages; }
+
+    /**
+     * @brief Number of GGA, RMC and UBX messages dropped for a bad checksum,
+     *        length or character
+     */
+    uint32_t errors( void ) const { return m_errors; }
+
+private:
+    enum State : uint8_t
+    {
+        IDLE,
+        NMEA_BODY,      // Between $ and *
+        NMEA_SUM_HI,    // Checksum digits
+        NMEA_SUM_LO,
+        UBX_SYNC2,      // Second sync byte
+        UBX_HEADER,     // Class, id and length
+        UBX_PAYLOAD,
+        UBX_CK_A,       // Checksum bytes
+        UBX_CK_B
+    };
+
+    static const uint8_t NMEA_MAX_LENGTH = 82;      // Longest sentence the standard allows
+    static const uint8_t MAX_DECIMALS = 5;          // Fraction digits kept
+    static const uint8_t UBX_SYNC1 = 0xB5;
+    static const uint8_t UBX_SYNC2_BYTE = 0x62;
+    static const uint8_t NAV_CLASS = 0x01;
+    static const uint8_t PVT_ID = 0x07;
+    static const uint16_t PVT_LENGTH = 92;
+    static const uint16_t UBX_MAX_LENGTH = 2048;    // Longer is taken as a false sync
+
+    /**
+     * @brief Advance the state machine by one byte
+     *
+     * @return size_t 1 if a message was applied
+     */
+    size_t step( uint8_t c )
+    {
+        switch( m_state )
+        {
+        case IDLE:
+            if( c == '$' )
+                start_nmea();
+            else if( c == UBX_SYNC1 )
+                m_state = UBX_SYNC2;
+            return 0;
+
+        case NMEA_BODY:
+            if( c == '$' )
+            {
+                fail();
+                start_nmea();
+            }
+            else if( c == '*' )
+            {
+                end_field();
+                if( m_state == NMEA_BODY )
+                    m_state = NMEA_SUM_HI;
+            }
+            else if( c < ' ' || c > '~' || ++m_count > NMEA_MAX_LENGTH )
+            {
+                // The byte may start a UBX frame cutting the sentence short
+                fail();
+                return step( c );
+            }
+            else
+            {
+                m_sum ^= c;
+                if( c == ',' )
+                    end_field();
+                else
+                    field_char( c );
+            }
+            return 0;
+
+        case NMEA_SUM_HI:
+        case NMEA_SUM_LO:
+        {
+            int expected = m_state == NMEA_SUM_HI ? m_sum >> 4 : m_sum & 0x0F;
+            if( hex( c ) != expected )
+            {
+                fail();
+                return step( c );
+            }
+            if( m_state == NMEA_SUM_HI )
+            {
+                m_state = NMEA_SUM_LO;
+                return 0;
+            }
+
+            m_state = IDLE;
+            m_data = m_pending;
+            return apply( m_message );
+        }
+
+        case UBX_SYNC2:
+            if( c == UBX_SYNC2_BYTE )
+            {
+                m_state = UBX_HEADER;
+                m_have = 0;
+                m_ck_a = m_ck_b = 0;
+            }
+            else
+            {
+                m_state = IDLE;
+                step( c );
+            }
+            return 0;
+
+        case UBX_HEADER:
+            m_header[ m_have++ ] = c;
+            m_ck_a = static_cast< uint8_t >( m_ck_a + c );
+            m_ck_b = static_cast< uint8_t >( m_ck_b + m_ck_a );
+            if( m_have < 4 )
+                return 0;
+
+            m_length = static_cast< uint16_t >( m_header[ 2 ] | ( m_header[ 3 ] << 8 ) );
+            m_pvt = m_header[ 0 ] == NAV_CLASS && m_header[ 1 ] == PVT_ID;
+            m_have = 0;
+
+            if( m_length > UBX_MAX_LENGTH || ( m_pvt && m_length != PVT_LENGTH ) )
+                fail();
+            else
+                m_state = m_length == 0 ? UBX_CK_A : UBX_PAYLOAD;
+            return 0;
+
+        case UBX_CK_A:
+            if( c != m_ck_a )
+                fail();
+            else
+                m_state = UBX_CK_B;
+            return 0;
+
+        case UBX_CK_B:
+            if( c != m_ck_b )
+            {
+                fail();
+                return 0;
+            }
+
+            m_state = IDLE;
+            if( !m_pvt )
+                return 0;
+
+            apply_pvt();
+            return apply( NAV_PVT );
+
+        default:
+            m_state = IDLE;
+            return 0;
+        }
+    }
+
+    /**
+     * @brief Count a message and pass it to the callback
+     */
+    size_t apply( Message message )
+    {
+        ++m_messages;
+        if( m_callback != NULL )
+            m_callback( m_data, message, m_context );
+        return 1;
+    }
+
+    /**
+     * @brief Count a broken message and look for the next one
+     */
+    void fail( void )
+    {
+        ++m_errors;
+        m_state = IDLE;
+    }
+
+    static int hex( uint8_t c )
+    {
+        if( c >= '0' && c <= '9' )
+            return c - '0';
+        if( c >= 'A' && c <= 'F' )
+            return c - 'A' + 10;
+        if( c >= 'a' && c <= 'f' )
+            return c - 'a' + 10;
+        return -1;
+    }
+
+    static uint32_t pow10( uint8_t n )
+    {
+        uint32_t value = 1;
+        while( n-- > 0 )
+            value *= 10;
+        return value;
+    }
+
+    /*
+     * NMEA fields
+     */
+
+    void start_nmea( void )
+    {
+        m_state = NMEA_BODY;
+        m_sum = 0;
+        m_count = 0;
+        m_field = 0;
+        m_address = 0;
+        m_latitude = m_longitude = false;
+        start_field();
+    }
+
+    void start_field( void )
+    {
+        m_mantissa = 0;
+        m_decimals = 0;
+        m_digits = 0;
+        m_first = 0;
+        m_point = false;
+        m_negative = false;
+        m_overflow = false;
+    }
+
+    void field_char( uint8_t c )
+    {
+        if( m_first == 0 )
+            m_first = c;
+
+        if( m_field == 0 )
+        {
+            m_address = ( m_address << 8 ) | c;
+        }
+        else if( c >= '0' && c <= '9' )
+        {
+            if( m_point && m_decimals == MAX_DECIMALS )
+                return;
+            if( m_mantissa > ( UINT32_MAX - 9 ) / 10 )
+                m_overflow = true;
+
+            m_mantissa = m_mantissa * 10 + ( c - '0' );
+            m_decimals = static_cast< uint8_t >( m_decimals + m_point );
+            ++m_digits;
+        }
+        else if( c == '.' )
+            m_point = true;
+        else if( c == '-' && m_first == c )
+            m_negative = true;
+    }
+
+    bool number( void ) const { return m_digits > 0 && !m_overflow; }
+
+    /**
+     * @brief Field value in units of 10^-n, n at most 2 for the fields here
+     */
+    uint32_t scaled( uint8_t n ) const
+    {
+        return m_decimals <= n ? m_mantissa * pow10( static_cast< uint8_t >( n - m_decimals ) )
+                               : m_mantissa / pow10( static_cast< uint8_t >( m_decimals - n ) );
+    }
+
+    float value( void ) const
+    {
+        uint32_t scale = pow10( m_decimals );
+        float v = static_cast< float >( m_mantissa / scale ) + static_cast< float >( m_mantissa % scale ) / scale;
+        return m_negative ? -v : v;
+    }
+
+    /**
+     * @brief Degrees from ddmm.mmmmm or dddmm.mmmmm
+     */
+    float degrees( void ) const
+    {
+        uint32_t scale = pow10( m_decimals );
+        uint32_t minutes = m_mantissa % ( 100 * scale );
+        return static_cast< float >( m_mantissa / ( 100 * scale ) ) + static_cast< float >( minutes ) / ( 60.0f * scale );
+    }
+
+    /**
+     * @brief Store a finished field in the pending data
+     */
+    void end_field( void )
+    {
+        if( m_field == 0 )
+        {
+            // Any talker, only the sentence type matters
+            switch( m_address & 0xFFFFFF )
+            {
+            case 0x474741:  m_message = GGA; break;    // "GGA"
+            case 0x524D43:  m_message = RMC; break;    // "RMC"
+            default:        m_state = IDLE; return;
+            }
+            m_pending = m_data;
+        }
+        else if( m_message == GGA )
+            gga_field();
+        else
+            rmc_field();
+
+        ++m_field;
+        start_field();
+    }
+
+    void gga_field( void )
+    {
+        switch( m_field )
+        {
+        case 1: time_field(); break;
+        case 2: latitude_field(); break;
+        case 3: hemisphere_field( m_latitude, 'S', m_pending.lat ); break;
+        case 4: longitude_field(); break;
+        case 5: hemisphere_field( m_longitude, 'W', m_pending.lon ); break;
+        case 6:
+            if( number() )
+            {
+                m_pending.quality = scaled( 0 );
+                m_pending.fix = m_pending.quality > 0;
+            }
+            break;
+        case 7:
+            if( number() )
+                m_pending.satellites = scaled( 0 );
+            break;
+        case 8:
+            if( number() )
+                m_pending.HDOP = scaled( 2 );
+            break;
+        case 9:
+            if( number() )
+                m_pending.altitude = value();
+            break;
+        default: break;
+        }
+    }
+
+    void rmc_field( void )
+    {
+        switch( m_field )
+        {
+        case 1: time_field(); break;
+        case 2:
+            if( m_first != 0 )
+                m_pending.fix = m_first == 'A';
+            break;
+        case 3: latitude_field(); break;
+        case 4: hemisphere_field( m_latitude, 'S', m_pending.lat ); break;
+        case 5: longitude_field(); break;
+        case 6: hemisphere_field( m_longitude, 'W', m_pending.lon ); break;
+        case 7:
+            if( number() )
+                m_pending.speed = value() * 0.514444f;     // Knots
+            break;
+        case 9:
+            if( number() )
+                m_pending.date = scaled( 0 );
+            break;
+        case 12:
+            // Mode indicator, N is no fix whatever the status said
+            if( m_first == 'N' )
+                m_pending.fix = false;
+            break;
+        default: break;
+        }
+    }
+
+    void time_field( void )
+    {
+        if( number() )
+            m_pending.time = scaled( 2 );
+    }
+
+    void latitude_field( void )
+    {
+        m_latitude = number();
+        if( m_latitude )
+            m_pending.lat = degrees();
+    }
+
+    void longitude_field( void )
+    {
+        m_longitude = number();
+        if( m_longitude )
+            m_pending.lon = degrees();
+    }
+
+    /**
+     * @brief Make the coordinate from this sentence negative for S or W
+     */
+    void hemisphere_field( bool present, uint8_t negative, float& coordinate )
+    {
+        if( present && m_first == negative )
+            coordinate = -coordinate;
+    }
+
+    /*
+     * UBX NAV-PVT
+     */
+
+    static uint16_t u16( const uint8_t* p )
+    {
+        return static_cast< uint16_t >( p[ 0 ] | ( p[ 1 ] << 8 ) );
+    }
+
+    static int32_t i32( const uint8_t* p )
+    {
+        return static_cast< int32_t >( static_cast< uint32_t >( u16( p ) ) | ( static_cast< uint32_t >( u16( p + 2 ) ) << 16 ) );
+    }
+
+    static float e7( int32_t value )
+    {
+        return static_cast< float >( value / 10000000 ) + static_cast< float >( value % 10000000 ) * 1e-7f;
+    }
+
+    void apply_pvt( void )
+    {
+        const uint8_t* p = m_payload;
+        uint8_t valid = p[ 11 ], type = p[ 20 ], flags = p[ 21 ];
+        uint8_t carrier = flags >> 6;
+
+        // 2D, 3D and GNSS with dead reckoning are fixes
+        bool fix = ( flags & 0x01 ) && type >= 2 && type <= 4;
+
+        m_data.fix = fix;
+        m_data.quality = !fix ? 0 : carrier == 2 ? 4 : carrier == 1 ? 5 : ( flags & 0x02 ) ? 2 : 1;
+        m_data.satellites = p[ 23 ];
+
+        if( valid & 0x01 )
+            m_data.date = p[ 7 ] * 10000ul + p[ 6 ] * 100ul + u16( p + 4 ) % 100;
+
+        if( valid & 0x02 )
+        {
+            int32_t nano = i32( p + 16 );
+            m_data.time = p[ 8 ] * 1000000ul + p[ 9 ] * 10000ul + p[ 10 ] * 100ul
+                          + ( nano > 0 ? static_cast< uint32_t >( nano ) / 10000000ul : 0 );
+        }
+
+        if( fix )
+        {
+            m_data.lon = e7( i32( p + 24 ) );
+            m_data.lat = e7( i32( p + 28 ) );
+            m_data.altitude = i32( p + 36 ) * 0.001f;
+            m_data.speed = i32( p + 60 ) * 0.001f;
+        }
+    }
+
+    Callback m_callback;            // Called for each message applied
+    void* m_context;                // User pointer for the callback
+    def::GPS_t m_data;              // Data from checked messages
+    def::GPS_t m_pending;           // Data with the sentence so far applied
+    uint32_t m_messages;            // Applied message count
+    uint32_t m_errors;              // Dropped message count
+    State m_state;
+
+    // NMEA sentence
+    Message m_message;              // Sentence type
+    uint8_t m_sum;                  // XOR of the bytes so far
+    uint8_t m_count;                // Bytes since $
+    uint8_t m_field;                // Field index, 0 is the address
+    uint32_t m_address;             // Last characters of the address
+    bool m_latitude;                // Sentence had a latitude for its hemisphere
+    bool m_longitude;
+
+    // NMEA field
+    uint32_t m_mantissa;            // Digits so far without the point
+    uint8_t m_decimals;             // Digits after the point
+    uint8_t m_digits;               // Digits so far
+    uint8_t m_first;                // First character, 0 while empty
+    bool m_point;                   // Decimal point seen
+    bool m_negative;                // Leading minus
+    bool m_overflow;                // Too many digits for 32 bits
+
+    // UBX message
+    uint8_t m_header[ 4 ];          // Class, id and length
+    uint16_t m_length;              // Payload length
+    uint16_t m_have;                // Header or payload bytes so far
+    uint8_t m_ck_a;                 // Fletcher checksum so far
+    uint8_t m_ck_b;
+    bool m_pvt;                     // Message is NAV-PVT
+    uint8_t m_payload[ PVT_LENGTH ];
+};
+
+} // End of namespace aero
+
+/*! @} End of Doxygen Groups*/
@@ -0,0 +1,649 @@
+#pragma once
+
+// Logs are written and read on a POSIX host, the boards only produce frames
+#if !defined(ARDUINO) && !defined(CORE_TEENSY)
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "Message.hpp"
+
+/*!
+ *  \addtogroup aero
+ *  @{
+ */
+
+//! Aero library code
+namespace aero
+{
+
+/*
+    Log file layout, all values little endian
+
+    | header | records ... | index blocks ... |
+
+    Each record is a receive timestamp in microseconds, the frame size and
+    the frame exactly as received
+
+    | time u64 | size u16 | frame |
+
+    Every block_records records the writer adds an index block with the
+    offset of the first record, the time range and the OR of the signature
+    bits of the frames in it. A reader skips whole blocks that can't match
+    a query. The index is written when the log is closed. A log that was
+    never closed still reads, the index is rebuilt from data_end
+*/
+
+//! Log file format
+namespace logfile
+{
+    const uint64_t MAGIC = 0x31474F4C4F524541ULL;   // "AEROLOG1"
+    const uint32_t VERSION = 1;
+    const size_t RECORD_SIZE = 10;                  // Record header before the frame
+
+    /**
+     * @brief Start of the file
+     */
+    struct Header
+    {
+        uint64_t magic;             // MAGIC
+        uint32_t version;           // VERSION
+        uint32_t block_records;     // Records per index block
+        uint64_t data_end;          // Offset just past the last record
+        uint64_t index_offset;      // Offset of the index, 0 if the log was not closed
+        uint64_t index_count;       // Number of index blocks
+    };
+
+    /**
+     * @brief Index entry for a run of records
+     */
+    struct Block
+    {
+        uint64_t offset;            // First record
+        uint64_t first;             // Earliest timestamp
+        uint64_t last;              // Latest timestamp
+        uint32_t count;             // Number of records
+        uint16_t signatures;        // OR of the segment bits
+        uint16_t reserved;
+    };
+
+    static_assert( sizeof( Header ) == 40 && sizeof( Block ) == 32, "Log structures must not be padded" );
+
+    /**
+     * @brief Swap a header between host order and file order, either way
+     */
+    inline void byte_order( Header& header )
+    {
+        header.magic = bit::to_little_endian( header.magic );
+        header.version = bit::to_little_endian( header.version );
+        header.block_records = bit::to_little_endian( header.block_records );
+        header.data_end = bit::to_little_endian( header.data_end );
+        header.index_offset = bit::to_little_endian( header.index_offset );
+        header.index_count = bit::to_little_endian( header.index_count );
+    }
+
+    /**
+     * @brief Swap an index block between host order and file order, either way
+     */
+    inline void byte_order( Block& block )
+    {
+        block.offset = bit::to_little_endian( block.offset );
+        block.first = bit::to_little_endian( block.first );
+        block.last = bit::to_little_endian( block.last );
+        block.count = bit::to_little_endian( block.count );
+        block.signatures = bit::to_little_endian( block.signatures );
+        block.reserved = bit::to_little_endian( block.reserved );
+    }
+
+    /**
+     * @brief Write a value in file order
+     */
+    template< typename T >
+    inline void store( uint8_t* at, T value )
+    {
+        value = bit::to_little_endian( value );
+        memcpy( at, &value, sizeof( value ) );
+    }
+
+    /**
+     * @brief Read a value stored in file order
+     */
+    template< typename T >
+    inline T load( const uint8_t* at )
+    {
+        T value;
+        memcpy( &value, at, sizeof( value ) );
+        return bit::from_little_endian( value );
+    }
+} // End of namespace logfile
+
+/**
+ * @brief Append-only frame log written through a memory map
+ *
+ * @details A fixed window of the file is mapped once and the file is
+ *          preallocated inside it, so append() is a copy into memory and never
+ *          waits on the disk. Dirty pages are handed to the kernel with
+ *          msync( MS_ASYNC ) every sync_bytes, which starts the write back
+ *          without blocking. The file only grows in reserve(), which belongs on
+ *          a housekeeping thread or between bursts. append() fails if the
+ *          preallocated space runs out before reserve() is called
+ */
+class LogWriter
+{
+public:
+    //! Mapped address space, a log can not grow past it
+    static const size_t WINDOW = sizeof( void* ) >= 8 ? (size_t) 1 << 36 : (size_t) 1 << 30;
+
+    /**
+     * @brief Constructor
+     *
+     * @param reserve Bytes preallocated at a time
+     * @param sync_bytes Bytes appended between msync calls
+     * @param block_records Records per index block
+     */
+    explicit LogWriter( size_t reserve = 64 << 20, size_t sync_bytes = 1 << 20, uint32_t block_records = 256 )
+        : m_reserve( reserve ), m_sync_bytes( sync_bytes ), m_block_records( block_records ),
+          m_fd( -1 ), m_map( NULL ), m_capacity( 0 ), m_end( 0 ), m_synced( 0 )
+    {
+        memset( &m_block, 0, sizeof( m_block ) );
+    }
+
+    /**
+     * @brief Destructor. Closes the log and writes the index
+     */
+    ~LogWriter( ) { close(); }
+
+    LogWriter( const LogWriter& ) = delete;
+    LogWriter& operator=( const LogWriter& ) = delete;
+
+    /**
+     * @brief Create a log, replacing any file at the path
+     *
+     * @param path File to write
+     * @return true if the log is ready
+     */
+    bool open( const char* path )
+    {
+        close();
+
+        m_fd = ::open( path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644 );
+        if( m_fd < 0 )
+            return false;
+
+        m_end = sizeof( logfile::Header );
+        m_synced = 0;
+        m_blocks.clear();
+        memset( &m_block, 0, sizeof( m_block ) );
+
+        void* map = mmap( NULL, WINDOW, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0 );
+        if( map == MAP_FAILED )
+        {
+            abandon();
+            return false;
+        }
+
+        m_map = static_cast< uint8_t* >( map );
+
+        if( !extend( m_reserve ) )
+        {
+            abandon();
+            return false;
+        }
+
+        logfile::Header header = { logfile::MAGIC, logfile::VERSION, m_block_records, m_end, 0, 0 };
+        logfile::byte_order( header );
+        memcpy( m_map, &header, sizeof( header ) );
+
+        return true;
+    }
+
+    /**
+     * @brief Add a frame
+     *
+     * @param frame Valid frame to store
+     * @param time_us Receive time in microseconds
+     * @return true if stored, false if the frame is invalid or the
+     *         preallocated space is full
+     */
+    bool append( const MessageView& frame, uint64_t time_us )
+    {
+        if( m_map == NULL || !frame.valid() )
+            return false;
+
+        const uint16_t size = static_cast< uint16_t >( frame.size() );
+        const size_t need = logfile::RECORD_SIZE + size;
+
+        if( m_end + need > __atomic_load_n( &m_capacity, __ATOMIC_ACQUIRE ) )
+            return false;
+
+        uint8_t* record = m_map + m_end;
+        logfile::store( record, time_us );
+        logfile::store( record + 8, size );
+        memcpy( record + logfile::RECORD_SIZE, frame.data(), size );
+
+        if( m_block.count == 0 )
+        {
+            m_block.offset = m_end;
+            m_block.first = time_us;
+            m_block.last = time_us;
+        }
+
+        m_block.first = time_us < m_block.first ? time_us : m_block.first;
+        m_block.last = time_us > m_block.last ? time_us : m_block.last;
+        m_block.signatures |= frame.signature();
+
+        if( ++m_block.count == m_block_records )
+            finish_block();
+
+        // Readers of a log that is still open stop at data_end
+        __atomic_store_n( &m_end, m_end + need, __ATOMIC_RELEASE );
+        logfile::store< uint64_t >( m_map + offsetof( logfile::Header, data_end ), m_end );
+
+        if( m_end - m_synced >= m_sync_bytes )
+            sync();
+
+        return true;
+    }
+
+    /**
+     * @brief Preallocate another reserve once less than half of one is left
+     *
+     * @details This is the only call that waits on the disk. It may run on a
+     *          housekeeping thread while another thread appends, but not
+     *          alongside open() or close()
+     *
+     * @return true if there is at least half a reserve free
+     */
+    bool reserve( void )
+    {
+        if( m_map == NULL )
+            return false;
+
+        const size_t capacity = __atomic_load_n( &m_capacity, __ATOMIC_RELAXED );
+        const uint64_t end = __atomic_load_n( &m_end, __ATOMIC_ACQUIRE );
+
+        return capacity - end >= m_reserve / 2 || extend( capacity + m_reserve );
+    }
+
+    /**
+     * @brief Start writing everything appended so far to disk without waiting
+     */
+    void sync( void )
+    {
+        if( m_map == NULL )
+            return;
+
+        // msync needs a page aligned start
+        size_t page = sysconf( _SC_PAGESIZE );
+        size_t start = m_synced / page * page;
+
+        msync( m_map + start, m_end - start, MS_ASYNC );
+        m_synced = m_end;
+    }
+
+    /**
+     * @brief Write the index, trim the preallocated space and close the file
+     *
+     * @return true if the log was closed cleanly
+     */
+    bool close( void )
+    {
+        if( m_map == NULL )
+            return false;
+
+        if( m_block.count > 0 )
+            finish_block();
+
+        const size_t index_size = m_blocks.size() * sizeof( logfile::Block );
+        const uint64_t index_offset = ( m_end + 7 ) & ~(uint64_t) 7;
+        bool ok = index_offset + index_size <= m_capacity || extend( index_offset + index_size );
+
+        if( ok )
+        {
+            for( size_t b = 0; b < m_blocks.size(); ++b )
+            {
+                logfile::Block block = m_blocks[ b ];
+                logfile::byte_order( block );
+                memcpy( m_map + index_offset + b * sizeof( block ), &block, sizeof( block ) );
+            }
+
+            logfile::store( m_map + offsetof( logfile::Header, index_offset ), index_offset );
+            logfile::store< uint64_t >( m_map + offsetof( logfile::Header, index_count ), m_blocks.size() );
+
+            ok = msync( m_map, index_offset + index_size, MS_SYNC ) == 0;
+            ok = ftruncate( m_fd, index_offset + index_size ) == 0 && ok;
+        }
+
+        abandon();
+        return ok;
+    }
+
+    /**
+     * @brief Bytes used by records so far
+     */
+    uint64_t size( void ) const { return m_end; }
+
+    /**
+     * @brief Check if a log is open
+     */
+    bool is_open( void ) const { return m_map != NULL; }
+
+private:
+    /**
+     * @brief Close the map and file without writing the index
+     */
+    void abandon( void )
+    {
+        if( m_map != NULL )
+            munmap( m_map, WINDOW );
+
+        if( m_fd >= 0 )
+            ::close( m_fd );
+
+        m_map = NULL;
+        m_fd = -1;
+        m_capacity = 0;
+    }
+
+    /**
+     * @brief Close the current index block
+     */
+    void finish_block( void )
+    {
+        m_blocks.push_back( m_block );
+        memset( &m_block, 0, sizeof( m_block ) );
+    }
+
+    /**
+     * @brief Preallocate the file up to capacity inside the mapped window
+     */
+    bool extend( size_t capacity )
+    {
+        if( capacity > WINDOW )
+            return false;
+
+        // Allocating now avoids a SIGBUS when the disk fills during a flight
+        int err = posix_fallocate( m_fd, 0, capacity );
+        if( err == EOPNOTSUPP || err == EINVAL )
+            err = ftruncate( m_fd, capacity ) == 0 ? 0 : errno;
+        if( err != 0 )
+            return false;
+
+        // The space is allocated before append() can see it
+        __atomic_store_n( &m_capacity, capacity, __ATOMIC_RELEASE );
+        return true;
+    }
+
+    size_t m_reserve;                       // Bytes preallocated at a time
+    size_t m_sync_bytes;                    // Bytes between msync calls
+    uint32_t m_block_records;               // Records per index block
+    int m_fd;                               // Log file
+    uint8_t* m_map;                         // Mapped file
+    size_t m_capacity;                      // Preallocated size
+    uint64_t m_end;                         // End of the last record
+    uint64_t m_synced;                      // End of the last msync
+    logfile::Block m_block;                 // Block being filled
+    std::vector< logfile::Block > m_blocks; // Finished blocks
+};
+
+/**
+ * @brief Reads a log written by LogWriter
+ *
+ * @details The file is mapped read only and frames are handed out in place
+ */
+class LogReader
+{
+public:
+    /**
+     * @brief Called for every matching record. The view is valid while the reader is open
+     *
+     * @param time_us Receive time in microseconds
+     * @param frame Stored frame
+     * @param context Pointer given to query
+     */
+    typedef void ( *Callback )( uint64_t time_us, const MessageView& frame, void* context );
+
+    /**
+     * @brief Constructor
+     */
+    LogReader( ) : m_map( NULL ), m_size( 0 ), m_records( 0 ) {}
+
+    /**
+     * @brief Destructor
+     */
+    ~LogReader( ) { close(); }
+
+    LogReader( const LogReader& ) = delete;
+    LogReader& operator=( const LogReader& ) = delete;
+
+    /**
+     * @brief Open a log
+     *
+     * @param path File to read
+     * @return true if the file is a log
+     */
+    bool open( const char* path )
+    {
+        close();
+
+        int fd = ::open( path, O_RDONLY | O_CLOEXEC );
+        if( fd < 0 )
+            return false;
+
+        struct stat st;
+        if( fstat( fd, &st ) == 0 && (size_t) st.st_size >= sizeof( logfile::Header ) )
+        {
+            void* map = mmap( NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+            if( map != MAP_FAILED )
+            {
+                m_map = static_cast< const uint8_t* >( map );
+                m_size = st.st_size;
+            }
+        }
+
+        ::close( fd );
+
+        if( m_map == NULL )
+            return false;
+
+        memcpy( &m_header, m_map, sizeof( m_header ) );
+        logfile::byte_order( m_header );
+        if( m_header.magic != logfile::MAGIC || m_header.version != logfile::VERSION || m_header.data_end > m_size )
+        {
+            close();
+            return false;
+        }
+
+        load_index();
+        return true;
+    }
+
+    /**
+     * @brief Close the log
+     */
+    void close( void )
+    {
+        if( m_map != NULL )
+            munmap( const_cast< uint8_t* >( m_map ), m_size );
+
+        m_map = NULL;
+        m_size = 0;
+        m_records = 0;
+        m_blocks.clear();
+    }
+
+    /**
+     * @brief Find records by time and segment
+     *
+     * @param from_us Earliest receive time
+     * @param to_us Latest receive time
+     * @param segments Signature bits, a record matches if it has any of
+     *        them. 0 matches every record
+     * @param callback Called for each match in file order
+     * @param context Passed through to the callback
+     * @return size_t Number of matching records
+     */
+    size_t query( uint64_t from_us, uint64_t to_us, uint16_t segments, Callback callback, void* context ) const
+    {
+        size_t found = 0;
+
+        for( size_t b = 0; b < m_blocks.size(); ++b )
+        {
+            const logfile::Block& block = m_blocks[ b ];
+
+            if( block.last < from_us || block.first > to_us || ( segments != 0 && ( block.signatures & segments ) == 0 ) )
+                continue;
+
+            uint64_t offset = block.offset;
+
+            // A count that runs past data_end stops at the last whole record
+            for( uint32_t r = 0; r < block.count && fits( offset ); ++r )
+            {
+                uint64_t time_us;
+                uint16_t size;
+                MessageView frame = record( offset, time_us, size );
+
+                if( time_us >= from_us && time_us <= to_us && ( segments == 0 || ( frame.signature() & segments ) != 0 ) )
+                {
+                    if( callback != NULL )
+                        callback( time_us, frame, context );
+                    ++found;
+                }
+
+                offset += logfile::RECORD_SIZE + size;
+            }
+        }
+
+        return found;
+    }
+
+    /**
+     * @brief Number of records in the log
+     */
+    size_t records( void ) const { return m_records; }
+
+    /**
+     * @brief Number of index blocks
+     */
+    size_t blocks( void ) const { return m_blocks.size(); }
+
+    /**
+     * @brief Check if the log was closed and its index was used
+     */
+    bool indexed( void ) const { return m_header.index_offset != 0; }
+
+private:
+    /**
+     * @brief Check the whole record at an offset lies before data_end
+     */
+    bool fits( uint64_t offset ) const
+    {
+        if( offset < sizeof( logfile::Header ) || offset + logfile::RECORD_SIZE > m_header.data_end )
+            return false;
+
+        const uint16_t size = logfile::load< uint16_t >( m_map + offset + 8 );
+
+        return offset + logfile::RECORD_SIZE + size <= m_header.data_end;
+    }
+
+    /**
+     * @brief Read the record at an offset that fits()
+     */
+    MessageView record( uint64_t offset, uint64_t& time_us, uint16_t& size ) const
+    {
+        time_us = logfile::load< uint64_t >( m_map + offset );
+        size = logfile::load< uint16_t >( m_map + offset + 8 );
+
+        return MessageView( m_map + offset + logfile::RECORD_SIZE, size );
+    }
+
+    /**
+     * @brief Use the stored index or rebuild it for a log that wasn't closed
+     *        or whose index points outside the records
+     */
+    void load_index( void )
+    {
+        const uint64_t index_end = m_header.index_offset + m_header.index_count * sizeof( logfile::Block );
+        bool valid = m_header.index_offset >= m_header.data_end && index_end <= m_size &&
+                     m_header.index_count <= m_size / sizeof( logfile::Block );
+
+        if( valid )
+        {
+            m_blocks.resize( m_header.index_count );
+            if( m_header.index_count > 0 )
+                memcpy( m_blocks.data(), m_map + m_header.index_offset, index_end - m_header.index_offset );
+
+            for( size_t b = 0; b < m_blocks.size() && valid; ++b )
+            {
+                logfile::byte_order( m_blocks[ b ] );
+                valid = m_blocks[ b ].offset >= sizeof( logfile::Header ) && m_blocks[ b ].offset < m_header.data_end;
+                m_records += m_blocks[ b ].count;
+            }
+
+            if( valid )
+                return;
+
+            m_blocks.clear();
+            m_records = 0;
+        }
+
+        m_header.index_offset = 0;
+
+        const uint32_t per_block = m_header.block_records > 0 ? m_header.block_records : 256;
+        uint64_t offset = sizeof( logfile::Header );
+        logfile::Block block;
+        memset( &block, 0, sizeof( block ) );
+
+        // Stop at the first record that is cut short or damaged
+        while( fits( offset ) )
+        {
+            uint64_t time_us;
+            uint16_t size;
+            MessageView frame = record( offset, time_us, size );
+            if( !frame.valid() )
+                break;
+
+            if( block.count == 0 )
+            {
+                block.offset = offset;
+                block.first = time_us;
+                block.last = time_us;
+            }
+
+            block.first = time_us < block.first ? time_us : block.first;
+            block.last = time_us > block.last ? time_us : block.last;
+            block.signatures |= frame.signature();
+
+            if( ++block.count == per_block )
+            {
+                m_blocks.push_back( block );
+                memset( &block, 0, sizeof( block ) );
+            }
+
+            ++m_records;
+            offset += logfile::RECORD_SIZE + size;
+        }
+
+        if( block.count > 0 )
+            m_blocks.push_back( block );
+    }
+
+    const uint8_t* m_map;                   // Mapped file
+    size_t m_size;                          // File size
+    size_t m_records;                       // Records in the log
+    logfile::Header m_header;               // Copy of the header
+    std::vector< logfile::Block > m_blocks; // Index
+};
+
+} // End of namespace aero
+
+/*! @} End of Doxygen Groups*/
+
+#endif
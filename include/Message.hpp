@@ -5,13 +5,482 @@
     #include "Arduino.h"
 #else
     #include <cstddef>
+    #include <cstdint>
+    #include <cstring>
 #endif
 
 #include "Data.hpp"
+#include "Crc.hpp"
+#include "Utility.hpp"
 
+/*!
+ *  \addtogroup aero
+ *  @{
+ */
+
+//! Aero library code
 namespace aero
 {
 
+/*!
+ *  \addtogroup def
+ *  @{
+ */
+
+//! Definitions for the library such as usable structs, constants, etc
+namespace def
+{
+
+/*
+    Frame layout on the wire. Segments are packed into the payload in
+    ascending signature bit order, each one sizeof( struct ) bytes long
+
+    | start | link | signature | length | payload  |  crc  | end |
+    |   1   |  1   |     2     |   2    | length   | 2 / 4 |  1  |
+
+    The crc covers link through the last payload byte and is stored least
+    significant byte first. It is a CRC-16/CCITT unless CRC32_FLAG is set
+    in the signature, then it is a CRC-32C
+
+    Every multi-byte value is little endian (bit::WIRE_ORDER), including
+    the segment fields. Little endian hosts copy structs as they are, a
+    big endian host converts them with reflect::to_little_endian
+*/
+
+// Frame delimiters
+const uint8_t START_BYTE = 0x0A;
+const uint8_t END_BYTE   = 0x0F;
+
+// Signature bit set when the frame carries a CRC-32C instead of a CRC-16
+const uint16_t CRC32_FLAG = 1 << 15;
+
+// Signature bit set when the payload is delta encoded against earlier
+// frames, see DeltaDecoder. The segment bits still say what it decodes to
+const uint16_t DELTA_FLAG = 1 << 14;
+
+// Integrity check used for frames built on this target. Define AERO_CRC32
+// for links between hosts, receivers accept either
+#if defined(AERO_CRC32)
+const uint16_t INTEGRITY = CRC32_FLAG;
+#else
+const uint16_t INTEGRITY = 0;
+#endif
+
+// Frame sizes in bytes
+const size_t HEADER_SIZE      = 6;
+const size_t MAX_FOOTER_SIZE  = 5;
+const size_t MAX_PAYLOAD_SIZE = 256;
+const size_t MAX_FRAME_SIZE   = HEADER_SIZE + MAX_PAYLOAD_SIZE + MAX_FOOTER_SIZE;
+
+/**
+ * @brief Devices that can send or receive a message. The link byte holds
+ *        the sender in the high nibble and the receiver in the low nibble
+ */
+enum class ID : uint8_t { Gnd = 0, Plane, G1, G2 };
+
+/**
+ * @brief Bit position of each segment in the message signature
+ */
+enum class Signature : uint8_t
+{
+    Pitot = 0,
+    IMU,
+    GPS,
+    Enviro,
+    Battery,
+    Config,
+    Status,
+    Servos,
+    AirData,
+    Commands,
+    DropAlgo,
+    IMUCompact,
+    GPSCompact,
+    Count       // Number of segments, not a segment
+};
+
+// Size of each segment indexed by signature bit. Unused bits are zero
+constexpr uint16_t SEGMENT_SIZE[ 16 ] =
+{
+    sizeof( Pitot_t ),
+    sizeof( IMU_t ),
+    sizeof( GPS_t ),
+    sizeof( Enviro_t ),
+    sizeof( Battery_t ),
+    sizeof( SystemConfig_t ),
+    sizeof( Status_t ),
+    sizeof( Servos_t ),
+    sizeof( AirData_t ),
+    sizeof( Commands_t ),
+    sizeof( DropAlgo_t ),
+    sizeof( IMUCompact_t ),
+    sizeof( GPSCompact_t ),
+    0, 0, 0
+};
+
+// Signature bits that have a segment defined
+const uint16_t SIGNATURE_MASK = ( 1 << static_cast< int >( Signature::Count ) ) - 1;
+
+// Signature bits that describe the frame instead of a segment
+const uint16_t FLAG_MASK = CRC32_FLAG | DELTA_FLAG;
+
+/**
+ * @brief Maps a segment struct to its signature bit. Only specialized for
+ *        the structs that can be sent in a message
+ *
+ * @tparam T segment struct
+ */
+template< typename T > struct Segment;
+
+template<> struct Segment< Pitot_t >        { static constexpr Signature signature = Signature::Pitot; };
+template<> struct Segment< IMU_t >          { static constexpr Signature signature = Signature::IMU; };
+template<> struct Segment< GPS_t >          { static constexpr Signature signature = Signature::GPS; };
+template<> struct Segment< Enviro_t >       { static constexpr Signature signature = Signature::Enviro; };
+template<> struct Segment< Battery_t >      { static constexpr Signature signature = Signature::Battery; };
+template<> struct Segment< SystemConfig_t > { static constexpr Signature signature = Signature::Config; };
+template<> struct Segment< Status_t >       { static constexpr Signature signature = Signature::Status; };
+template<> struct Segment< Servos_t >       { static constexpr Signature signature = Signature::Servos; };
+template<> struct Segment< AirData_t >      { static constexpr Signature signature = Signature::AirData; };
+template<> struct Segment< Commands_t >     { static constexpr Signature signature = Signature::Commands; };
+template<> struct Segment< DropAlgo_t >     { static constexpr Signature signature = Signature::DropAlgo; };
+template<> struct Segment< IMUCompact_t >   { static constexpr Signature signature = Signature::IMUCompact; };
+template<> struct Segment< GPSCompact_t >   { static constexpr Signature signature = Signature::GPSCompact; };
+
+/**
+ * @brief Storage for a complete frame. The crc and end byte follow
+ *        directly after the last payload byte, not at the end of buffer
+ */
+struct RawMessage_t
+{
+    uint8_t start;                                      // Start byte
+    uint8_t link;                                       // Sender and receiver IDs
+    uint16_t signature;                                 // Bit field of segments in the payload
+    uint16_t length;                                    // Number of payload bytes
+    uint8_t buffer[ MAX_PAYLOAD_SIZE + MAX_FOOTER_SIZE ];   // Payload, crc and end byte
+};
+
+/**
+ * @brief Read a 16 bit header field stored in wire order
+ *
+ * @param src First byte of the field, no alignment needed
+ * @return uint16_t Value in host order
+ */
+inline uint16_t load_u16( const uint8_t* src )
+{
+    uint16_t value;
+    memcpy( &value, src, sizeof( value ) );
+    return bit::from_little_endian( value );
+}
+
+/**
+ * @brief Write a 16 bit header field in wire order
+ *
+ * @param dest First byte of the field, no alignment needed
+ * @param value Value in host order
+ */
+inline void store_u16( uint8_t* dest, uint16_t value )
+{
+    value = bit::to_little_endian( value );
+    memcpy( dest, &value, sizeof( value ) );
+}
+
+/**
+ * @brief Build the link byte for a message
+ *
+ * @param from Sender of the message
+ * @param to Receiver of the message
+ * @return uint8_t Link byte
+ */
+constexpr uint8_t link( ID from, ID to )
+{
+    return static_cast< uint8_t >( ( static_cast< uint8_t >( from ) << 4 ) | static_cast< uint8_t >( to ) );
+}
+
+/**
+ * @brief Payload length of a message with the given signature
+ *
+ * @param signature Signature bit field
+ * @return size_t Sum of the sizes of all segments in signature
+ */
+inline size_t payload_size( uint16_t signature )
+{
+    size_t size = 0;
+
+    for( ; signature != 0; signature &= signature - 1 )
+        size += SEGMENT_SIZE[ __builtin_ctz( signature ) ];
+
+    return size;
+}
+
+/**
+ * @brief Offset of a segment inside the payload of a message
+ *
+ * @details Only segments in lower signature bits come before the segment so
+ *          this is the payload size of the signature masked below the bit
+ *
+ * @param signature Signature bit field
+ * @param segment Segment to find
+ * @return size_t Byte offset of segment from start of payload
+ */
+inline size_t segment_offset( uint16_t signature, Signature segment )
+{
+    return payload_size( signature & ( ( 1u << static_cast< int >( segment ) ) - 1 ) );
+}
+
+/**
+ * @brief Check if a header could belong to a real frame
+ *
+ * @param signature Signature bit field including flags
+ * @param length Payload length
+ * @return true if the signature only has known bits and the length fits it
+ */
+inline bool plausible( uint16_t signature, uint16_t length )
+{
+    if( length > MAX_PAYLOAD_SIZE || ( signature & ~( SIGNATURE_MASK | FLAG_MASK ) ) != 0 )
+        return false;
+
+    // Delta encoded payloads have no fixed length
+    return ( signature & DELTA_FLAG ) != 0 || length == payload_size( signature );
+}
+
+/**
+ * @brief Size of the crc and end byte of a frame
+ *
+ * @param signature Signature bit field including flags
+ * @return size_t Footer size in bytes
+ */
+constexpr size_t footer_size( uint16_t signature )
+{
+    return ( ( signature & CRC32_FLAG ) ? 4 : 2 ) + 1;
+}
+
+/**
+ * @brief Total size of a frame
+ *
+ * @param signature Signature bit field including flags
+ * @param length Payload length
+ * @return size_t Frame size in bytes
+ */
+constexpr size_t frame_size( uint16_t signature, size_t length )
+{
+    return HEADER_SIZE + length + footer_size( signature );
+}
+
+/**
+ * @brief Integrity check of a frame
+ *
+ * @param frame Pointer to the start byte
+ * @param signature Signature bit field including flags
+ * @param length Payload length
+ * @return uint32_t CRC-16 or CRC-32C of link through payload
+ */
+inline uint32_t frame_crc( const uint8_t* frame, uint16_t signature, size_t length )
+{
+    if( signature & CRC32_FLAG )
+        return crc::crc32c( frame + 1, HEADER_SIZE - 1 + length );
+
+    return crc::crc16( frame + 1, HEADER_SIZE - 1 + length );
+}
+
+/**
+ * @brief Write the crc and end byte after the payload of a frame
+ *
+ * @param frame Pointer to the start byte of a frame with header and payload filled
+ * @param signature Signature bit field including flags
+ * @param length Payload length
+ */
+inline void seal( uint8_t* frame, uint16_t signature, size_t length )
+{
+    uint32_t crc = frame_crc( frame, signature, length );
+    uint8_t* footer = frame + HEADER_SIZE + length;
+    size_t crc_size = footer_size( signature ) - 1;
+
+    for( size_t i = 0; i < crc_size; ++i, crc >>= 8 )
+        footer[ i ] = static_cast< uint8_t >( crc & 0xFF );
+
+    footer[ crc_size ] = END_BYTE;
+}
+
+/**
+ * @brief Check the crc and end byte after the payload of a frame
+ *
+ * @param frame Pointer to the start byte of a whole frame
+ * @param signature Signature bit field including flags
+ * @param length Payload length
+ * @return true if the frame is intact
+ * @return false if it was corrupted
+ */
+inline bool sealed( const uint8_t* frame, uint16_t signature, size_t length )
+{
+    const uint8_t* footer = frame + HEADER_SIZE + length;
+    size_t crc_size = footer_size( signature ) - 1;
+
+    if( footer[ crc_size ] != END_BYTE )
+        return false;
+
+    uint32_t crc = 0;
+    for( size_t i = crc_size; i > 0; --i )
+        crc = ( crc << 8 ) | footer[ i - 1 ];
+
+    return crc == frame_crc( frame, signature, length );
+}
+
+} // End of namespace def
+
+/*! @} End of Doxygen Groups*/
+
+/**
+ * @brief Non-owning, read only view of a frame inside a receive buffer
+ *
+ * @details The frame is validated once on construction. Segments are
+ *          accessed in place by computing their offset from the signature,
+ *          nothing is copied. The buffer must outlive the view
+ */
+class MessageView
+{
+public:
+    /**
+     * @brief Construct a view and validate the frame
+     *
+     * @param buf Pointer to the start byte of a frame
+     * @param len Number of readable bytes in buf. Can be more than the frame
+     */
+    MessageView( const uint8_t* buf, size_t len )
+        : m_buf( buf ), m_signature( 0 ), m_length( 0 ), m_valid( false )
+    {
+        if( buf == NULL || len < def::HEADER_SIZE || buf[ 0 ] != def::START_BYTE )
+            return;
+
+        m_signature = def::load_u16( buf + 2 );
+        m_length = def::load_u16( buf + 4 );
+
+        // Reject unknown segments or a length that doesn't match them
+        if( !def::plausible( m_signature, m_length ) || len < size() )
+            return;
+
+        m_valid = def::sealed( buf, m_signature, m_length );
+    }
+
+    /**
+     * @brief Construct a view of a frame held in a RawMessage_t
+     *
+     * @param message Frame storage
+     */
+    explicit MessageView( const def::RawMessage_t& message )
+        : MessageView( reinterpret_cast< const uint8_t* >( &message ), sizeof( message ) ) {}
+
+    /**
+     * @brief Check if the frame passed validation
+     *
+     * @return true if the frame is complete and the crc matches
+     * @return false if the frame can't be used
+     */
+    bool valid( void ) const { return m_valid; }
+
+    /**
+     * @brief Total size of the frame in bytes including header and footer
+     */
+    size_t size( void ) const { return def::frame_size( m_signature, m_length ); }
+
+    /**
+     * @brief Signature bit field of the segments in the frame
+     */
+    uint16_t signature( void ) const { return m_signature & def::SIGNATURE_MASK; }
+
+    /**
+     * @brief Signature bits that describe the frame such as def::CRC32_FLAG
+     */
+    uint16_t flags( void ) const { return m_signature & def::FLAG_MASK; }
+
+    /**
+     * @brief Check if the payload is delta encoded. Segments of a delta
+     *        frame can only be read after DeltaDecoder restores it
+     */
+    bool delta( void ) const { return ( m_signature & def::DELTA_FLAG ) != 0; }
+
+    /**
+     * @brief Number of payload bytes in the frame
+     */
+    uint16_t length( void ) const { return m_length; }
+
+    /**
+     * @brief Sender of the frame
+     */
+    def::ID from( void ) const { return static_cast< def::ID >( m_buf[ 1 ] >> 4 ); }
+
+    /**
+     * @brief Receiver of the frame
+     */
+    def::ID to( void ) const { return static_cast< def::ID >( m_buf[ 1 ] & 0x0F ); }
+
+    /**
+     * @brief Pointer to the start byte of the frame
+     */
+    const uint8_t* data( void ) const { return m_buf; }
+
+    /**
+     * @brief Pointer to the first payload byte
+     */
+    const uint8_t* payload( void ) const { return m_buf + def::HEADER_SIZE; }
+
+    /**
+     * @brief Check if a segment is in a valid frame
+     *
+     * @param segment Segment to look for
+     * @return true if the frame is valid, not delta encoded and contains the segment
+     */
+    bool has( def::Signature segment ) const
+    {
+        return m_valid && !delta() && ( ( m_signature >> static_cast< int >( segment ) ) & 0x01 );
+    }
+
+    /**
+     * @brief Get a pointer to a segment's bytes inside the frame
+     *
+     * @param segment Segment to find
+     * @return const uint8_t* Start of the segment or NULL if it isn't in the frame
+     */
+    const uint8_t* segment( def::Signature segment ) const
+    {
+        if( !has( segment ) )
+            return NULL;
+
+        return payload() + def::segment_offset( m_signature, segment );
+    }
+
+    /**
+     * @brief Copy a segment out of the frame
+     *
+     * @details Segments are packed so they are rarely aligned for T. Copying
+     *          is the only safe typed access on cores that fault on
+     *          unaligned loads, segment() gives the bytes in place
+     *
+     * @tparam T Segment struct such as def::IMU_t
+     * @param out Struct to copy the segment into
+     * @return true if the segment was in the frame and copied
+     * @return false if the segment was not in the frame. out is unchanged
+     */
+    template< typename T >
+    bool copy( T& out ) const
+    {
+        const uint8_t* src = segment( def::Segment< T >::signature );
+
+        if( src == NULL )
+            return false;
+
+        memcpy( &out, src, sizeof( T ) );
+        return true;
+    }
+
+private:
+    const uint8_t* m_buf;   // Start of the frame
+    uint16_t m_signature;   // Cached signature
+    uint16_t m_length;      // Cached payload length
+    bool m_valid;           // Result of validation
+};
+
 } // End of namespace aero
 
-#endif // MESSAGE_HPP
\ No newline at end of file
+/*! @} End of Doxygen Groups*/
+
+#endif // MESSAGE_HPP
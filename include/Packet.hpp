@@ -0,0 +1,210 @@
+#pragma once
+
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    #include "Arduino.h"
+#else
+    #include <cstddef>
+    #include <cstdint>
+    #include <cstring>
+#endif
+
+#include "Message.hpp"
+#include "FrameDecoder.hpp"
+#include "Sensors.hpp"
+
+/*!
+ *  \addtogroup aero
+ *  @{
+ */
+
+//! Aero library code
+namespace aero
+{
+
+/*!
+ *  \addtogroup def
+ *  @{
+ */
+
+//! Definitions for the library such as usable structs, constants, etc
+namespace def
+{
+    // Largest packet sensor::Radio::send can take
+    const size_t MAX_PACKET_SIZE = 255;
+}
+
+/*! @} End of Doxygen Groups*/
+
+/**
+ * @brief Packs several small frames into one radio packet
+ *
+ * @details Frames are stored back to back and stay complete, so every
+ *          frame keeps its own crc and a receiver that doesn't know about
+ *          packets can still decode them as a stream. Sending one packet
+ *          instead of several pays the radio preamble and turnaround once
+ *
+ * @tparam Capacity Largest packet in bytes
+ */
+template< size_t Capacity = def::MAX_PACKET_SIZE >
+class PacketAggregator
+{
+public:
+    static_assert( Capacity <= def::MAX_PACKET_SIZE, "Radio packets are limited to 255 bytes" );
+
+    /**
+     * @brief Constructor
+     */
+    PacketAggregator( ) : m_size( 0 ), m_count( 0 ) {}
+
+    /**
+     * @brief Check if a frame fits in the packet
+     *
+     * @param size Frame size in bytes
+     * @return true if there is room
+     */
+    bool fits( size_t size ) const { return m_size + size <= Capacity; }
+
+    /**
+     * @brief Add a frame to the packet
+     *
+     * @param frame Pointer to the start byte of the frame
+     * @param size Frame size in bytes
+     * @return true if the frame was added
+     * @return false if it doesn't fit. The packet is unchanged
+     */
+    bool add( const uint8_t* frame, size_t size )
+    {
+        if( !fits( size ) )
+            return false;
+
+        memcpy( m_buf + m_size, frame, size );
+        m_size += size;
+        ++m_count;
+
+        return true;
+    }
+
+    /**
+     * @brief Add a valid frame to the packet
+     *
+     * @param frame View of the frame
+     * @return true if the frame was added
+     * @return false if it is invalid or doesn't fit
+     */
+    bool add( const MessageView& frame )
+    {
+        return frame.valid() && add( frame.data(), frame.size() );
+    }
+
+    /**
+     * @brief Add a frame, sending the packet first if the frame doesn't fit
+     *
+     * @param radio Radio to send full packets on
+     * @param frame Pointer to the start byte of the frame
+     * @param size Frame size in bytes
+     * @return true if the frame was added
+     * @return false if the frame is larger than a packet or sending failed
+     */
+    bool add( sensor::Radio& radio, const uint8_t* frame, size_t size )
+    {
+        if( !fits( size ) && !send( radio ) )
+            return false;
+
+        return add( frame, size );
+    }
+
+    /**
+     * @brief Send the packet and start a new one
+     *
+     * @param radio Radio to send on
+     * @return true if the packet was sent or there was nothing to send
+     * @return false if the radio failed. The packet is kept
+     */
+    bool send( sensor::Radio& radio )
+    {
+        if( m_size == 0 )
+            return true;
+
+        if( !radio.send( m_buf, static_cast< uint8_t >( m_size ) ) )
+            return false;
+
+        clear();
+        return true;
+    }
+
+    /**
+     * @brief Drop all frames in the packet
+     */
+    void clear( void )
+    {
+        m_size = 0;
+        m_count = 0;
+    }
+
+    /**
+     * @brief Packet bytes
+     */
+    const uint8_t* data( void ) const { return m_buf; }
+
+    /**
+     * @brief Number of bytes in the packet
+     */
+    size_t size( void ) const { return m_size; }
+
+    /**
+     * @brief Number of frames in the packet
+     */
+    size_t count( void ) const { return m_count; }
+
+    /**
+     * @brief Check if there are no frames in the packet
+     */
+    bool empty( void ) const { return m_count == 0; }
+
+private:
+    uint8_t m_buf[ Capacity ];  // Frames back to back
+    size_t m_size;              // Bytes used
+    size_t m_count;             // Frames held
+};
+
+/**
+ * @brief Split a received packet back into frames
+ *
+ * @details Frames never span packets so no state is kept between calls.
+ *          A damaged frame is skipped by searching for the next start byte
+ *
+ * @param packet Received packet
+ * @param len Packet size in bytes
+ * @param callback Called for every valid frame
+ * @param context Passed through to the callback
+ * @return size_t Number of valid frames found
+ */
+inline size_t split_packet( const uint8_t* packet, size_t len, FrameDecoder::Callback callback, void* context = NULL )
+{
+    size_t found = 0;
+    const uint8_t* end = packet + len;
+
+    while( packet < end )
+    {
+        MessageView frame( packet, end - packet );
+
+        if( frame.valid() )
+        {
+            if( callback != NULL )
+                callback( frame, context );
+
+            ++found;
+            packet += frame.size();
+            continue;
+        }
+
+        const uint8_t* next = static_cast< const uint8_t* >( memchr( packet + 1, def::START_BYTE, end - packet - 1 ) );
+        packet = next == NULL ? end : next;
+    }
+
+    return found;
+}
+
+} // End of namespace aero
+
+/*! @} End of Doxygen Groups*/
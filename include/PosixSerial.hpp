@@ -0,0 +1,433 @@
+#pragma once
+
+// This code should only compile on POSIX hosts, Serial.hpp covers the boards
+#if !defined(ARDUINO) && !defined(CORE_TEENSY)
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+#if defined(__linux__)
+    #include <sys/epoll.h>
+#endif
+
+#include "FrameDecoder.hpp"
+
+/*!
+ *  \addtogroup aero
+ *  @{
+ */
+
+//! Aero library code
+namespace aero
+{
+
+/*!
+ *  \addtogroup serial
+ *  @{
+ */
+
+//! Serial helper functions
+namespace serial
+{
+
+/**
+ * @brief Find the termios constant for a baud rate
+ *
+ * @param baud Baud rate in bits per second
+ * @return speed_t Matching constant or B0 if the rate is not supported
+ */
+inline speed_t baud_constant( uint32_t baud )
+{
+    switch( baud )
+    {
+        case 9600:    return B9600;
+        case 19200:   return B19200;
+        case 38400:   return B38400;
+        case 57600:   return B57600;
+        case 115200:  return B115200;
+        case 230400:  return B230400;
+#if defined(B460800)
+        case 460800:  return B460800;
+#endif
+#if defined(B921600)
+        case 921600:  return B921600;
+#endif
+#if defined(B1000000)
+        case 1000000: return B1000000;
+#endif
+        default:      return B0;
+    }
+}
+
+/**
+ * @brief Nonblocking raw serial port on a POSIX host
+ *
+ * @details Reads and writes never wait. Move whole chunks with read(),
+ *          write() and writev() instead of single bytes, at 921600 baud a
+ *          syscall per byte can't keep up. The port closes the descriptor
+ *          when destroyed
+ */
+class PosixPort
+{
+public:
+    /**
+     * @brief Constructor for a closed port
+     */
+    PosixPort( ) : m_fd( -1 ) {}
+
+    /**
+     * @brief Constructor that takes ownership of an open descriptor, such as
+     *        one end of an openpty() pair. Call configure() to set it up
+     *
+     * @param fd Open terminal descriptor
+     */
+    explicit PosixPort( int fd ) : m_fd( -1 ) { attach( fd ); }
+
+    /**
+     * @brief Destructor
+     */
+    ~PosixPort( ) { close(); }
+
+    PosixPort( const PosixPort& ) = delete;
+    PosixPort& operator=( const PosixPort& ) = delete;
+
+    /**
+     * @brief Open and configure a serial device
+     *
+     * @param path Device such as /dev/ttyACM0
+     * @param baud Baud rate in bits per second
+     * @return true if the port is ready
+     */
+    bool open( const char* path, uint32_t baud )
+    {
+        close();
+
+        m_fd = ::open( path, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC );
+        if( m_fd < 0 )
+            return false;
+
+        if( !configure( baud ) )
+        {
+            close();
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Take ownership of an open descriptor, closing any current one
+     *
+     * @param fd Open terminal descriptor
+     * @return true if the descriptor was switched to nonblocking mode
+     */
+    bool attach( int fd )
+    {
+        close();
+        m_fd = fd;
+
+        int flags = fcntl( m_fd, F_GETFL, 0 );
+        return flags >= 0 && fcntl( m_fd, F_SETFL, flags | O_NONBLOCK ) == 0;
+    }
+
+    /**
+     * @brief Put the port in raw 8N1 mode without flow control
+     *
+     * @details Raw mode matters, the default line discipline would turn
+     *          the 0x0A start byte into a line ending
+     *
+     * @param baud Baud rate in bits per second
+     * @return true if the settings were applied
+     */
+    bool configure( uint32_t baud )
+    {
+        speed_t speed = baud_constant( baud );
+        struct termios tty;
+
+        if( m_fd < 0 || speed == B0 || tcgetattr( m_fd, &tty ) != 0 )
+            return false;
+
+        cfmakeraw( &tty );
+        tty.c_cflag |= CLOCAL | CREAD;
+        tty.c_cflag &= ~( CSTOPB | PARENB );
+#if defined(CRTSCTS)
+        tty.c_cflag &= ~CRTSCTS;
+#endif
+        tty.c_cc[ VMIN ] = 0;
+        tty.c_cc[ VTIME ] = 0;
+
+        if( cfsetispeed( &tty, speed ) != 0 || cfsetospeed( &tty, speed ) != 0 )
+            return false;
+
+        if( tcsetattr( m_fd, TCSANOW, &tty ) != 0 )
+            return false;
+
+        tcflush( m_fd, TCIOFLUSH );
+        return true;
+    }
+
+    /**
+     * @brief Close the port
+     */
+    void close( void )
+    {
+        if( m_fd >= 0 )
+            ::close( m_fd );
+
+        m_fd = -1;
+    }
+
+    /**
+     * @brief Read whatever is waiting
+     *
+     * @param buf Buffer for the bytes
+     * @param len Size of buf
+     * @return ssize_t Bytes read, 0 if nothing is waiting, -1 on error or hangup
+     */
+    ssize_t read( uint8_t* buf, size_t len )
+    {
+        ssize_t n = ::read( m_fd, buf, len );
+
+        if( n < 0 && ( errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ) )
+            return 0;
+
+        // A raw terminal returns 0 when empty, a hangup shows up as EIO
+        return n;
+    }
+
+    /**
+     * @brief Write as much as the driver will take
+     *
+     * @param buf Bytes to write
+     * @param len Number of bytes
+     * @return ssize_t Bytes written, may be short, -1 on error
+     */
+    ssize_t write( const uint8_t* buf, size_t len )
+    {
+        ssize_t n = ::write( m_fd, buf, len );
+
+        if( n < 0 && ( errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ) )
+            return 0;
+
+        return n;
+    }
+
+    /**
+     * @brief Write several buffers in one call, for example a batch of frames
+     *
+     * @param iov Buffers to write
+     * @param count Number of buffers
+     * @return ssize_t Bytes written, may be short, -1 on error
+     */
+    ssize_t writev( const struct iovec* iov, int count )
+    {
+        ssize_t n = ::writev( m_fd, iov, count );
+
+        if( n < 0 && ( errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ) )
+            return 0;
+
+        return n;
+    }
+
+    /**
+     * @brief Check if the port is open
+     */
+    bool is_open( void ) const { return m_fd >= 0; }
+
+    /**
+     * @brief File descriptor for use with poll or epoll
+     */
+    int fd( void ) const { return m_fd; }
+
+private:
+    int m_fd;   // Descriptor, -1 when closed
+};
+
+/**
+ * @brief Feed all bytes waiting on a port into a frame decoder
+ *
+ * @details Same as the board version. Reads in chunks and never waits
+ *
+ * @param port Port to read from
+ * @param frames Decoder that receives the bytes
+ * @return int Number of valid frames decoded, -1 if the port failed
+ */
+inline int read( PosixPort& port, FrameDecoder& frames )
+{
+    uint8_t chunk[ 4096 ];
+    int found = 0;
+    ssize_t n;
+
+    while( ( n = port.read( chunk, sizeof( chunk ) ) ) > 0 )
+        found += frames.feed( chunk, n );
+
+    return n < 0 ? -1 : found;
+}
+
+#if defined(__linux__)
+
+/**
+ * @brief Services many ports from one thread with epoll
+ *
+ * @details Each port is paired with its own FrameDecoder. poll() waits
+ *          until any port has bytes, then drains every ready port into its
+ *          decoder, so frames are delivered through the decoder callbacks.
+ *          A port that hangs up or fails is dropped from the reader, its
+ *          owner still has to close it. The reader does not own the ports
+ *          or decoders and they must outlive it
+ */
+class PortReader
+{
+public:
+    static const int MAX_PORTS = 16;
+
+    /**
+     * @brief Constructor
+     */
+    PortReader( ) : m_epoll( epoll_create1( EPOLL_CLOEXEC ) ), m_count( 0 )
+    {
+        for( int i = 0; i < MAX_PORTS; ++i )
+            m_entries[ i ].port = NULL;
+    }
+
+    /**
+     * @brief Destructor
+     */
+    ~PortReader( )
+    {
+        if( m_epoll >= 0 )
+            ::close( m_epoll );
+    }
+
+    PortReader( const PortReader& ) = delete;
+    PortReader& operator=( const PortReader& ) = delete;
+
+    /**
+     * @brief Start servicing a port
+     *
+     * @param port Open port
+     * @param frames Decoder for the bytes from this port
+     * @return true if added
+     */
+    bool add( PosixPort& port, FrameDecoder& frames )
+    {
+        if( m_epoll < 0 || !port.is_open() )
+            return false;
+
+        for( int i = 0; i < MAX_PORTS; ++i )
+        {
+            if( m_entries[ i ].port != NULL )
+                continue;
+
+            struct epoll_event event;
+            event.events = EPOLLIN | EPOLLRDHUP;
+            event.data.ptr = &m_entries[ i ];
+
+            if( epoll_ctl( m_epoll, EPOLL_CTL_ADD, port.fd(), &event ) != 0 )
+                return false;
+
+            m_entries[ i ].port = &port;
+            m_entries[ i ].frames = &frames;
+            ++m_count;
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Stop servicing a port
+     *
+     * @param port Port given to add
+     * @return true if the port was being serviced
+     */
+    bool remove( PosixPort& port )
+    {
+        for( int i = 0; i < MAX_PORTS; ++i )
+        {
+            if( m_entries[ i ].port == &port )
+            {
+                drop( m_entries[ i ] );
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Wait for bytes and decode them
+     *
+     * @param timeout_ms Longest wait, 0 to return at once, -1 to wait forever
+     * @return int Number of valid frames decoded, -1 on error
+     */
+    int poll( int timeout_ms )
+    {
+        struct epoll_event events[ MAX_PORTS ];
+        int ready = epoll_wait( m_epoll, events, MAX_PORTS, timeout_ms );
+
+        if( ready < 0 )
+            return errno == EINTR ? 0 : -1;
+
+        int found = 0;
+
+        for( int i = 0; i < ready; ++i )
+        {
+            Entry& entry = *static_cast< Entry* >( events[ i ].data.ptr );
+
+            if( entry.port == NULL )
+                continue;
+
+            // Drain before checking for hangup so the last bytes aren't lost
+            int frames = read( *entry.port, *entry.frames );
+
+            if( frames > 0 )
+                found += frames;
+
+            if( frames < 0 || ( events[ i ].events & ( EPOLLERR | EPOLLHUP | EPOLLRDHUP ) ) )
+                drop( entry );
+        }
+
+        return found;
+    }
+
+    /**
+     * @brief Number of ports being serviced
+     */
+    int count( void ) const { return m_count; }
+
+private:
+    struct Entry
+    {
+        PosixPort* port;        // NULL when the slot is free
+        FrameDecoder* frames;   // Decoder for the port
+    };
+
+    void drop( Entry& entry )
+    {
+        epoll_ctl( m_epoll, EPOLL_CTL_DEL, entry.port->fd(), NULL );
+        entry.port = NULL;
+        --m_count;
+    }
+
+    int m_epoll;                        // epoll descriptor
+    int m_count;                        // Ports being serviced
+    Entry m_entries[ MAX_PORTS ];       // Port slots
+};
+
+#endif
+
+} // End of namespace serial
+
+/*! @} End of Doxygen Groups*/
+
+} // End of namespace aero
+
+/*! @} End of Doxygen Groups*/
+
+#endif
@@ -0,0 +1,316 @@
+#pragma once
+
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    #include "Arduino.h"
+#else
+    #include <cstddef>
+    #include <cstdint>
+    #include <cstring>
+#endif
+
+#include "Message.hpp"
+#include "Fields.hpp"
+
+/*!
+ *  \addtogroup aero
+ *  @{
+ */
+
+//! Aero library code
+namespace aero
+{
+
+/*!
+ *  \addtogroup quant
+ *  @{
+ */
+
+//! Fixed-point wire encoding of segments with declared scaling factors
+namespace quant
+{
+    /**
+     * @brief Range and resolution of a quantized field
+     */
+    typedef reflect::Scale Scale;
+
+    /**
+     * @brief Check if an integer type is signed without type_traits
+     */
+    template< typename Wire >
+    constexpr bool is_signed( void ) { return static_cast< Wire >( -1 ) < static_cast< Wire >( 0 ); }
+
+    /**
+     * @brief Largest value of an integer type up to 32 bits
+     */
+    template< typename Wire >
+    constexpr int64_t wire_max( void )
+    {
+        return is_signed< Wire >() ? ( ( int64_t ) 1 << ( 8 * sizeof( Wire ) - 1 ) ) - 1
+                                   : ( ( int64_t ) 1 << ( 8 * sizeof( Wire ) ) ) - 1;
+    }
+
+    /**
+     * @brief Smallest value of an integer type up to 32 bits
+     */
+    template< typename Wire >
+    constexpr int64_t wire_min( void )
+    {
+        return is_signed< Wire >() ? -wire_max< Wire >() - 1 : 0;
+    }
+
+    /**
+     * @brief Check that a scale fits in an integer type. Signed types are
+     *        centred on zero, unsigned types count up from min
+     */
+    template< typename Wire >
+    constexpr bool fits( Scale scale )
+    {
+        return is_signed< Wire >()
+            ? scale.min / scale.resolution >= wire_min< Wire >() && scale.max / scale.resolution <= wire_max< Wire >()
+            : ( scale.max - scale.min ) / scale.resolution <= wire_max< Wire >();
+    }
+
+    /**
+     * @brief Quantize a value
+     *
+     * @tparam Wire Integer type sent on the wire
+     * @param value Value to quantize
+     * @param scale Range and resolution of the field
+     * @return Wire Nearest count. Values outside the range saturate
+     */
+    template< typename Wire >
+    inline Wire encode( float value, const Scale& scale )
+    {
+        float base = is_signed< Wire >() ? 0.0f : scale.min;
+
+        // Written so NaN ends up at min instead of undefined
+        if( !( value > scale.min ) )
+            value = scale.min;
+        else if( value > scale.max )
+            value = scale.max;
+
+        float counts = ( value - base ) / scale.resolution;
+        counts = counts >= 0.0f ? counts + 0.5f : counts - 0.5f;
+
+        if( counts >= (float) wire_max< Wire >() )
+            return static_cast< Wire >( wire_max< Wire >() );
+        if( counts <= (float) wire_min< Wire >() )
+            return static_cast< Wire >( wire_min< Wire >() );
+
+        return static_cast< Wire >( static_cast< int64_t >( counts ) );
+    }
+
+    /**
+     * @brief Convert a count back to a value
+     *
+     * @tparam Wire Integer type sent on the wire
+     * @param counts Quantized value
+     * @param scale Range and resolution of the field
+     * @return float Value
+     */
+    template< typename Wire >
+    inline float decode( Wire counts, const Scale& scale )
+    {
+        float base = is_signed< Wire >() ? 0.0f : scale.min;
+        return base + counts * scale.resolution;
+    }
+
+    /**
+     * @brief Clamp an integer into a narrower integer type
+     */
+    template< typename Wire >
+    inline Wire saturate( uint32_t value )
+    {
+        return value > (uint32_t) wire_max< Wire >() ? static_cast< Wire >( wire_max< Wire >() ) : static_cast< Wire >( value );
+    }
+
+    //! Scaling factors for def::IMUCompact_t
+    namespace imu
+    {
+        constexpr Scale accel = {   -16.0f,   16.0f, 0.001f };   // [ g ]
+        constexpr Scale gyro  = { -2000.0f, 2000.0f, 0.1f   };   // [ deg/s ]
+        constexpr Scale mag   = { -3200.0f, 3200.0f, 0.1f   };   // [ uT ]
+        constexpr Scale angle = {  -180.0f,  180.0f, 0.01f  };   // [ deg ]
+
+        static_assert( fits< int16_t >( accel ) && fits< int16_t >( gyro ) && fits< int16_t >( mag )
+                       && fits< int16_t >( angle ), "IMU scale does not fit the wire type" );
+    }
+
+    //! Scaling factors for def::GPSCompact_t
+    namespace gps
+    {
+        constexpr Scale lat      = {  -90.0f,    90.0f, 1e-7f };    // [ deg ]
+        constexpr Scale lon      = { -180.0f,   180.0f, 1e-7f };    // [ deg ]
+        constexpr Scale speed    = {    0.0f,   655.35f, 0.01f };   // [ m/s ]
+        constexpr Scale altitude = { -500.0f,  6053.5f, 0.1f };     // [ m ]
+
+        static_assert( fits< int32_t >( lat ) && fits< int32_t >( lon ) && fits< uint16_t >( speed )
+                       && fits< uint16_t >( altitude ), "GPS scale does not fit the wire type" );
+    }
+
+    //! Per field conversions used by pack and unpack
+    namespace detail
+    {
+        /**
+         * @brief Convert one field to its wire type. Scaled fields are
+         *        quantized, the rest saturate into the narrower integer
+         */
+        template< typename Full, typename V, typename Compact, typename Wire >
+        inline void pack( const Full& in, Compact& out, const reflect::Field< Full, V >& full,
+                          const reflect::Field< Compact, Wire >& compact )
+        {
+            const V value = reflect::get( in, full );
+            Wire counts = compact.scale.resolution != 0.0f ? encode< Wire >( static_cast< float >( value ), compact.scale )
+                                                           : saturate< Wire >( static_cast< uint32_t >( value ) );
+
+            reflect::set( out, compact, counts );
+        }
+
+        /**
+         * @brief Convert one field back from its wire type
+         */
+        template< typename Compact, typename Wire, typename Full, typename V >
+        inline void unpack( const Compact& in, Full& out, const reflect::Field< Compact, Wire >& compact,
+                            const reflect::Field< Full, V >& full )
+        {
+            const Wire counts = reflect::get( in, compact );
+
+            reflect::set( out, full, compact.scale.resolution != 0.0f ? static_cast< V >( decode( counts, compact.scale ) )
+                                                                      : static_cast< V >( counts ) );
+        }
+
+        // Pair up the fields of the two structs for reflect::zip
+        template< typename Full, typename Compact >
+        struct Pack
+        {
+            const Full& in;
+            Compact& out;
+
+            template< typename V, typename Wire >
+            void operator()( const reflect::Field< Full, V >& full, const reflect::Field< Compact, Wire >& compact ) const
+            {
+                pack( in, out, full, compact );
+            }
+        };
+
+        template< typename Compact, typename Full >
+        struct Unpack
+        {
+            const Compact& in;
+            Full& out;
+
+            template< typename Wire, typename V >
+            void operator()( const reflect::Field< Compact, Wire >& compact, const reflect::Field< Full, V >& full ) const
+            {
+                unpack( in, out, compact, full );
+            }
+        };
+    }
+
+    /**
+     * @brief Quantize a segment into its compact form, field by field as
+     *        listed in reflect::Describe
+     *
+     * @param in Full precision data
+     * @param out Compact wire data
+     */
+    template< typename Full, typename Compact >
+    inline void pack( const Full& in, Compact& out )
+    {
+        detail::Pack< Full, Compact > pair = { in, out };
+        reflect::zip( reflect::Describe< Full >::fields(), reflect::Describe< Compact >::fields(), pair );
+    }
+
+    /**
+     * @brief Expand a compact segment, field by field as listed in reflect::Describe
+     *
+     * @param in Compact wire data
+     * @param out Full precision data
+     */
+    template< typename Compact, typename Full >
+    inline void unpack( const Compact& in, Full& out )
+    {
+        detail::Unpack< Compact, Full > pair = { in, out };
+        reflect::zip( reflect::Describe< Compact >::fields(), reflect::Describe< Full >::fields(), pair );
+    }
+
+    /**
+     * @brief Read IMU data from a frame that has either the full or compact segment
+     *
+     * @param view Frame to read from
+     * @param out Full precision data
+     * @return true if either segment was found
+     */
+    inline bool read( const MessageView& view, def::IMU_t& out )
+    {
+        def::IMUCompact_t compact;
+
+        if( view.copy( out ) )
+            return true;
+
+        if( !view.copy( compact ) )
+            return false;
+
+        unpack( compact, out );
+        return true;
+    }
+
+    /**
+     * @brief Read GPS data from a frame that has either the full or compact segment
+     *
+     * @param view Frame to read from
+     * @param out Full precision data
+     * @return true if either segment was found
+     */
+    inline bool read( const MessageView& view, def::GPS_t& out )
+    {
+        def::GPSCompact_t compact;
+
+        if( view.copy( out ) )
+            return true;
+
+        if( !view.copy( compact ) )
+            return false;
+
+        unpack( compact, out );
+        return true;
+    }
+} // End of namespace quant
+
+/*! @} End of Doxygen Groups*/
+
+namespace reflect
+{
+    template<> struct Describe< def::IMUCompact_t >
+    {
+        static constexpr const char* name( void ) { return "IMUCompact"; }
+        AERO_FIELDS( AERO_SCALED_FIELD( def::IMUCompact_t, ax, quant::imu::accel ),
+                     AERO_SCALED_FIELD( def::IMUCompact_t, ay, quant::imu::accel ),
+                     AERO_SCALED_FIELD( def::IMUCompact_t, az, quant::imu::accel ),
+                     AERO_SCALED_FIELD( def::IMUCompact_t, gx, quant::imu::gyro ),
+                     AERO_SCALED_FIELD( def::IMUCompact_t, gy, quant::imu::gyro ),
+                     AERO_SCALED_FIELD( def::IMUCompact_t, gz, quant::imu::gyro ),
+                     AERO_SCALED_FIELD( def::IMUCompact_t, mx, quant::imu::mag ),
+                     AERO_SCALED_FIELD( def::IMUCompact_t, my, quant::imu::mag ),
+                     AERO_SCALED_FIELD( def::IMUCompact_t, mz, quant::imu::mag ),
+                     AERO_SCALED_FIELD( def::IMUCompact_t, yaw, quant::imu::angle ),
+                     AERO_SCALED_FIELD( def::IMUCompact_t, pitch, quant::imu::angle ),
+                     AERO_SCALED_FIELD( def::IMUCompact_t, roll, quant::imu::angle ) )
+    };
+
+    template<> struct Describe< def::GPSCompact_t >
+    {
+        static constexpr const char* name( void ) { return "GPSCompact"; }
+        AERO_FIELDS( AERO_FIELD( def::GPSCompact_t, fix ), AERO_SCALED_FIELD( def::GPSCompact_t, lat, quant::gps::lat ),
+                     AERO_SCALED_FIELD( def::GPSCompact_t, lon, quant::gps::lon ),
+                     AERO_SCALED_FIELD( def::GPSCompact_t, speed, quant::gps::speed ),
+                     AERO_FIELD( def::GPSCompact_t, satellites ),
+                     AERO_SCALED_FIELD( def::GPSCompact_t, altitude, quant::gps::altitude ),
+                     AERO_FIELD( def::GPSCompact_t, time ), AERO_FIELD( def::GPSCompact_t, date ),
+                     AERO_FIELD( def::GPSCompact_t, HDOP ), AERO_FIELD( def::GPSCompact_t, quality ) )
+    };
+} // End of namespace reflect
+
+} // End of namespace aero
+
+/*! @} End of Doxygen Groups*/
@@ -0,0 +1,265 @@
+#pragma once
+
+// Bulk swaps and text output are for a host, the boards only need the
+// field tables in Fields.hpp
+#if !defined(ARDUINO) && !defined(CORE_TEENSY)
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "Fields.hpp"
+#include "Format.hpp"
+#include "Simd.hpp"
+
+/*!
+ *  \addtogroup aero
+ *  @{
+ */
+
+//! Aero library code
+namespace aero
+{
+
+/*!
+ *  \addtogroup reflect
+ *  @{
+ */
+
+//! Compile time field reflection for segment structs
+namespace reflect
+{
+    //! Byte shuffle patterns for swapping runs of structs
+    namespace detail
+    {
+        constexpr size_t gcd( size_t a, size_t b ) { return b == 0 ? a : gcd( b, a % b ); }
+
+        /**
+         * @brief Shuffle masks that swap every field of consecutive structs
+         *
+         * @details The masks cover the shortest run of structs that is a
+         *          whole number of 16 byte blocks. Padding bytes stay put
+         */
+        template< typename T >
+        struct Pattern
+        {
+            static constexpr size_t PERIOD = sizeof( T ) / gcd( sizeof( T ), 16 ) * 16;   // Bytes in a run
+            static constexpr size_t OBJECTS = PERIOD / sizeof( T );                       // Structs in a run
+
+            constexpr Pattern( ) : index(), blocked( true )
+            {
+                for( size_t i = 0; i < PERIOD; ++i )
+                    index[ i ] = static_cast< uint8_t >( i % 16 );
+
+                for( size_t k = 0; k < OBJECTS; ++k )
+                    mark( Describe< T >::fields(), k * sizeof( T ) );
+            }
+
+            uint8_t index[ PERIOD ];    // Source byte in the block for every byte of the run
+            bool blocked;               // No field crosses a block, false for packed structs
+
+        private:
+            constexpr void mark( const List<>&, size_t ) {}
+
+            template< typename F, typename... Fs >
+            constexpr void mark( const List< F, Fs... >& fields, size_t base )
+            {
+                size_t first = base + fields.head.offset;
+                size_t size = width( fields.head.type );
+
+                if( first / 16 != ( first + size - 1 ) / 16 )
+                    blocked = false;
+
+                for( size_t i = 0; i < size; ++i )
+                    index[ first + i ] = static_cast< uint8_t >( ( first + size - 1 - i ) % 16 );
+
+                mark( fields.tail, base );
+            }
+        };
+
+        // One pattern per struct shared by every translation unit
+        template< typename T >
+        struct Patterns
+        {
+            static constexpr Pattern< T > pattern = Pattern< T >();
+        };
+
+        template< typename T > constexpr Pattern< T > Patterns< T >::pattern;
+    }
+
+    /**
+     * @brief Reverse the byte order of every field of an array of structs
+     *
+     * @details Runs of structs are swapped with one byte shuffle per 16
+     *          bytes where the host has one, see bit::shuffle. Packed
+     *          structs and the structs left over are swapped field by field
+     *
+     * @param objects Array to swap in place
+     * @param count Number of structs
+     */
+    template< typename T >
+    inline void swap( T* objects, size_t count )
+    {
+        typedef detail::Pattern< T > Pattern;
+        const Pattern& pattern = detail::Patterns< T >::pattern;
+        size_t done = 0;
+
+        if( pattern.blocked )
+        {
+            size_t runs = count / Pattern::OBJECTS;
+
+            bit::shuffle( reinterpret_cast< uint8_t* >( objects ), runs * Pattern::PERIOD / 16, pattern.index, Pattern::PERIOD / 16 );
+            done = runs * Pattern::OBJECTS;
+        }
+
+        for( size_t i = done; i < count; ++i )
+            swap( objects[ i ] );
+    }
+
+    /**
+     * @brief Put every field of an array of structs in little endian order,
+     *        nothing to do on little endian hosts
+     *
+     * @param objects Array to convert in place, converting twice undoes it
+     * @param count Number of structs
+     */
+    template< typename T >
+    inline void to_little_endian( T* objects, size_t count )
+    {
+        if( bit::HOST_ORDER != bit::WIRE_ORDER )
+            swap( objects, count );
+    }
+
+    //! Text output helpers
+    namespace detail
+    {
+        // Field values, bools as 0 and 1 and floats in their shortest exact form
+        inline void value( print::Formatter& out, bool v ) { out.put( v ? '1' : '0' ); }
+        inline void value( print::Formatter& out, float v ) { out.real( v ); }
+
+        template< typename I >
+        inline void value( print::Formatter& out, I v ) { out.number( v ); }
+
+        // Terminate and return the full length like snprintf
+        inline size_t finish( print::Formatter& out )
+        {
+            out.c_str();
+            return out.length();
+        }
+    }
+
+    /**
+     * @brief Write the field names of T separated by commas
+     *
+     * @param buf Output, always terminated if len > 0
+     * @param len Size of buf
+     * @return size_t Length of the full line, like snprintf. Didn't fit if >= len
+     */
+    template< typename T >
+    inline size_t csv_header( char* buf, size_t len )
+    {
+        print::Formatter out( buf, len );
+        bool first = true;
+
+        for_each< T >( [ & ]( const auto& field )
+        {
+            if( !first )
+                out.put( ',' );
+            out.text( field.name );
+            first = false;
+        } );
+
+        return detail::finish( out );
+    }
+
+    /**
+     * @brief Write the field values of an object separated by commas
+     *
+     * @param object Struct to write
+     * @param buf Output, always terminated if len > 0
+     * @param len Size of buf
+     * @return size_t Length of the full line, like snprintf. Didn't fit if >= len
+     */
+    template< typename T >
+    inline size_t csv_row( const T& object, char* buf, size_t len )
+    {
+        print::Formatter out( buf, len );
+        bool first = true;
+
+        visit( object, [ & ]( const auto&, const auto& value )
+        {
+            if( !first )
+                out.put( ',' );
+            detail::value( out, value );
+            first = false;
+        } );
+
+        return detail::finish( out );
+    }
+
+    /**
+     * @brief Write an object as a JSON object keyed by field name
+     *
+     * @param object Struct to write
+     * @param buf Output, always terminated if len > 0
+     * @param len Size of buf
+     * @return size_t Length of the full text, like snprintf. Didn't fit if >= len
+     */
+    template< typename T >
+    inline size_t json( const T& object, char* buf, size_t len )
+    {
+        print::Formatter out( buf, len );
+        bool first = true;
+
+        out.put( '{' );
+        visit( object, [ & ]( const auto& field, const auto& value )
+        {
+            out.text( first ? "\"" : ",\"" );
+            out.text( field.name );
+            out.text( "\":" );
+            if( field.type == Type::Bool )
+                out.text( value ? "true" : "false" );
+            else
+                detail::value( out, value );
+            first = false;
+        } );
+        out.put( '}' );
+
+        return detail::finish( out );
+    }
+
+    /**
+     * @brief Write an object one "name: value" line per field under its name
+     *
+     * @param object Struct to write
+     * @param buf Output, always terminated if len > 0
+     * @param len Size of buf
+     * @return size_t Length of the full text, like snprintf. Didn't fit if >= len
+     */
+    template< typename T >
+    inline size_t pretty( const T& object, char* buf, size_t len )
+    {
+        print::Formatter out( buf, len );
+
+        out.text( Describe< T >::name() );
+        out.line();
+        visit( object, [ & ]( const auto& field, const auto& value )
+        {
+            out.text( "  " );
+            out.text( field.name );
+            out.text( ": " );
+            detail::value( out, value );
+            out.line();
+        } );
+
+        return detail::finish( out );
+    }
+} // End of namespace reflect
+
+/*! @} End of Doxygen Groups*/
+
+} // End of namespace aero
+
+/*! @} End of Doxygen Groups*/
+
+#endif
@@ -0,0 +1,459 @@
+#pragma once
+
+// Replay runs on a host against logs written by LogWriter
+#if !defined(ARDUINO) && !defined(CORE_TEENSY)
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "FrameDecoder.hpp"
+#include "Log.hpp"
+#include "Quantize.hpp"
+#include "Utility.hpp"
+
+/*!
+ *  \addtogroup aero
+ *  @{
+ */
+
+//! Aero library code
+namespace aero
+{
+
+/*!
+ *  \addtogroup replay
+ *  @{
+ */
+
+//! Replay of captured flights through the decode pipeline
+namespace replay
+{
+    /**
+     * @brief Replay settings
+     */
+    struct Options
+    {
+        double speed = 0.0;             // 1 for real time, N for N times faster, 0 unthrottled
+        double bit_error_rate = 0.0;    // Chance of each bit being flipped
+        double drop_rate = 0.0;         // Chance of each byte being lost
+        uint64_t seed = 1;              // Error injection seed, the same seed gives the same errors
+        size_t chunk = 64;              // Bytes handed to the decoder at a time, like a serial read
+        uint64_t from_us = 0;           // Earliest record to replay
+        uint64_t to_us = UINT64_MAX;    // Latest record to replay
+
+        FrameDecoder::Callback callback = NULL;    // Called with every decoded frame
+        void* context = NULL;                      // Passed through to the callback
+    };
+
+    /**
+     * @brief Latency samples of one pipeline stage
+     */
+    class Latency
+    {
+    public:
+        /**
+         * @brief Add a sample
+         *
+         * @param ns Stage time in nanoseconds
+         */
+        void add( uint64_t ns ) { m_samples.push_back( ns > UINT32_MAX ? UINT32_MAX : static_cast< uint32_t >( ns ) ); m_sorted = false; }
+
+        /**
+         * @brief Get a percentile
+         *
+         * @param p Percentile from 0 to 100
+         * @return uint32_t Latency in nanoseconds, 0 without samples
+         */
+        uint32_t percentile( double p )
+        {
+            if( m_samples.empty() )
+                return 0;
+
+            if( !m_sorted )
+                std::sort( m_samples.begin(), m_samples.end() );
+            m_sorted = true;
+
+            size_t rank = static_cast< size_t >( std::ceil( p / 100.0 * m_samples.size() ) );
+            return m_samples[ rank == 0 ? 0 : rank - 1 ];
+        }
+
+        /**
+         * @brief Number of samples
+         */
+        size_t count( void ) const { return m_samples.size(); }
+
+        /**
+         * @brief Drop all samples
+         */
+        void clear( void ) { m_samples.clear(); }
+
+    private:
+        std::vector< uint32_t > m_samples;  // Nanoseconds
+        bool m_sorted = false;              // Samples are in order
+    };
+
+    /**
+     * @brief Results of a replay
+     */
+    struct Report
+    {
+        uint64_t records = 0;           // Frames read from the capture
+        uint64_t frames = 0;            // Frames the decoder recovered
+        uint64_t bytes = 0;             // Bytes handed to the decoder
+        uint64_t dropped = 0;           // Bytes the decoder discarded
+        uint64_t bit_errors = 0;        // Bits flipped by the injector
+        uint64_t lost_bytes = 0;        // Bytes removed by the injector
+        double seconds = 0.0;           // Wall time of the replay
+
+        Latency decode;                 // Frame sync and CRC check per record, per chunk of a raw capture
+        Latency parse;                  // Segment extraction per frame
+        Latency convert;                // Air data conversion per frame
+
+        /**
+         * @brief Decoded frames per second of wall time
+         */
+        double frame_rate( void ) const { return seconds > 0.0 ? frames / seconds : 0.0; }
+
+        /**
+         * @brief Bytes per second of wall time
+         */
+        double byte_rate( void ) const { return seconds > 0.0 ? bytes / seconds : 0.0; }
+
+        /**
+         * @brief Print a summary
+         *
+         * @param out Stream to print to
+         */
+        void print( FILE* out )
+        {
+            fprintf( out, "records %llu, frames %llu, bytes %llu, dropped %llu\n",
+                     (unsigned long long) records, (unsigned long long) frames,
+                     (unsigned long long) bytes, (unsigned long long) dropped );
+            fprintf( out, "injected %llu bit errors, %llu lost bytes\n",
+                     (unsigned long long) bit_errors, (unsigned long long) lost_bytes );
+            fprintf( out, "%.3f s, %.0f frames/s, %.0f bytes/s\n", seconds, frame_rate(), byte_rate() );
+            fprintf( out, "stage      p50 ns    p90 ns    p99 ns  p99.9 ns    max ns\n" );
+            print_stage( out, "decode", decode );
+            print_stage( out, "parse", parse );
+            print_stage( out, "convert", convert );
+        }
+
+    private:
+        static void print_stage( FILE* out, const char* name, Latency& stage )
+        {
+            fprintf( out, "%-8s %8u  %8u  %8u  %8u  %8u\n", name, stage.percentile( 50 ), stage.percentile( 90 ),
+                     stage.percentile( 99 ), stage.percentile( 99.9 ), stage.percentile( 100 ) );
+        }
+    };
+
+    /**
+     * @brief Seeded bit error and byte loss injection
+     *
+     * @details Gaps between errors are drawn from a geometric distribution,
+     *          so the cost is per error rather than per bit
+     */
+    class Injector
+    {
+    public:
+        /**
+         * @brief Constructor
+         *
+         * @param bit_error_rate Chance of each bit being flipped
+         * @param drop_rate Chance of each byte being lost
+         * @param seed Random seed
+         */
+        Injector( double bit_error_rate, double drop_rate, uint64_t seed )
+            : m_ber( bit_error_rate ), m_drop( drop_rate ), m_state( seed ? seed : 1 )
+        {
+            m_next_flip = gap( m_ber );
+            m_next_drop = gap( m_drop );
+        }
+
+        /**
+         * @brief Damage a run of bytes in place
+         *
+         * @param data Bytes to damage
+         * @param len Number of bytes
+         * @param report Counts of injected errors
+         * @return size_t Number of bytes left after drops
+         */
+        size_t apply( uint8_t* data, size_t len, Report& report )
+        {
+            // Bit errors over the len * 8 bits
+            for( uint64_t bits = len * 8; m_next_flip < bits; m_next_flip += 1 + gap( m_ber ) )
+            {
+                data[ m_next_flip / 8 ] ^= static_cast< uint8_t >( 1 << ( m_next_flip % 8 ) );
+                ++report.bit_errors;
+            }
+            m_next_flip -= len * 8;
+
+            if( m_next_drop >= len )
+            {
+                m_next_drop -= len;
+                return len;
+            }
+
+            // Squeeze out dropped bytes
+            size_t out = 0;
+            for( size_t i = 0; i < len; ++i )
+            {
+                if( m_next_drop == 0 )
+                {
+                    ++report.lost_bytes;
+                    m_next_drop = gap( m_drop );
+                    continue;
+                }
+
+                --m_next_drop;
+                data[ out++ ] = data[ i ];
+            }
+
+            return out;
+        }
+
+    private:
+        // xorshift64*, uniform in ( 0, 1 ]
+        double uniform( void )
+        {
+            m_state ^= m_state >> 12;
+            m_state ^= m_state << 25;
+            m_state ^= m_state >> 27;
+            return ( ( ( m_state * 0x2545F4914F6CDD1DULL ) >> 11 ) + 1 ) * ( 1.0 / 9007199254740992.0 );
+        }
+
+        // Events before the next error
+        uint64_t gap( double rate )
+        {
+            if( rate <= 0.0 )
+                return UINT64_MAX / 2;
+            if( rate >= 1.0 )
+                return 0;
+
+            double n = std::floor( std::log( uniform() ) / std::log1p( -rate ) );
+            return n > 1e18 ? UINT64_MAX / 2 : static_cast< uint64_t >( n );
+        }
+
+        double m_ber;           // Bit error rate
+        double m_drop;          // Byte drop rate
+        uint64_t m_state;       // Generator state
+        uint64_t m_next_flip;   // Bits until the next flip
+        uint64_t m_next_drop;   // Bytes until the next drop
+    };
+
+    /**
+     * @brief Streams a capture through the same path as live telemetry
+     *
+     * @details Each record is optionally damaged, fed to a FrameDecoder in
+     *          serial sized chunks, then every recovered frame has its
+     *          segments read out and the air data conversions applied. The
+     *          time spent in each stage is recorded separately
+     */
+    class Engine
+    {
+    public:
+        typedef std::chrono::steady_clock Clock;
+
+        /**
+         * @brief Constructor
+         *
+         * @param options Replay settings
+         */
+        explicit Engine( const Options& options )
+            : m_options( options ), m_injector( options.bit_error_rate, options.drop_rate, options.seed ),
+              m_decoder( on_frame, this ), m_report( NULL ), m_sink( 0.0f )
+        {
+            m_options.chunk = std::max< size_t >( 1, std::min( m_options.chunk, sizeof( m_chunk ) ) );
+        }
+
+        /**
+         * @brief Replay a log
+         *
+         * @param log Open log
+         * @param report Results, added to any already there
+         * @return true if this run found records in the range
+         */
+        bool run( const LogReader& log, Report& report )
+        {
+            m_report = &report;
+            m_first = true;
+
+            Clock::time_point start = Clock::now();
+            size_t records = log.query( m_options.from_us, m_options.to_us, 0, on_record, this );
+            report.seconds += std::chrono::duration< double >( Clock::now() - start ).count();
+
+            m_report = NULL;
+            return records > 0;
+        }
+
+        /**
+         * @brief Replay a raw byte capture unthrottled
+         *
+         * @param data Captured bytes
+         * @param len Number of bytes
+         * @param report Results, added to any already there
+         */
+        void run( const uint8_t* data, size_t len, Report& report )
+        {
+            m_report = &report;
+
+            // A raw capture has no records, each chunk is timed on its own
+            Clock::time_point start = Clock::now();
+            for( size_t i = 0; i < len; i += m_options.chunk )
+                feed( data + i, std::min( m_options.chunk, len - i ) );
+            report.seconds += std::chrono::duration< double >( Clock::now() - start ).count();
+
+            m_report = NULL;
+        }
+
+        /**
+         * @brief Result of the conversions, kept so they can't be optimized out
+         */
+        float sink( void ) const { return m_sink; }
+
+    private:
+        static void on_record( uint64_t time_us, const MessageView& frame, void* context )
+        {
+            Engine& engine = *static_cast< Engine* >( context );
+            engine.m_report->records++;
+            engine.throttle( time_us );
+            engine.feed( frame.data(), frame.size() );
+        }
+
+        static void on_frame( const MessageView& frame, void* context )
+        {
+            static_cast< Engine* >( context )->process( frame );
+        }
+
+        /**
+         * @brief Hold a record back until its replay time
+         */
+        void throttle( uint64_t time_us )
+        {
+            if( m_first )
+            {
+                m_first = false;
+                m_start_us = time_us;
+                m_start = Clock::now();
+                return;
+            }
+
+            if( m_options.speed <= 0.0 || time_us < m_start_us )
+                return;
+
+            double offset_us = ( time_us - m_start_us ) / m_options.speed;
+            std::this_thread::sleep_until( m_start + std::chrono::microseconds( static_cast< int64_t >( offset_us ) ) );
+        }
+
+        /**
+         * @brief Damage and decode one record a chunk at a time
+         */
+        void feed( const uint8_t* data, size_t len )
+        {
+            Report& report = *m_report;
+
+            // Decode time is the feeds minus the frames they handed on
+            uint64_t total = 0;
+            m_inner = 0;
+
+            for( size_t i = 0; i < len; i += m_options.chunk )
+            {
+                size_t n = std::min( m_options.chunk, len - i );
+                memcpy( m_chunk, data + i, n );
+                n = m_injector.apply( m_chunk, n, report );
+
+                uint32_t dropped = m_decoder.dropped();
+                Clock::time_point begin = Clock::now();
+                report.frames += m_decoder.feed( m_chunk, n );
+                total += std::chrono::duration_cast< std::chrono::nanoseconds >( Clock::now() - begin ).count();
+
+                report.bytes += n;
+                report.dropped += m_decoder.dropped() - dropped;
+            }
+
+            report.decode.add( total - std::min( total, m_inner ) );
+        }
+
+        /**
+         * @brief Parse and convert one decoded frame
+         */
+        void process( const MessageView& frame )
+        {
+            Report& report = *m_report;
+            Clock::time_point begin = Clock::now();
+
+            def::Pitot_t pitot;
+            def::Enviro_t enviro;
+            def::IMU_t imu;
+            def::GPS_t gps;
+            def::Status_t status;
+
+            bool have_pitot = frame.copy( pitot );
+            bool have_enviro = frame.copy( enviro );
+            bool have_imu = quant::read( frame, imu );
+            bool have_gps = quant::read( frame, gps );
+            frame.copy( status );
+
+            Clock::time_point parsed = Clock::now();
+
+            float sink = 0.0f;
+            if( have_pitot )
+            {
+                float cas = convert::cal_as( pitot.differential_pressure );
+                sink += cas;
+
+                if( have_enviro )
+                {
+                    float eas = convert::equiv_as( pitot.differential_pressure, enviro.pressure );
+                    sink += eas + convert::true_as( eas, enviro.temperature );
+                }
+            }
+
+            if( have_enviro )
+            {
+                float altitude = convert::pressure_altitude( enviro.pressure );
+                sink += altitude + convert::density_altitude( enviro.pressure, enviro.temperature );
+                sink += convert::approx_density( enviro.pressure, enviro.temperature );
+            }
+
+            if( have_imu )
+                sink += imu.yaw;
+            if( have_gps )
+                sink += gps.altitude;
+
+            m_sink += sink;
+            Clock::time_point done = Clock::now();
+
+            if( m_options.callback != NULL )
+                m_options.callback( frame, m_options.context );
+
+            // The callback is in no stage, but it isn't decode time either
+            report.parse.add( std::chrono::duration_cast< std::chrono::nanoseconds >( parsed - begin ).count() );
+            report.convert.add( std::chrono::duration_cast< std::chrono::nanoseconds >( done - parsed ).count() );
+            m_inner += std::chrono::duration_cast< std::chrono::nanoseconds >( Clock::now() - begin ).count();
+        }
+
+        Options m_options;                      // Replay settings
+        Injector m_injector;                    // Error injection
+        FrameDecoder m_decoder;                 // Frame sync and validation
+        Report* m_report;                       // Report of the run in progress
+        uint8_t m_chunk[ 4096 ];                // Damaged copy of a chunk
+        uint64_t m_inner;                       // Time spent after the decoder in this record
+        bool m_first;                           // Next record starts the clock
+        uint64_t m_start_us;                    // Capture time of the first record
+        Clock::time_point m_start;              // Wall time of the first record
+        float m_sink;                           // Sum of every conversion
+    };
+} // End of namespace replay
+
+/*! @} End of Doxygen Groups*/
+
+} // End of namespace aero
+
+/*! @} End of Doxygen Groups*/
+
+#endif
@@ -0,0 +1,250 @@
+#pragma once
+
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    #include "Arduino.h"
+#else
+    #include <cstddef>
+    #include <cstdint>
+#endif
+
+/*!
+ *  \addtogroup aero
+ *  @{
+ */
+
+//! Aero library code
+namespace aero
+{
+
+// Default index type. AVR can only load a single byte atomically
+#if defined(__AVR__)
+    typedef uint8_t RingIndex;
+#else
+    typedef size_t RingIndex;
+#endif
+
+// Keeps the producer and consumer indices on separate cache lines on the host
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    #define AERO_RING_ALIGN
+#else
+    #define AERO_RING_ALIGN alignas( 64 )
+#endif
+
+/**
+ * @brief Fixed capacity single producer, single consumer queue
+ *
+ * @details Push and pop never block or take a lock, so one side can be an
+ *          interrupt or another thread. The producer only writes the tail
+ *          and the consumer only writes the head. Each publishes its index
+ *          with a release store and reads the other's with an acquire load,
+ *          which orders the element copies on ARM and x86 alike. Indices run
+ *          freely and are masked on use, so all N slots are usable
+ *
+ * @tparam T Element type
+ * @tparam N Capacity, a power of two
+ * @tparam Index Unsigned index type the target can load atomically
+ */
+template< typename T, size_t N, typename Index = RingIndex >
+class Ring
+{
+public:
+    static_assert( N > 0 && ( N & ( N - 1 ) ) == 0, "Ring capacity must be a power of two" );
+    static_assert( N <= ( ( (uint64_t) 1 << ( 8 * sizeof( Index ) - 1 ) ) ), "Ring capacity is too large for the index type" );
+
+    /**
+     * @brief Contiguous run of elements inside the ring
+     */
+    struct Span
+    {
+        T* data;        // First element
+        size_t size;    // Number of elements
+    };
+
+    /**
+     * @brief Constructor
+     */
+    Ring( ) : m_data(), m_head( 0 ), m_tail( 0 ) {}
+
+    /**
+     * @brief Add an element. Producer only
+     *
+     * @param value Element to add
+     * @return true if added
+     * @return false if the ring is full
+     */
+    bool push( const T& value )
+    {
+        Index tail = __atomic_load_n( &m_tail, __ATOMIC_RELAXED );
+
+        if( static_cast< Index >( tail - __atomic_load_n( &m_head, __ATOMIC_ACQUIRE ) ) == N )
+            return false;
+
+        m_data[ tail & ( N - 1 ) ] = value;
+        __atomic_store_n( &m_tail, static_cast< Index >( tail + 1 ), __ATOMIC_RELEASE );
+
+        return true;
+    }
+
+    /**
+     * @brief Remove the oldest element. Consumer only
+     *
+     * @param value Element removed
+     * @return true if an element was removed
+     * @return false if the ring is empty
+     */
+    bool pop( T& value )
+    {
+        Index head = __atomic_load_n( &m_head, __ATOMIC_RELAXED );
+
+        if( head == __atomic_load_n( &m_tail, __ATOMIC_ACQUIRE ) )
+            return false;
+
+        value = m_data[ head & ( N - 1 ) ];
+        __atomic_store_n( &m_head, static_cast< Index >( head + 1 ), __ATOMIC_RELEASE );
+
+        return true;
+    }
+
+    /**
+     * @brief Free space that can be written without wrapping. Producer only
+     *
+     * @details Fill the span then call commit() to publish the elements
+     *
+     * @return Span Free slots, size 0 if full
+     */
+    Span write_span( void )
+    {
+        Index tail = __atomic_load_n( &m_tail, __ATOMIC_RELAXED );
+        Index used = tail - __atomic_load_n( &m_head, __ATOMIC_ACQUIRE );
+        size_t start = tail & ( N - 1 );
+        size_t free = N - static_cast< Index >( used );
+
+        Span span = { m_data + start, free < N - start ? free : N - start };
+        return span;
+    }
+
+    /**
+     * @brief Publish elements written into write_span(). Producer only
+     *
+     * @param count Number of elements written, no more than the span size
+     */
+    void commit( size_t count )
+    {
+        Index tail = __atomic_load_n( &m_tail, __ATOMIC_RELAXED );
+        __atomic_store_n( &m_tail, static_cast< Index >( tail + count ), __ATOMIC_RELEASE );
+    }
+
+    /**
+     * @brief Elements that can be read without wrapping. Consumer only
+     *
+     * @details Read the span then call consume() to free the slots
+     *
+     * @return Span Oldest elements, size 0 if empty
+     */
+    Span read_span( void )
+    {
+        Index head = __atomic_load_n( &m_head, __ATOMIC_RELAXED );
+        Index used = __atomic_load_n( &m_tail, __ATOMIC_ACQUIRE ) - head;
+        size_t start = head & ( N - 1 );
+        size_t count = static_cast< Index >( used );
+
+        Span span = { m_data + start, count < N - start ? count : N - start };
+        return span;
+    }
+
+    /**
+     * @brief Free elements read from read_span(). Consumer only
+     *
+     * @param count Number of elements read, no more than the span size
+     */
+    void consume( size_t count )
+    {
+        Index head = __atomic_load_n( &m_head, __ATOMIC_RELAXED );
+        __atomic_store_n( &m_head, static_cast< Index >( head + count ), __ATOMIC_RELEASE );
+    }
+
+    /**
+     * @brief Add as many elements as fit. Producer only
+     *
+     * @param src Elements to add
+     * @param count Number of elements in src
+     * @return size_t Number of elements added
+     */
+    size_t push_n( const T* src, size_t count )
+    {
+        size_t done = 0;
+
+        // At most two spans, before and after the wrap
+        for( int pass = 0; pass < 2 && done < count; ++pass )
+        {
+            Span span = write_span();
+            size_t n = span.size < count - done ? span.size : count - done;
+
+            for( size_t i = 0; i < n; ++i )
+                span.data[ i ] = src[ done + i ];
+
+            commit( n );
+            done += n;
+        }
+
+        return done;
+    }
+
+    /**
+     * @brief Remove up to count elements. Consumer only
+     *
+     * @param dst Buffer for the removed elements
+     * @param count Most elements to remove
+     * @return size_t Number of elements removed
+     */
+    size_t pop_n( T* dst, size_t count )
+    {
+        size_t done = 0;
+
+        for( int pass = 0; pass < 2 && done < count; ++pass )
+        {
+            Span span = read_span();
+            size_t n = span.size < count - done ? span.size : count - done;
+
+            for( size_t i = 0; i < n; ++i )
+                dst[ done + i ] = span.data[ i ];
+
+            consume( n );
+            done += n;
+        }
+
+        return done;
+    }
+
+    /**
+     * @brief Number of elements waiting. Exact from either side's own view
+     */
+    size_t size( void ) const
+    {
+        return static_cast< Index >( __atomic_load_n( &m_tail, __ATOMIC_ACQUIRE ) - __atomic_load_n( &m_head, __ATOMIC_ACQUIRE ) );
+    }
+
+    /**
+     * @brief Check if there are no elements
+     */
+    bool empty( void ) const { return size() == 0; }
+
+    /**
+     * @brief Check if there is no free space
+     */
+    bool full( void ) const { return size() == N; }
+
+    /**
+     * @brief Most elements the ring can hold
+     */
+    static constexpr size_t capacity( void ) { return N; }
+
+private:
+    T m_data[ N ];                      // Element storage
+    AERO_RING_ALIGN Index m_head;       // Next element to read, written by the consumer
+    AERO_RING_ALIGN Index m_tail;       // Next slot to write, written by the producer
+};
+
+} // End of namespace aero
+
+/*! @} End of Doxygen Groups*/
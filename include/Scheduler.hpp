@@ -0,0 +1,359 @@
+#pragma once
+
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    #include "Arduino.h"
+#else
+    #include <cstddef>
+    #include <cstdint>
+#endif
+
+#include "Format.hpp"
+#include "Sensors.hpp"
+
+/*!
+ *  \addtogroup aero
+ *  @{
+ */
+
+//! Aero library code
+namespace aero
+{
+
+/*!
+ *  \addtogroup sched
+ *  @{
+ */
+
+//! Cooperative task scheduling
+namespace sched
+{
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    /**
+     * @brief Board clock in microseconds
+     */
+    struct MicrosClock
+    {
+        uint32_t now( void ) const { return now_us(); }
+    };
+
+    typedef MicrosClock DefaultClock;
+#else
+    /**
+     * @brief Host clock in microseconds, wraps like micros() does
+     */
+    struct SteadyClock
+    {
+        uint32_t now( void ) const { return now_us(); }
+    };
+
+    /**
+     * @brief Clock that only moves when told to, for deterministic tests
+     *
+     * @details Tasks simulate their execution time by advancing it
+     */
+    class VirtualClock
+    {
+    public:
+        explicit VirtualClock( uint32_t start = 0 ) : m_now( start ) {}
+
+        uint32_t now( void ) const { return m_now; }
+
+        void advance( uint32_t us ) { m_now += us; }
+
+        void set( uint32_t us ) { m_now = us; }
+
+    private:
+        uint32_t m_now;     // Current time in microseconds
+    };
+
+    typedef SteadyClock DefaultClock;
+#endif
+
+    /**
+     * @brief Timing of one task since it was added or the stats were reset
+     */
+    struct Stats
+    {
+        uint32_t runs;          // Times the task ran
+        uint32_t failures;      // Runs that returned false
+        uint32_t misses;        // Runs that finished after their deadline
+        uint32_t skipped;       // Releases that passed before the run for an earlier one started
+        uint32_t exec_last;     // Execution time of the last run      [ us ]
+        uint32_t exec_max;      // Longest execution time              [ us ]
+        uint64_t exec_total;    // Sum of execution times, for the mean [ us ]
+        uint32_t jitter_last;   // Start of the last run after its release [ us ]
+        uint32_t jitter_max;    // Latest start after a release         [ us ]
+
+        /**
+         * @brief Mean execution time in microseconds, 0 before the first run
+         */
+        uint32_t exec_mean( void ) const { return runs > 0 ? static_cast< uint32_t >( exec_total / runs ) : 0; }
+    };
+
+    /**
+     * @brief Periodic task
+     */
+    struct Task
+    {
+        /**
+         * @brief Body of a task
+         *
+         * @param context Pointer given when the task was added
+         * @return false if the run failed, counted in Stats::failures
+         */
+        typedef bool ( *Function )( void* context );
+
+        Function function;      // What to run
+        void* context;          // Passed through to the function
+        const char* name;       // For reports
+        uint32_t period;        // Time between releases    [ us ]
+        uint32_t deadline;      // Time after a release the run has to finish by [ us ]
+        uint32_t release;       // Time of the next release [ us ]
+        Stats stats;            // Timing so far
+    };
+
+    /**
+     * @brief Rate monotonic cooperative scheduler for up to N tasks
+     *
+     * @details Tasks are ordered by period, the shortest first, when they
+     *          are added. Each tick() runs the released tasks highest
+     *          priority first, checking the clock again after every run so
+     *          a task released meanwhile goes ahead of lower ones. Runs are
+     *          never interrupted, a slow task delays the others and that
+     *          shows up in their jitter and misses. A task that starts
+     *          more than a period late runs once for all the releases it
+     *          missed, counts the extra ones as skipped and stays on its
+     *          phase. Times are 32 bit microseconds and survive the wrap
+     *          of micros()
+     *
+     *          sched::MicrosClock clock;
+     *          sched::Scheduler< 3 > tasks( clock );
+     *          tasks.add( imu, 5000, "imu" );
+     *          tasks.add( gps );                   // Uses Config_t::poll_time_ms
+     *          loop: tasks.tick();
+     *
+     * @tparam N Largest number of tasks
+     * @tparam Clock Anything with uint32_t now(), in microseconds
+     */
+    template< size_t N, typename Clock = DefaultClock >
+    class Scheduler
+    {
+    public:
+        /**
+         * @brief Constructor
+         *
+         * @param clock Time source, must outlive the scheduler
+         */
+        explicit Scheduler( Clock& clock ) : m_clock( clock ), m_count( 0 ) {}
+
+        /**
+         * @brief Add a task, released right away and then every period
+         *
+         * @param function What to run
+         * @param context Passed through to the function
+         * @param period Time between releases in microseconds, above 0
+         * @param name Name for reports
+         * @param deadline Time after a release the run has to finish by, 0 for the period
+         * @return true if there was room for the task
+         */
+        bool add( Task::Function function, void* context, uint32_t period, const char* name = "",
+                  uint32_t deadline = 0 )
+        {
+            if( m_count == N || function == NULL || period == 0 )
+                return false;
+
+            // Keep rate monotonic order, equal periods run in the order they were added
+            size_t slot = m_count;
+            while( slot > 0 && m_tasks[ slot - 1 ].period > period )
+            {
+                m_tasks[ slot ] = m_tasks[ slot - 1 ];
+                --slot;
+            }
+
+            Task& task = m_tasks[ slot ];
+            task.function = function;
+            task.context = context;
+            task.name = name;
+            task.period = period;
+            task.deadline = deadline > 0 ? deadline : period;
+            task.release = m_clock.now();
+            task.stats = Stats();
+
+            ++m_count;
+            return true;
+        }
+
+        /**
+         * @brief Add a sensor, its update() runs every period
+         *
+         * @param sensor Any sensor:: class, must outlive the scheduler
+         * @param period Time between updates in microseconds
+         * @param name Name for reports
+         * @param deadline Time after a release the update has to finish by, 0 for the period
+         * @return true if there was room for the sensor
+         */
+        template< typename Sensor >
+        bool add( Sensor& sensor, uint32_t period, const char* name = "", uint32_t deadline = 0 )
+        {
+            return add( []( void* s ) { return static_cast< Sensor* >( s )->update(); }, &sensor, period, name, deadline );
+        }
+
+        /**
+         * @brief Add a GPS polled at its configured poll_time_ms
+         *
+         * @param gps GPS initialized with a Config_t, must outlive the scheduler
+         * @param name Name for reports
+         * @return true if there was room and the poll time is set
+         */
+        bool add( sensor::GPS& gps, const char* name = "gps" )
+        {
+            return add( gps, static_cast< uint32_t >( gps.config().poll_time_ms ) * 1000, name );
+        }
+
+        /**
+         * @brief Run every released task once, highest priority first
+         *
+         * @details A task released again while the tick is running waits for
+         * the next tick, so the call returns even when the load is above 100%
+         *
+         * @return size_t Number of tasks run
+         */
+        size_t tick( void )
+        {
+            bool done[ N ] = {};
+            size_t ran = 0;
+            size_t next;
+
+            while( ( next = released( m_clock.now(), done ) ) < m_count )
+            {
+                run( m_tasks[ next ] );
+                done[ next ] = true;
+                ++ran;
+            }
+
+            return ran;
+        }
+
+        /**
+         * @brief Time until the next release, to sleep in between ticks
+         *
+         * @return uint32_t Microseconds, 0 if a task is released already
+         */
+        uint32_t idle( void ) const
+        {
+            uint32_t now = m_clock.now();
+            uint32_t wait = UINT32_MAX;
+
+            for( size_t i = 0; i < m_count; ++i )
+            {
+                int32_t until = static_cast< int32_t >( m_tasks[ i ].release - now );
+                if( until <= 0 )
+                    return 0;
+                if( static_cast< uint32_t >( until ) < wait )
+                    wait = static_cast< uint32_t >( until );
+            }
+
+            return wait;
+        }
+
+        /**
+         * @brief Number of tasks added
+         */
+        size_t size( void ) const { return m_count; }
+
+        /**
+         * @brief Task by priority, 0 has the shortest period
+         */
+        const Task& task( size_t index ) const { return m_tasks[ index ]; }
+
+        /**
+         * @brief Clear the timing of every task
+         */
+        void reset_stats( void )
+        {
+            for( size_t i = 0; i < m_count; ++i )
+                m_tasks[ i ].stats = Stats();
+        }
+
+        /**
+         * @brief Write a table of the timing of every task
+         *
+         * @param out Formatter to write to
+         */
+        void report( print::Formatter& out ) const
+        {
+            static const print::Column COLUMNS[] = {
+                { "task", 10, -1 }, { "period", 8, -1 }, { "runs", 8, -1 }, { "mean", 7, -1 }, { "max", 7, -1 },
+                { "jitter", 7, -1 }, { "miss", 6, -1 }, { "skip", 6, -1 }, { "fail", 6, -1 }
+            };
+
+            print::Table< 9 > table( out, COLUMNS );
+            table.header();
+
+            for( size_t i = 0; i < m_count; ++i )
+            {
+                const Task& t = m_tasks[ i ];
+                table.row( t.name, t.period, t.stats.runs, t.stats.exec_mean(), t.stats.exec_max, t.stats.jitter_max,
+                           t.stats.misses, t.stats.skipped, t.stats.failures );
+            }
+        }
+
+    private:
+        /**
+         * @brief Highest priority task released by a time that has not run this tick
+         *
+         * @param now Current time
+         * @param done Tasks already run this tick
+         * @return size_t Index of the task or m_count if none is
+         */
+        size_t released( uint32_t now, const bool* done ) const
+        {
+            for( size_t i = 0; i < m_count; ++i )
+                if( !done[ i ] && static_cast< int32_t >( now - m_tasks[ i ].release ) >= 0 )
+                    return i;
+
+            return m_count;
+        }
+
+        /**
+         * @brief Run a released task and time it
+         */
+        void run( Task& task )
+        {
+            Stats& stats = task.stats;
+            uint32_t start = m_clock.now();
+            uint32_t late = start - task.release;
+
+            bool ok = task.function( task.context );
+            uint32_t end = m_clock.now();
+            uint32_t exec = end - start;
+
+            ++stats.runs;
+            stats.failures += ok ? 0 : 1;
+            stats.misses += end - task.release > task.deadline ? 1 : 0;
+            stats.exec_last = exec;
+            stats.exec_total += exec;
+            stats.jitter_last = late;
+            if( exec > stats.exec_max )
+                stats.exec_max = exec;
+            if( late > stats.jitter_max )
+                stats.jitter_max = late;
+
+            // This run stands in for every release that passed before it
+            // started, the next one stays on the original phase
+            uint32_t behind = late / task.period;
+            stats.skipped += behind;
+            task.release += ( behind + 1 ) * task.period;
+        }
+
+        Clock& m_clock;         // Time source
+        Task m_tasks[ N ];      // Tasks by priority
+        size_t m_count;         // Tasks added
+    };
+} // End of namespace sched
+
+/*! @} End of Doxygen Groups*/
+
+} // End of namespace aero
+
+/*! @} End of Doxygen Groups*/
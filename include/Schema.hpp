@@ -0,0 +1,198 @@
+#pragma once
+
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    #include "Arduino.h"
+#else
+    #include <cstddef>
+    #include <cstdint>
+    #include <cstring>
+#endif
+
+#include "Message.hpp"
+
+/*!
+ *  \addtogroup aero
+ *  @{
+ */
+
+//! Aero library code
+namespace aero
+{
+
+//! Compile time helpers for Schema. Type lists are walked recursively so
+//! nothing here needs the standard library
+namespace schema
+{
+    template< typename... Ts > struct Pack {};
+
+    template< typename T >
+    constexpr uint16_t bit_of( void )
+    {
+        return static_cast< uint16_t >( 1u << static_cast< int >( def::Segment< T >::signature ) );
+    }
+
+    constexpr uint16_t signature_of( Pack<> ) { return 0; }
+
+    template< typename T, typename... Ts >
+    constexpr uint16_t signature_of( Pack< T, Ts... > )
+    {
+        return bit_of< T >() | signature_of( Pack< Ts... >() );
+    }
+
+    constexpr size_t length_of( Pack<> ) { return 0; }
+
+    template< typename T, typename... Ts >
+    constexpr size_t length_of( Pack< T, Ts... > )
+    {
+        return sizeof( T ) + length_of( Pack< Ts... >() );
+    }
+
+    constexpr bool unique( Pack<> ) { return true; }
+
+    template< typename T, typename... Ts >
+    constexpr bool unique( Pack< T, Ts... > )
+    {
+        return ( bit_of< T >() & signature_of( Pack< Ts... >() ) ) == 0 && unique( Pack< Ts... >() );
+    }
+
+    // Sum of the sizes of the segments that are packed before bit
+    constexpr size_t offset_of( uint16_t, Pack<> ) { return 0; }
+
+    template< typename T, typename... Ts >
+    constexpr size_t offset_of( uint16_t bit, Pack< T, Ts... > )
+    {
+        return ( bit_of< T >() < bit ? sizeof( T ) : 0 ) + offset_of( bit, Pack< Ts... >() );
+    }
+} // End of namespace schema
+
+/**
+ * @brief Message layout fixed at compile time
+ *
+ * @details Signature, segment offsets and frame size are constants so build()
+ *          and parse() compile down to a copy per segment with no signature
+ *          bit walking. Segments may be listed in any order, they are still
+ *          packed in ascending signature bit order on the wire
+ *
+ * @tparam Ts Segment structs in the message such as def::IMU_t
+ */
+template< typename... Ts >
+struct Schema
+{
+    //! Signature bit field of every message built with this schema
+    static constexpr uint16_t signature = schema::signature_of( schema::Pack< Ts... >() );
+
+    //! Payload length in bytes
+    static constexpr size_t length = schema::length_of( schema::Pack< Ts... >() );
+
+    //! Total frame size in bytes including header and footer
+    static constexpr size_t frame_size = def::frame_size( def::INTEGRITY, length );
+
+    static_assert( schema::unique( schema::Pack< Ts... >() ), "A segment can only appear once in a schema" );
+    static_assert( length <= def::MAX_PAYLOAD_SIZE, "Schema segments do not fit in the message payload" );
+
+    /**
+     * @brief Offset of a segment from the start of the payload
+     *
+     * @tparam T Segment struct in the schema
+     * @return size_t Byte offset
+     */
+    template< typename T >
+    static constexpr size_t offset( void )
+    {
+        static_assert( ( signature & schema::bit_of< T >() ) != 0, "Segment is not part of the schema" );
+        return schema::offset_of( schema::bit_of< T >(), schema::Pack< Ts... >() );
+    }
+
+    /**
+     * @brief Build a frame
+     *
+     * @param buf Buffer of at least frame_size bytes
+     * @param from Sender of the message
+     * @param to Receiver of the message
+     * @param segments One struct for every segment in the schema, in schema order
+     * @return size_t Number of bytes written which is always frame_size
+     */
+    static size_t build( uint8_t* buf, def::ID from, def::ID to, const Ts&... segments )
+    {
+        const uint16_t sig = signature | def::INTEGRITY;
+        const uint16_t len = length;
+
+        buf[ 0 ] = def::START_BYTE;
+        buf[ 1 ] = def::link( from, to );
+        def::store_u16( buf + 2, sig );
+        def::store_u16( buf + 4, len );
+
+        uint8_t* payload = buf + def::HEADER_SIZE;
+        int expand[] = { 0, ( memcpy( payload + offset< Ts >(), &segments, sizeof( Ts ) ), 0 )... };
+        (void) expand;
+
+        def::seal( buf, sig, length );
+
+        return frame_size;
+    }
+
+    /**
+     * @brief Build a frame into message storage
+     *
+     * @param message Storage to build into
+     * @param from Sender of the message
+     * @param to Receiver of the message
+     * @param segments One struct for every segment in the schema, in schema order
+     * @return size_t Number of bytes written which is always frame_size
+     */
+    static size_t build( def::RawMessage_t& message, def::ID from, def::ID to, const Ts&... segments )
+    {
+        return build( reinterpret_cast< uint8_t* >( &message ), from, to, segments... );
+    }
+
+    /**
+     * @brief Parse a frame built with this schema
+     *
+     * @param buf Pointer to the start byte of a frame
+     * @param len Number of readable bytes in buf
+     * @param segments One struct for every segment in the schema, in schema order
+     * @return true if the frame matches the schema and is intact
+     * @return false if the frame is invalid or has another signature. segments are unchanged
+     */
+    static bool parse( const uint8_t* buf, size_t len, Ts&... segments )
+    {
+        if( !check( buf, len ) )
+            return false;
+
+        const uint8_t* payload = buf + def::HEADER_SIZE;
+        int expand[] = { 0, ( memcpy( &segments, payload + offset< Ts >(), sizeof( Ts ) ), 0 )... };
+        (void) expand;
+
+        return true;
+    }
+
+    /**
+     * @brief Check that a frame was built with this schema and is intact
+     *
+     * @param buf Pointer to the start byte of a frame
+     * @param len Number of readable bytes in buf
+     * @return true if the frame matches the schema
+     * @return false if it doesn't
+     */
+    static bool check( const uint8_t* buf, size_t len )
+    {
+        if( buf == NULL || len < def::HEADER_SIZE || buf[ 0 ] != def::START_BYTE )
+            return false;
+
+        uint16_t sig = def::load_u16( buf + 2 );
+        uint16_t len_field = def::load_u16( buf + 4 );
+
+        // Either crc is accepted, only the segments have to match
+        return ( sig & ~def::CRC32_FLAG ) == signature && len_field == length
+               && len >= def::frame_size( sig, length ) && def::sealed( buf, sig, length );
+    }
+};
+
+// Out of class definitions so the constants can be bound to references
+template< typename... Ts > constexpr uint16_t Schema< Ts... >::signature;
+template< typename... Ts > constexpr size_t Schema< Ts... >::length;
+template< typename... Ts > constexpr size_t Schema< Ts... >::frame_size;
+
+} // End of namespace aero
+
+/*! @} End of Doxygen Groups*/
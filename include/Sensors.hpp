@@ -7,6 +7,7 @@
 #endif
 
 #include "Data.hpp"
+#include "Snapshot.hpp"
 
 /*!
  *  \addtogroup aero
@@ -58,7 +59,7 @@ public:
     bool init( IMU::Config_t config )
     {
         m_config = config;
-        init();
+        return init();
     }
 
     /**
@@ -72,10 +73,54 @@ public:
     /**
      * @brief Get imu data
      * 
+     * @details Working copy that update() fills in. Only read it from the
+     *          code that calls update(), anywhere else use sample()
+     * 
      * @return const def::IMU_t& reference to IMU's data struct
      */
     const def::IMU_t& data(void) { return m_data; }
 
+    /**
+     * @brief Get the latest published IMU data
+     * 
+     * @details Safe to call while update() runs in an interrupt or another
+     *          thread, the copy is never half updated
+     * 
+     * @return Sample< def::IMU_t > copy of the data with its capture time and sequence number
+     */
+    Sample< def::IMU_t > sample(void) const { return m_snapshot.read(); }
+
+    /**
+     * @brief Get the latest published IMU data if it is newer than a sample already held
+     * 
+     * @param held sample from an earlier call, replaced if stale
+     * @return true if there was newer data
+     * @return false if the sample was already the latest
+     */
+    bool sample(Sample< def::IMU_t >& held) const { return m_snapshot.read_newer( held ); }
+
+    /**
+     * @brief Fills in fields derived from the raw readings, like attitude
+     * 
+     * @param data IMU data about to be published
+     * @param context pointer given to fuse()
+     */
+    typedef void (*Fusion)(def::IMU_t& data, void* context);
+
+    /**
+     * @brief Run a function on the data each time it is published
+     * 
+     * @details See ahrs::attach() for the attitude filters
+     * 
+     * @param function called from publish() before readers see the data, NULL to stop
+     * @param context passed through to the function
+     */
+    void fuse(Fusion function, void* context)
+    {
+        m_fusion = function;
+        m_fusion_context = context;
+    }
+
     /**
      * @brief Destructor
      */
@@ -83,11 +128,27 @@ public:
 
 protected:
     // Hidden constructor that only children can redefine
-    IMU(){}
+    IMU() : m_fusion( NULL ), m_fusion_context( NULL ) {}
+
+    /**
+     * @brief Publish m_data to sample() readers, called at the end of update()
+     * 
+     * @param time_us capture time in microseconds, now_us() by default
+     */
+    void publish(uint32_t time_us)
+    {
+        if( m_fusion != NULL )
+            m_fusion( m_data, m_fusion_context );
+        m_snapshot.publish( m_data, time_us );
+    }
+    void publish(void) { publish( now_us() ); }
 
     // Member variables
     def::IMU_t m_data;      // For imu data
+    Snapshot< def::IMU_t > m_snapshot; // For published imu data
     IMU::Config_t m_config; // For imu configuration
+    Fusion m_fusion;        // Run on the data before it is published
+    void* m_fusion_context; // For the fusion function
 };
 
 /**
@@ -123,7 +184,7 @@ public:
     bool init( GPS::Config_t config )
     {
         m_config = config;
-        init();
+        return init();
     }
 
     /**
@@ -137,10 +198,39 @@ public:
     /**
      * @brief Get GPS data
      * 
+     * @details Working copy that update() fills in. Only read it from the
+     *          code that calls update(), anywhere else use sample()
+     * 
      * @return const def::GPS_t& reference to GPS's data struct
      */
     const def::GPS_t& data(void) { return m_data; }
 
+    /**
+     * @brief Get the latest published GPS data
+     * 
+     * @details Safe to call while update() runs in an interrupt or another
+     *          thread, the copy is never half updated
+     * 
+     * @return Sample< def::GPS_t > copy of the data with its capture time and sequence number
+     */
+    Sample< def::GPS_t > sample(void) const { return m_snapshot.read(); }
+
+    /**
+     * @brief Get the latest published GPS data if it is newer than a sample already held
+     * 
+     * @param held sample from an earlier call, replaced if stale
+     * @return true if there was newer data
+     * @return false if the sample was already the latest
+     */
+    bool sample(Sample< def::GPS_t >& held) const { return m_snapshot.read_newer( held ); }
+
+    /**
+     * @brief Get GPS configuration
+     * 
+     * @return const GPS::Config_t& reference to the configuration given to init
+     */
+    const GPS::Config_t& config(void) { return m_config; }
+
     /**
      * @brief Destructor
      */
@@ -150,8 +240,17 @@ protected:
     // Hidden constructor that only children can redefine
     GPS(){}
 
+    /**
+     * @brief Publish m_data to sample() readers, called at the end of update()
+     * 
+     * @param time_us capture time in microseconds, now_us() by default
+     */
+    void publish(uint32_t time_us) { m_snapshot.publish( m_data, time_us ); }
+    void publish(void) { m_snapshot.publish( m_data ); }
+
     // Member variables
     def::GPS_t m_data;      // For gps data
+    Snapshot< def::GPS_t > m_snapshot; // For published gps data
     GPS::Config_t m_config; // For gps configuration
 };
 
@@ -186,7 +285,7 @@ public:
     bool init( Pitot::Config_t config )
     {
         m_config = config;
-        init();
+        return init();
     }
 
     /**
@@ -200,10 +299,32 @@ public:
     /**
      * @brief Get pitot tube data
      * 
+     * @details Working copy that update() fills in. Only read it from the
+     *          code that calls update(), anywhere else use sample()
+     * 
      * @return const def::Pitot_t& reference to pitot tube's data struct
      */
     const def::Pitot_t& data(void) { return m_data; }
 
+    /**
+     * @brief Get the latest published pitot tube data
+     * 
+     * @details Safe to call while update() runs in an interrupt or another
+     *          thread, the copy is never half updated
+     * 
+     * @return Sample< def::Pitot_t > copy of the data with its capture time and sequence number
+     */
+    Sample< def::Pitot_t > sample(void) const { return m_snapshot.read(); }
+
+    /**
+     * @brief Get the latest published pitot tube data if it is newer than a sample already held
+     * 
+     * @param held sample from an earlier call, replaced if stale
+     * @return true if there was newer data
+     * @return false if the sample was already the latest
+     */
+    bool sample(Sample< def::Pitot_t >& held) const { return m_snapshot.read_newer( held ); }
+
     /**
      * @brief Destructor
      */
@@ -213,8 +334,17 @@ protected:
     // Hidden constructor that only children can redefine
     Pitot(){}
 
+    /**
+     * @brief Publish m_data to sample() readers, called at the end of update()
+     * 
+     * @param time_us capture time in microseconds, now_us() by default
+     */
+    void publish(uint32_t time_us) { m_snapshot.publish( m_data, time_us ); }
+    void publish(void) { m_snapshot.publish( m_data ); }
+
     // Member variables
     def::Pitot_t m_data;      // For pitot tube data
+    Snapshot< def::Pitot_t > m_snapshot; // For published pitot tube data
     Pitot::Config_t m_config; // For pitot tube configuration
 };
 
@@ -249,7 +379,7 @@ public:
     bool init( EnviroSensor::Config_t config )
     {
         m_config = config;
-        init();
+        return init();
     }
 
     /**
@@ -263,10 +393,32 @@ public:
     /**
      * @brief Get environmental sensor data
      * 
+     * @details Working copy that update() fills in. Only read it from the
+     *          code that calls update(), anywhere else use sample()
+     * 
      * @return const def::Enviro_t& reference to environmental sensor's data struct
      */
     const def::Enviro_t& data(void) { return m_data; }
 
+    /**
+     * @brief Get the latest published environmental sensor data
+     * 
+     * @details Safe to call while update() runs in an interrupt or another
+     *          thread, the copy is never half updated
+     * 
+     * @return Sample< def::Enviro_t > copy of the data with its capture time and sequence number
+     */
+    Sample< def::Enviro_t > sample(void) const { return m_snapshot.read(); }
+
+    /**
+     * @brief Get the latest published environmental sensor data if it is newer than a sample already held
+     * 
+     * @param held sample from an earlier call, replaced if stale
+     * @return true if there was newer data
+     * @return false if the sample was already the latest
+     */
+    bool sample(Sample< def::Enviro_t >& held) const { return m_snapshot.read_newer( held ); }
+
     /**
      * @brief Destructor
      */
@@ -276,8 +428,17 @@ protected:
     // Hidden constructor that only children can redefine
     EnviroSensor(){}
 
+    /**
+     * @brief Publish m_data to sample() readers, called at the end of update()
+     * 
+     * @param time_us capture time in microseconds, now_us() by default
+     */
+    void publish(uint32_t time_us) { m_snapshot.publish( m_data, time_us ); }
+    void publish(void) { m_snapshot.publish( m_data ); }
+
     // Member variables
     def::Enviro_t m_data;      // For environmental sensor data
+    Snapshot< def::Enviro_t > m_snapshot; // For published environmental sensor data
     EnviroSensor::Config_t m_config; // For environmental sensor configuration
 };
 
@@ -336,10 +497,32 @@ public:
     /**
      * @brief Get radio sensor data
      * 
+     * @details Working copy that update() fills in. Only read it from the
+     *          code that calls update(), anywhere else use sample()
+     * 
      * @return const def::Radio_t& reference to radio's data struct
      */
     const def::Radio_t& data(void) { return m_data; }
 
+    /**
+     * @brief Get the latest published radio data
+     * 
+     * @details Safe to call while update() runs in an interrupt or another
+     *          thread, the copy is never half updated
+     * 
+     * @return Sample< def::Radio_t > copy of the data with its capture time and sequence number
+     */
+    Sample< def::Radio_t > sample(void) const { return m_snapshot.read(); }
+
+    /**
+     * @brief Get the latest published radio data if it is newer than a sample already held
+     * 
+     * @param held sample from an earlier call, replaced if stale
+     * @return true if there was newer data
+     * @return false if the sample was already the latest
+     */
+    bool sample(Sample< def::Radio_t >& held) const { return m_snapshot.read_newer( held ); }
+
     /**
      * @brief Destructor
      */
@@ -349,8 +532,17 @@ protected:
     // Hidden constructor that only children can redefine
     Radio(){}
 
+    /**
+     * @brief Publish m_data to sample() readers, called at the end of update()
+     * 
+     * @param time_us capture time in microseconds, now_us() by default
+     */
+    void publish(uint32_t time_us) { m_snapshot.publish( m_data, time_us ); }
+    void publish(void) { m_snapshot.publish( m_data ); }
+
     // Member variables
     def::Radio_t m_data;      // For environmental sensor data
+    Snapshot< def::Radio_t > m_snapshot; // For published radio data
     size_t RECEIVE_BUFFER_SIZE;
 };
 
@@ -5,6 +5,7 @@
 
 #include "Arduino.h"
 #include "Message.hpp"
+#include "FrameDecoder.hpp"
 #include "Utility.hpp"
 
 /*!
@@ -27,31 +28,71 @@ namespace serial
     
 namespace
 {
-    const size_t BUFFER_SPACE = 256;
-
-    // This is currently the size from python. If message size changes, change this const
-    const int MSG_SIZE = 181;
+    const size_t BUFFER_SPACE = def::MAX_FRAME_SIZE;
 
     char buffer[BUFFER_SPACE];
     int buf_index = 0;
+    bool received = false;
+
+    // Keep the last valid frame for msg_contents
+    void store_frame( const MessageView& frame, void* )
+    {
+        memcpy( buffer, frame.data(), frame.size() );
+        buf_index = frame.size();
+        received = true;
+    }
+
+    FrameDecoder decoder( store_frame );
 }
 
-// Copy message contents into new buffer
+// Copy last message into new buffer. buf needs def::MAX_FRAME_SIZE bytes
 inline int msg_contents(char* buf) {
 
-    for(int i = 0; i < BUFFER_SPACE; i++) {
+    for(int i = 0; i < buf_index; i++) {
         buf[i] = buffer[i];
     }
     
     return buf_index;
 }
 
+/**
+ * @brief Feed all bytes waiting on a port into a frame decoder
+ *
+ * @details Reads in chunks and never waits for more bytes. A frame that is
+ *          only partly received stays in the decoder for the next call
+ *
+ * @param port Reference to serial port you want to read from
+ * @param frames Decoder that receives the bytes
+ * @return size_t Number of valid frames decoded
+ */
+inline size_t read( Stream& port, FrameDecoder& frames )
+{
+    uint8_t chunk[ 64 ];
+    size_t found = 0;
+    int available;
+
+    while( ( available = port.available() ) > 0 )
+    {
+        size_t want = (size_t) available < sizeof( chunk ) ? available : sizeof( chunk );
+        size_t n = port.readBytes( (char*) chunk, want );
+
+        if( n == 0 )
+            break;
+
+        found += frames.feed( chunk, n );
+    }
+
+    return found;
+}
+
 /**
  * @brief Read a message
  * 
- * @details This code is blocking while their is serial port activity
- *          and designed for Arduino/Teensy. If their is no serial port activity
- *          the returned message while contain all null parsed segments
+ * @details Reads whatever bytes are waiting on the port and returns. A
+ *          frame split between calls is kept until the rest arrives. The
+ *          last valid frame can be copied out with msg_contents. Only one
+ *          port can use this, give each port its own FrameDecoder and
+ *          use read() instead
  * 
  * @param port Reference to serial port you want to read from
  * @param debug Default false. Set to true if you want function to print debug messages
@@ -59,52 +100,16 @@ inline int msg_contents(char* buf) {
  */
 inline bool check_for_msg( Stream& port, bool debug = false )
 {
-    
-    // Boolean flags for reading data
-    bool started = false, ended = false, filled = false;
-    // Reset buffer index
-    buf_index = 0;
+    received = false;
+    read( port, decoder );
 
-    // Read from buffer only when available
-    while( port.available() )
+    if( debug && received )
     {
-        char in_byte = port.read();
-        // Serial.println(in_byte);
-        // If byte is start byte and we havent reached the start byte yet
-        if( in_byte == def::START_BYTE && started == false )
-        {
-            buffer[ buf_index++ ] = in_byte;
-            started = true;
-            // Serial.println("Reached start");
-        }
-
-        // If byte is end byte and we have reached the start but not the end
-        else if( in_byte == def::END_BYTE && buf_index == MSG_SIZE - 1 && started == true && ended == false )
-        //else if( in_byte == def::END_BYTE && started == true && ended == false )
-        {
-            buffer[ buf_index++ ] = in_byte;
-            ended = true;
-            // Serial.println("Reached end");
-        }
-        // If the byte is not the end byte
-        else if( started == true && ended == false )
-        {
-            if( buf_index < BUFFER_SPACE - 1)
-            {
-                buffer[ buf_index++ ] = in_byte;
-            }
-        }
-
-        // We have gotten a full message if both started and ended are true
-        if( started == true && ended == true )
-        {
-            // Serial.println("Reached full");
-            return true;
-        }
+        Serial.print( "Frame received, bytes dropped: " );
+        Serial.println( decoder.dropped() );
     }
-    
-    
-    return false;
+
+    return received;
 }
 
 /**
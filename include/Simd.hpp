@@ -0,0 +1,158 @@
+#pragma once
+
+#include "Utility.hpp"
+
+// Vector instructions of the host. The boards and other hosts get plain
+// loops, so nothing here is needed to build for them
+#if !defined(ARDUINO) && defined(__x86_64__) && ( defined(__GNUC__) || defined(__clang__) )
+    #include <immintrin.h>
+    #define AERO_SIMD_X86
+#elif !defined(ARDUINO) && defined(__aarch64__) && defined(__ARM_NEON)
+    #include <arm_neon.h>
+    #define AERO_SIMD_NEON
+#endif
+
+/*!
+ *  \addtogroup aero
+ *  @{
+ */
+
+//! Aero library code
+namespace aero
+{
+
+/*!
+ *  \addtogroup bit
+ *  @{
+ */
+
+//! Binary-level helper functions
+namespace bit
+{
+#if defined(AERO_SIMD_X86)
+    // pshufb needs SSSE3 which isn't in the x86-64 baseline, so it is
+    // checked for at run time like the AVX2 conversions
+    #define AERO_SSSE3 __attribute__(( target( "ssse3" ) ))
+
+    namespace detail
+    {
+        inline bool has_ssse3( void )
+        {
+            static const bool supported = __builtin_cpu_supports( "ssse3" );
+            return supported;
+        }
+
+        AERO_SSSE3 inline void shuffle_ssse3( uint8_t* data, size_t blocks, const uint8_t* masks, size_t mask_blocks )
+        {
+            // Arrays of one type keep their single mask in a register
+            if( mask_blocks == 1 )
+            {
+                __m128i mask = _mm_loadu_si128( reinterpret_cast< const __m128i* >( masks ) );
+
+                for( size_t b = 0; b < blocks; ++b )
+                {
+                    __m128i block = _mm_loadu_si128( reinterpret_cast< const __m128i* >( data + 16 * b ) );
+                    _mm_storeu_si128( reinterpret_cast< __m128i* >( data + 16 * b ), _mm_shuffle_epi8( block, mask ) );
+                }
+                return;
+            }
+
+            for( size_t b = 0, m = 0; b < blocks; ++b, m = m + 1 == mask_blocks ? 0 : m + 1 )
+            {
+                __m128i mask = _mm_loadu_si128( reinterpret_cast< const __m128i* >( masks + 16 * m ) );
+                __m128i block = _mm_loadu_si128( reinterpret_cast< const __m128i* >( data + 16 * b ) );
+                _mm_storeu_si128( reinterpret_cast< __m128i* >( data + 16 * b ), _mm_shuffle_epi8( block, mask ) );
+            }
+        }
+    }
+#endif
+
+    /**
+     * @brief Reorder the bytes of consecutive 16 byte blocks in place
+     *
+     * @details Block b is rearranged by mask b % mask_blocks, out[ i ] = in[ mask[ i ] ].
+     *          Uses one byte shuffle instruction per block where the host has
+     *          one (SSSE3 or NEON), otherwise a copy of the block
+     *
+     * @param data Start of the blocks, no alignment needed
+     * @param blocks Number of 16 byte blocks
+     * @param masks mask_blocks masks of 16 indices from 0 to 15
+     * @param mask_blocks Number of masks before they repeat
+     */
+    inline void shuffle( uint8_t* data, size_t blocks, const uint8_t* masks, size_t mask_blocks )
+    {
+#if defined(AERO_SIMD_X86)
+        if( detail::has_ssse3() )
+        {
+            detail::shuffle_ssse3( data, blocks, masks, mask_blocks );
+            return;
+        }
+#elif defined(AERO_SIMD_NEON)
+        for( size_t b = 0, m = 0; b < blocks; ++b, m = m + 1 == mask_blocks ? 0 : m + 1 )
+            vst1q_u8( data + 16 * b, vqtbl1q_u8( vld1q_u8( data + 16 * b ), vld1q_u8( masks + 16 * m ) ) );
+        return;
+#endif
+
+        for( size_t b = 0, m = 0; b < blocks; ++b, m = m + 1 == mask_blocks ? 0 : m + 1 )
+        {
+            uint8_t block[ 16 ];
+            memcpy( block, data + 16 * b, 16 );
+
+            for( size_t i = 0; i < 16; ++i )
+                data[ 16 * b + i ] = block[ masks[ 16 * m + i ] ];
+        }
+    }
+
+    namespace detail
+    {
+        /**
+         * @brief Source of byte i of a block when every n byte value is reversed
+         */
+        constexpr uint8_t reversed_index( size_t i, size_t n )
+        {
+            return static_cast< uint8_t >( i - i % n + n - 1 - i % n );
+        }
+
+        // One mask per size shared by every translation unit
+        template< size_t N >
+        struct Reversed
+        {
+            static constexpr uint8_t mask[ 16 ] = {
+                reversed_index( 0, N ), reversed_index( 1, N ), reversed_index( 2, N ), reversed_index( 3, N ),
+                reversed_index( 4, N ), reversed_index( 5, N ), reversed_index( 6, N ), reversed_index( 7, N ),
+                reversed_index( 8, N ), reversed_index( 9, N ), reversed_index( 10, N ), reversed_index( 11, N ),
+                reversed_index( 12, N ), reversed_index( 13, N ), reversed_index( 14, N ), reversed_index( 15, N ) };
+        };
+
+        template< size_t N > constexpr uint8_t Reversed< N >::mask[ 16 ];
+    }
+
+    /**
+     * @brief Swap endian order of every value of an array in place
+     *
+     * @param values Array to swap
+     * @param count Number of values
+     */
+    template< typename T >
+    inline void swap_endian( T* values, size_t count )
+    {
+        size_t done = 0;
+
+        if( sizeof( T ) > 1 && 16 % sizeof( T ) == 0 )
+        {
+            size_t blocks = count * sizeof( T ) / 16;
+
+            shuffle( reinterpret_cast< uint8_t* >( values ), blocks, detail::Reversed< sizeof( T ) >::mask, 1 );
+            done = blocks * 16 / sizeof( T );
+        }
+
+        for( size_t i = done; i < count; ++i )
+            values[ i ] = swap_endian( values[ i ] );
+    }
+} // End of namespace bit
+
+/*! @} End of Doxygen Groups*/
+
+} // End of namespace aero
+
+/*! @} End of Doxygen Groups*/
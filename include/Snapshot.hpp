@@ -0,0 +1,175 @@
+#pragma once
+
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    #include "Arduino.h"
+#else
+    #include <cstddef>
+    #include <cstdint>
+    #include <chrono>
+#endif
+
+/*!
+ *  \addtogroup aero
+ *  @{
+ */
+
+//! Aero library code
+namespace aero
+{
+
+// Default version type. AVR can only load a single byte atomically
+#if defined(__AVR__)
+    typedef uint8_t SnapshotVersion;
+#else
+    typedef uint32_t SnapshotVersion;
+#endif
+
+/**
+ * @brief Monotonic time in microseconds, wraps like micros() does
+ */
+inline uint32_t now_us( void )
+{
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    return micros();
+#else
+    return static_cast< uint32_t >( std::chrono::duration_cast< std::chrono::microseconds >(
+        std::chrono::steady_clock::now().time_since_epoch() ).count() );
+#endif
+}
+
+/**
+ * @brief Published value with when it was captured
+ */
+template< typename T >
+struct Sample
+{
+    T data;             // Value
+    uint32_t time_us;   // Capture time from now_us() or the caller [ us ]
+    uint32_t sequence;  // Count of samples published, 0 before the first
+};
+
+/**
+ * @brief Latest value of something written by one side and read by others
+ *
+ * @details A seqlock over two copies of the sample. The writer bumps the
+ *          version to steer readers at one copy while it rewrites the
+ *          other, then does the same the other way round. Readers copy the
+ *          slot the version points at and retry only if the version moved
+ *          meanwhile. Neither side takes a lock or waits on the other, so
+ *          the writer can be an interrupt that preempts a reader or a
+ *          reader can be an interrupt that preempts the writer. A read is
+ *          at most one sample behind while a write is in progress
+ *
+ *          There must be a single writer. On AVR the version is one byte,
+ *          a read only tears if 128 publishes land inside it
+ *
+ * @tparam T Value type, copied with assignment
+ * @tparam Version Unsigned version type the target can load atomically
+ */
+template< typename T, typename Version = SnapshotVersion >
+class Snapshot
+{
+public:
+    /**
+     * @brief Constructor, reads give sequence 0 until the first publish
+     */
+    Snapshot( ) : m_slots(), m_version( 0 ) {}
+
+    /**
+     * @brief Publish a new value. Writer only
+     *
+     * @param data Value to publish
+     * @param time_us Capture time in microseconds
+     */
+    void publish( const T& data, uint32_t time_us )
+    {
+        Version version = __atomic_load_n( &m_version, __ATOMIC_RELAXED );
+        uint32_t sequence = m_slots[ version & 1 ].sequence + 1;
+
+        for( Version i = 1; i <= 2; ++i )
+        {
+            // Readers move to the other copy, which is complete, before
+            // this one is touched
+            __atomic_store_n( &m_version, static_cast< Version >( version + i ), __ATOMIC_RELEASE );
+            __atomic_thread_fence( __ATOMIC_RELEASE );
+
+            Sample< T >& slot = m_slots[ ( version + i + 1 ) & 1 ];
+            slot.data = data;
+            slot.time_us = time_us;
+            slot.sequence = sequence;
+        }
+    }
+
+    /**
+     * @brief Publish a new value captured now. Writer only
+     *
+     * @param data Value to publish
+     */
+    void publish( const T& data ) { publish( data, now_us() ); }
+
+    /**
+     * @brief Consistent copy of the latest sample
+     *
+     * @return Sample< T > Latest sample, sequence 0 if nothing was published
+     */
+    Sample< T > read( void ) const
+    {
+        Sample< T > sample;
+        Version version;
+
+        do
+        {
+            version = __atomic_load_n( &m_version, __ATOMIC_ACQUIRE );
+            sample = m_slots[ version & 1 ];
+            __atomic_thread_fence( __ATOMIC_ACQUIRE );
+        }
+        while( __atomic_load_n( &m_version, __ATOMIC_RELAXED ) != version );
+
+        return sample;
+    }
+
+    /**
+     * @brief Copy the latest sample only if it is newer than the one held
+     *
+     * @param sample Sample from an earlier read, replaced if there is a newer one
+     * @return true if the sample was replaced
+     * @return false if it was already the latest
+     */
+    bool read_newer( Sample< T >& sample ) const
+    {
+        if( sequence() == sample.sequence )
+            return false;
+
+        sample = read();
+        return true;
+    }
+
+    /**
+     * @brief Sequence number of the latest sample, without copying it
+     *
+     * @return uint32_t Count of samples published
+     */
+    uint32_t sequence( void ) const
+    {
+        uint32_t sequence;
+        Version version;
+
+        do
+        {
+            version = __atomic_load_n( &m_version, __ATOMIC_ACQUIRE );
+            sequence = m_slots[ version & 1 ].sequence;
+            __atomic_thread_fence( __ATOMIC_ACQUIRE );
+        }
+        while( __atomic_load_n( &m_version, __ATOMIC_RELAXED ) != version );
+
+        return sequence;
+    }
+
+private:
+    Sample< T > m_slots[ 2 ];   // Copy readers use is picked by the low bit of the version
+    Version m_version;          // Bumped twice per publish
+};
+
+} // End of namespace aero
+
+/*! @} End of Doxygen Groups*/
@@ -7,8 +7,11 @@
     #include "Arduino.h"
 #else
     #include <iostream>
+    #include <cstdio>
     #include <climits>
     #include <cstddef>
+    #include <cstdint>
+    #include <cstring>
     #include <cmath>
 #endif
 
@@ -30,10 +33,77 @@ namespace aero
 namespace bit
 {
     /**
-     * Taken from stackoverflow from some brilliant person
-     * 
+     * @brief Byte order of multi-byte values
+     */
+    enum class Order : uint8_t { Little, Big };
+
+    // Byte order of this build, known at compile time so conversions
+    // between matching orders compile to nothing
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    constexpr Order HOST_ORDER = Order::Big;
+#else
+    constexpr Order HOST_ORDER = Order::Little;
+#endif
+
+    // Byte order of every multi-byte value in a frame, log or export
+    constexpr Order WIRE_ORDER = Order::Little;
+
+    //! Byte swaps of one value
+    namespace detail
+    {
+        inline uint8_t bswap( uint8_t value ) { return value; }
+        inline uint16_t bswap( uint16_t value ) { return __builtin_bswap16( value ); }
+        inline uint32_t bswap( uint32_t value ) { return __builtin_bswap32( value ); }
+        inline uint64_t bswap( uint64_t value ) { return __builtin_bswap64( value ); }
+
+        // Unsigned word the size of a value, void if there is no swap instruction for it
+        template< size_t N > struct Word    { typedef void type; };
+        template<> struct Word< 1 >         { typedef uint8_t type; };
+        template<> struct Word< 2 >         { typedef uint16_t type; };
+        template<> struct Word< 4 >         { typedef uint32_t type; };
+        template<> struct Word< 8 >         { typedef uint64_t type; };
+
+        template< typename T, typename W >
+        struct Swap
+        {
+            static T apply( T value )
+            {
+                W word;
+                memcpy( &word, &value, sizeof( word ) );
+                word = bswap( word );
+                memcpy( &value, &word, sizeof( word ) );
+                return value;
+            }
+        };
+
+        // Odd sizes reverse the bytes one at a time
+        template< typename T >
+        struct Swap< T, void >
+        {
+            static T apply( T value )
+            {
+                unsigned char bytes[ sizeof( T ) ];
+                memcpy( bytes, &value, sizeof( T ) );
+
+                for( size_t k = 0; k < sizeof( T ) / 2; ++k )
+                {
+                    unsigned char b = bytes[ k ];
+                    bytes[ k ] = bytes[ sizeof( T ) - k - 1 ];
+                    bytes[ sizeof( T ) - k - 1 ] = b;
+                }
+
+                memcpy( &value, bytes, sizeof( T ) );
+                return value;
+            }
+        };
+    }
+
+    /**
      * @brief Used to swap endian order of a value
-     * 
+     *
+     * @details Values of 2, 4 and 8 bytes use the compiler's byte swap
+     *          builtins, a single instruction on most targets
+     *
      * @tparam T data type of value you want to swap
      * @param to_swap value you want to swap endian value of
      * @return T swapped endian order value
@@ -41,19 +111,31 @@ namespace bit
     template <typename T>
     inline T swap_endian( T to_swap )
     {
-        union
-        {
-            T to_swap;
-            unsigned char u8[ sizeof( T) ];
-        } source, dest;
-
-        // Apply union to input value
-        source.to_swap = to_swap;
+        return detail::Swap< T, typename detail::Word< sizeof( T ) >::type >::apply( to_swap );
+    }
 
-        for( size_t k = 0; k < sizeof( T ); ++k)
-            dest.u8[k] = source.u8[ sizeof( T ) - k - 1];
+    /**
+     * @brief Convert a value from host order to wire order
+     *
+     * @param value Value in host order
+     * @return T Value in little endian order, unchanged on little endian hosts
+     */
+    template< typename T >
+    inline T to_little_endian( T value )
+    {
+        return HOST_ORDER == Order::Little ? value : swap_endian( value );
+    }
 
-        return dest.to_swap;
+    /**
+     * @brief Convert a value from wire order to host order
+     *
+     * @param value Value in little endian order
+     * @return T Value in host order, unchanged on little endian hosts
+     */
+    template< typename T >
+    inline T from_little_endian( T value )
+    {
+        return to_little_endian( value );
     }
 
     /**
@@ -268,29 +350,36 @@ namespace print
 {
     /**
      * @brief Print buffer in HEX
-     * 
+     *
+     * @details Formats into a small buffer and writes it in a few large
+     *          writes instead of one per byte. Goes to Serial on the boards
+     *          and stdout on a host
+     *
      * @param buf char buffer of bytes
      * @param len Length of buffer to print
      */
-    inline void print_hex( char* buf, int len )
+    inline void print_hex( const char* buf, int len )
     {
-        for( size_t i = 0; i < len; ++i )
+        static const char HEX_DIGITS[] = "0123456789ABCDEF";
+        char out[ 63 ];     // 21 bytes a write
+        size_t used = 0;
+
+        for( int i = 0; i < len; ++i )
         {
-            char _byte = buf[i] & 0xFF;
-
-            #if defined (__AVR__)
-                // Arduino streaming library
-                #ifdef ARDUINO_STREAMING
-                    Serial << _HEX(_byte) << " ";
-                // Regular serial print
-                #else
-                    Serial.print( _byte, HEX );
-                    Serial.print( " " );
-                #endif
-            #else
-                // TODO: FIX
-                // std::cout << std::hex << " ";
-            #endif
+            uint8_t byte = static_cast< uint8_t >( buf[ i ] );
+            out[ used++ ] = HEX_DIGITS[ byte >> 4 ];
+            out[ used++ ] = HEX_DIGITS[ byte & 0x0F ];
+            out[ used++ ] = ' ';
+
+            if( used == sizeof( out ) || i + 1 == len )
+            {
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+                Serial.write( reinterpret_cast< const uint8_t* >( out ), used );
+#else
+                fwrite( out, 1, used, stdout );
+#endif
+                used = 0;
+            }
         }
     }
 } // End of namespace print
@@ -0,0 +1,208 @@
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+// File for testing the attitude filters
+#include <gtest/gtest.h>
+#include <iostream>
+#include <cmath>
+#include <vector>
+#include "../include/Ahrs.hpp"
+
+namespace
+{
+    using aero::ahrs::Quaternion;
+
+    // Orientation from yaw, pitch and roll in degrees
+    Quaternion from_euler( float yaw, float pitch, float roll )
+    {
+        float cy = cosf( yaw * aero::ahrs::RAD_PER_DEG / 2 ), sy = sinf( yaw * aero::ahrs::RAD_PER_DEG / 2 );
+        float cp = cosf( pitch * aero::ahrs::RAD_PER_DEG / 2 ), sp = sinf( pitch * aero::ahrs::RAD_PER_DEG / 2 );
+        float cr = cosf( roll * aero::ahrs::RAD_PER_DEG / 2 ), sr = sinf( roll * aero::ahrs::RAD_PER_DEG / 2 );
+
+        Quaternion q = { cr * cp * cy + sr * sp * sy, sr * cp * cy - cr * sp * sy,
+                         cr * sp * cy + sr * cp * sy, cr * cp * sy - sr * sp * cy };
+        return q;
+    }
+
+    // What a still sensor at an orientation measures, 1 g and a field 60 degrees below north
+    aero::def::IMU_t still( const Quaternion& q )
+    {
+        float q0 = q.w, q1 = q.x, q2 = q.y, q3 = q.z;
+        float bx = 25.0f, bz = 43.3f;
+
+        aero::def::IMU_t imu = {};
+        imu.ax = 2.0f * ( q1 * q3 - q0 * q2 );
+        imu.ay = 2.0f * ( q0 * q1 + q2 * q3 );
+        imu.az = q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3;
+        imu.mx = bx * ( 1.0f - 2.0f * ( q2 * q2 + q3 * q3 ) ) + 2.0f * bz * ( q1 * q3 - q0 * q2 );
+        imu.my = 2.0f * bx * ( q1 * q2 - q0 * q3 ) + 2.0f * bz * ( q0 * q1 + q2 * q3 );
+        imu.mz = 2.0f * bx * ( q0 * q2 + q1 * q3 ) + bz * ( 1.0f - 2.0f * ( q1 * q1 + q2 * q2 ) );
+        return imu;
+    }
+
+    // Run a filter on a still sensor and check where it settles
+    template< typename Filter >
+    void converges( Filter filter, bool magnetometer )
+    {
+        aero::def::IMU_t imu = still( from_euler( 40.0f, 20.0f, -30.0f ) );
+        if( !magnetometer )
+            imu.mx = imu.my = imu.mz = 0.0f;
+
+        for( int i = 0; i < 10000; ++i )
+            filter.update( imu );
+        filter.attitude( imu );
+
+        ASSERT_NEAR( imu.pitch, 20.0f, 0.2f );
+        ASSERT_NEAR( imu.roll, -30.0f, 0.2f );
+        if( magnetometer )
+            ASSERT_NEAR( imu.yaw, 40.0f, 0.2f );
+        else
+            ASSERT_NEAR( imu.yaw, 0.0f, 20.0f );
+    }
+
+    // IMU that publishes readings handed to it
+    class LoggedImu : public aero::sensor::IMU
+    {
+    public:
+        bool init( void ) override { return true; }
+
+        bool update( void ) override
+        {
+            m_data = next;
+            publish( 0 );
+            return true;
+        }
+
+        aero::def::IMU_t next;
+    };
+}
+
+// Check the conversions the filters are built on
+TEST( AhrsTest, Basics )
+{
+    using namespace aero::ahrs;
+
+    for( float x = 1e-6f; x < 1e6f; x *= 1.37f )
+        ASSERT_NEAR( Fast::inv_sqrt( x ) * sqrtf( x ), 1.0f, 7e-4f ) << x;
+
+    aero::def::IMU_t imu = {};
+    detail::euler( from_euler( -120.0f, 45.0f, 170.0f ), imu );
+    ASSERT_NEAR( imu.yaw, -120.0f, 1e-3f );
+    ASSERT_NEAR( imu.pitch, 45.0f, 1e-3f );
+    ASSERT_NEAR( imu.roll, 170.0f, 1e-3f );
+
+    // Straight up is clamped rather than NaN
+    Quaternion up = from_euler( 0.0f, 90.0f, 0.0f );
+    up.y *= 1.0001f;
+    detail::euler( up, imu );
+    ASSERT_EQ( imu.pitch, 90.0f );
+}
+
+// Both filters find the attitude of a still sensor from any start
+TEST( AhrsTest, Converges )
+{
+    using namespace aero::ahrs;
+
+    converges( Madgwick<>( 1000.0f, 0.5f ), true );
+    converges( Madgwick< Fast >( 1000.0f, 0.5f ), true );
+    converges( Madgwick<>( 1000.0f, 0.5f ), false );
+    converges( Mahony<>( 1000.0f, 5.0f ), true );
+    converges( Mahony< Fast >( 1000.0f, 5.0f ), true );
+    converges( Mahony<>( 1000.0f, 5.0f ), false );
+}
+
+// With nothing to correct them the filters integrate the gyros
+TEST( AhrsTest, Gyros )
+{
+    using namespace aero::ahrs;
+
+    aero::def::IMU_t imu = {};
+    imu.gz = 90.0f;
+
+    Madgwick<> madgwick( 1000.0f );
+    Mahony<> mahony( 500.0f );
+    for( int i = 0; i < 1000; ++i )
+    {
+        madgwick.update( imu );
+        mahony.update( imu, 0.001f );
+    }
+
+    madgwick.attitude( imu );
+    ASSERT_NEAR( imu.yaw, 90.0f, 0.01f );
+    mahony.attitude( imu );
+    ASSERT_NEAR( imu.yaw, 90.0f, 0.01f );
+    ASSERT_NEAR( imu.pitch, 0.0f, 1e-4f );
+}
+
+// The Mahony integral learns a gyro bias the proportional gain alone leaves an error for
+TEST( AhrsTest, Bias )
+{
+    using namespace aero::ahrs;
+
+    aero::def::IMU_t imu = still( from_euler( 40.0f, 20.0f, -30.0f ) );
+    imu.gx = 2.0f;
+    imu.gz = -1.0f;
+
+    Mahony<> proportional( 1000.0f, 5.0f ), integral( 1000.0f, 5.0f, 1.0f );
+    for( int i = 0; i < 30000; ++i )
+    {
+        proportional.update( imu );
+        integral.update( imu );
+    }
+
+    aero::def::IMU_t out = imu;
+    proportional.attitude( out );
+    ASSERT_GT( fabsf( out.yaw - 40.0f ), 1.0f );
+
+    integral.attitude( out );
+    ASSERT_NEAR( out.yaw, 40.0f, 0.05f );
+    ASSERT_NEAR( out.pitch, 20.0f, 0.05f );
+    ASSERT_NEAR( out.roll, -30.0f, 0.05f );
+}
+
+// Attached filters fill the attitude of published samples and logs replay the same
+TEST( AhrsTest, AttachAndProcess )
+{
+    using namespace aero::ahrs;
+
+    std::vector< aero::def::IMU_t > log;
+    std::vector< uint64_t > times;
+    for( int i = 0; i < 200; ++i )
+    {
+        aero::def::IMU_t imu = still( from_euler( 10.0f, 5.0f + 0.1f * i, 0.0f ) );
+        imu.gy = 100.0f;
+        log.push_back( imu );
+        times.push_back( 1000000000ull + i * 1000 );
+    }
+
+    LoggedImu sensor;
+    Madgwick<> live( 1000.0f );
+    attach( sensor, live );
+
+    Madgwick<> fixed( 1000.0f ), stamped( 1000.0f );
+    std::vector< aero::def::IMU_t > by_fixed = log, by_stamped = log;
+    process( fixed, by_fixed.data(), by_fixed.size() );
+    process( stamped, by_stamped.data(), times.data(), by_stamped.size() );
+
+    for( size_t i = 0; i < log.size(); ++i )
+    {
+        sensor.next = log[ i ];
+        sensor.update();
+        aero::def::IMU_t published = sensor.sample().data;
+
+        ASSERT_EQ( published.roll, by_fixed[ i ].roll );
+        ASSERT_EQ( published.pitch, by_fixed[ i ].pitch );
+        ASSERT_EQ( published.yaw, by_fixed[ i ].yaw );
+        ASSERT_NEAR( by_stamped[ i ].pitch, by_fixed[ i ].pitch, 1e-3f );
+    }
+
+    // Detached samples go out untouched
+    sensor.fuse( NULL, NULL );
+    sensor.next = log[ 0 ];
+    sensor.update();
+    ASSERT_EQ( sensor.sample().data.pitch, 0.0f );
+}
+
+#endif
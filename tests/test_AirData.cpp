@@ -0,0 +1,131 @@
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+// File for testing the air data computer
+#include <gtest/gtest.h>
+#include <iostream>
+#include <cstdlib>
+#include "../include/AirData.hpp"
+
+namespace
+{
+    uint32_t bits( float value )
+    {
+        return static_cast< uint32_t >( aero::fixed::Q16_16::from_float( value ).raw );
+    }
+
+    float value( uint32_t bits )
+    {
+        return aero::fixed::Q16_16::from_raw( static_cast< int32_t >( bits ) ).to_float();
+    }
+
+    // Within a part in 10^5 and an absolute error, a couple of Q16.16 steps
+    // by default. Altitudes come from 1 - powf near 1, where a float step
+    // of the pressure ratio is already a few mm
+    void near( uint32_t bits, float expected, float error = 4e-5f )
+    {
+        ASSERT_NEAR( value( bits ), expected, 1e-5f * fabsf( expected ) + error );
+    }
+}
+
+// Every field matches the convert:: functions called one by one, bit for
+// bit apart from the two that use the cached inverse temperature
+TEST( AirDataTest, MatchesConvert )
+{
+    using namespace aero;
+
+    convert::AirDataComputer::Config_t config = { 250.0f, 262.0f };
+    convert::AirDataComputer air( config );
+    def::AirData_t out;
+
+    srand( 23 );
+    for( int i = 0; i < 2000; ++i )
+    {
+        def::Pitot_t pitot = { 2000.0f * rand() / RAND_MAX };
+        def::Enviro_t enviro = { 0.0f, -20.0f + 50.0f * rand() / RAND_MAX, 70000.0f + 35000.0f * rand() / RAND_MAX };
+        air.update( pitot, enviro, out );
+
+        float dp = pitot.differential_pressure, p = enviro.pressure, t = enviro.temperature;
+        float ias = convert::cal_as( dp );
+        float agl = convert::above_gnd_altitude( p, config.ground_altitude );
+
+        ASSERT_EQ( out.ias, bits( ias ) );
+        ASSERT_EQ( out.eas, bits( convert::equiv_as( dp, p ) ) );
+        ASSERT_EQ( out.tas, bits( convert::true_as( ias, t ) ) );
+        ASSERT_EQ( out.pressure_alt, bits( convert::pressure_altitude( p ) ) );
+        ASSERT_EQ( out.agl, bits( agl ) );
+        ASSERT_EQ( out.msl, bits( convert::mean_sl_altitude( agl, config.start_altitude ) ) );
+        ASSERT_EQ( out.approx_temp, bits( convert::approx_temp( t, agl ) ) );
+        near( out.density_alt, convert::density_altitude( p, t ), 0.02f );
+        near( out.density, convert::approx_density( p, t ) );
+    }
+}
+
+// Only outputs whose inputs changed are worked out again
+TEST( AirDataTest, SkipsUnchanged )
+{
+    using namespace aero;
+    typedef convert::AirDataComputer Air;
+
+    Air air;
+    def::AirData_t out;
+    def::Pitot_t pitot = { 150.0f };
+    def::Enviro_t enviro = { 0.0f, 18.0f, 98000.0f };
+
+    ASSERT_EQ( air.update( pitot, enviro, out ), Air::IAS | Air::EAS | Air::TAS | Air::ALTITUDE | Air::DENSITY );
+    ASSERT_EQ( air.update( pitot, enviro, out ), 0 );
+
+    pitot.differential_pressure = 160.0f;
+    ASSERT_EQ( air.update( pitot, enviro, out ), Air::IAS | Air::EAS | Air::TAS );
+
+    enviro.temperature = 17.5f;
+    ASSERT_EQ( air.update( pitot, enviro, out ), Air::TAS | Air::DENSITY );
+
+    enviro.pressure = 97990.0f;
+    ASSERT_EQ( air.update( pitot, enviro, out ), Air::EAS | Air::ALTITUDE | Air::DENSITY );
+
+    // Skipped outputs keep their values
+    def::AirData_t before = out;
+    pitot.differential_pressure = 0.0f;
+    air.update( pitot, enviro, out );
+    ASSERT_EQ( out.ias, 0u );
+    ASSERT_EQ( out.density, before.density );
+    ASSERT_EQ( out.msl, before.msl );
+
+    // Published samples are skipped by sequence number
+    Sample< def::Pitot_t > pitot_sample = { pitot, 0, 5 };
+    Sample< def::Enviro_t > enviro_sample = { enviro, 0, 9 };
+    air.update( pitot_sample, enviro_sample, out );
+    pitot_sample.data.differential_pressure = 500.0f;
+    ASSERT_EQ( air.update( pitot_sample, enviro_sample, out ), 0 );
+    pitot_sample.sequence = 6;
+    ASSERT_EQ( air.update( pitot_sample, enviro_sample, out ), Air::IAS | Air::EAS | Air::TAS );
+}
+
+// Altitudes are measured from the ground once it is set
+TEST( AirDataTest, Ground )
+{
+    using namespace aero;
+
+    convert::AirDataComputer air;
+    def::AirData_t out;
+    def::Pitot_t pitot = { 0.0f };
+    def::Enviro_t field = { 0.0f, 20.0f, 97500.0f };
+
+    air.ground( field, 262.0f );
+    air.update( pitot, field, out );
+    ASSERT_EQ( out.agl, 0u );
+    near( out.msl, 262.0f );
+    near( out.approx_temp, 20.0f );
+    near( out.pressure_alt, convert::pressure_altitude( 97500.0f ) );
+
+    // 10 m of climb is about 117 Pa down here
+    def::Enviro_t climb = { 0.0f, 20.0f, 97383.0f };
+    air.update( pitot, climb, out );
+    ASSERT_NEAR( value( out.agl ), 10.0f, 0.2f );
+    ASSERT_NEAR( value( out.msl ), 272.0f, 0.2f );
+}
+
+#endif
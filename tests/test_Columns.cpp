@@ -0,0 +1,198 @@
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+// File for testing the columnar telemetry store
+#include <gtest/gtest.h>
+#include <iostream>
+#include <cstdio>
+#include "../include/Columns.hpp"
+#include "../include/Schema.hpp"
+
+class ColumnsTest : public ::testing::Test
+{
+
+protected:
+
+    // Small chunks so the tests cross chunk boundaries
+    typedef aero::TelemetryColumns< aero::def::IMU_t, 64 > ImuColumns;
+    typedef aero::TelemetryColumns< aero::def::GPS_t, 64 > GpsColumns;
+
+    static aero::def::IMU_t imu( int i )
+    {
+        aero::def::IMU_t out = {};
+        out.ax = 0.01f * i;
+        out.az = -1.0f + ( i % 17 ) * 0.125f;
+        out.roll = static_cast< float >( i );
+        return out;
+    }
+
+    static aero::def::GPS_t gps( int i )
+    {
+        aero::def::GPS_t out = {};
+        out.fix = i % 3 != 0;
+        out.lat = 43.0f + i * 1e-5f;
+        out.satellites = i % 12;
+        out.time = 1200000 + i;
+        return out;
+    }
+};
+
+// Check rows land in the right columns and spans see them without copies
+TEST_F( ColumnsTest, Append )
+{
+    ImuColumns columns;
+    const int rows = 1000;
+
+    for( int i = 0; i < rows; ++i )
+        columns.append( 5000 * i, imu( i ) );
+
+    ASSERT_EQ( columns.rows(), rows );
+    ASSERT_EQ( columns.chunks(), ( rows + 63 ) / 64 );
+
+    int az = columns.find( "az" );
+    ASSERT_EQ( az, 2 );
+    ASSERT_EQ( columns.find( "nope" ), -1 );
+    ASSERT_STREQ( columns.field( az ).name, "az" );
+    ASSERT_EQ( columns.field( az ).type, aero::columns::Type::Float );
+
+    size_t row = 0;
+    for( size_t c = 0; c < columns.chunks(); ++c )
+    {
+        aero::columns::Span< float > values = columns.span< float >( az, c );
+        aero::columns::Span< uint64_t > times = columns.times( c );
+
+        ASSERT_EQ( values.size, times.size );
+        for( size_t i = 0; i < values.size; ++i, ++row )
+        {
+            ASSERT_EQ( values.data[ i ], imu( row ).az );
+            ASSERT_EQ( times.data[ i ], 5000 * row );
+        }
+    }
+    ASSERT_EQ( row, rows );
+
+    // Wrong type gives an empty span
+    ASSERT_EQ( columns.span< uint32_t >( az, 0 ).data, nullptr );
+
+    // Spans stay put while rows are added
+    const float* first = columns.span< float >( az, 0 ).data;
+    for( int i = 0; i < 5000; ++i )
+        columns.append( 5000 * ( rows + i ), imu( i ) );
+    ASSERT_EQ( columns.span< float >( az, 0 ).data, first );
+}
+
+// Check the stats against a plain loop over the structs
+TEST_F( ColumnsTest, Stats )
+{
+    ImuColumns columns;
+    GpsColumns fixes;
+
+    for( int i = 0; i < 1000; ++i )
+    {
+        columns.append( 1000 * i, imu( i ) );
+        fixes.append( 1000 * i, gps( i ) );
+    }
+
+    // Over a range that starts and ends inside chunks
+    aero::columns::Stats stats = columns.stats( columns.find( "az" ), 30, 700 );
+    double lo = 1e9, hi = -1e9, sum = 0.0;
+    for( int i = 30; i < 700; ++i )
+    {
+        lo = std::min< double >( lo, imu( i ).az );
+        hi = std::max< double >( hi, imu( i ).az );
+        sum += imu( i ).az;
+    }
+    ASSERT_EQ( stats.count, 670 );
+    ASSERT_DOUBLE_EQ( stats.min, lo );
+    ASSERT_DOUBLE_EQ( stats.max, hi );
+    ASSERT_NEAR( stats.mean, sum / 670, 1e-9 );
+
+    // Time range is inclusive at both ends
+    size_t first, last;
+    columns.range( 100500, 200000, first, last );
+    ASSERT_EQ( first, 101 );
+    ASSERT_EQ( last, 201 );
+
+    stats = columns.stats_between( columns.find( "roll" ), 100500, 200000 );
+    ASSERT_EQ( stats.count, 100 );
+    ASSERT_DOUBLE_EQ( stats.min, 101.0 );
+    ASSERT_DOUBLE_EQ( stats.max, 200.0 );
+    ASSERT_DOUBLE_EQ( stats.mean, 150.5 );
+
+    // Empty range
+    stats = columns.stats_between( columns.find( "roll" ), 5000000, 6000000 );
+    ASSERT_EQ( stats.count, 0 );
+    ASSERT_EQ( stats.mean, 0.0 );
+
+    // Integer and bool columns
+    stats = fixes.stats( fixes.find( "satellites" ), 0, 1000 );
+    ASSERT_EQ( stats.min, 0.0 );
+    ASSERT_EQ( stats.max, 11.0 );
+    stats = fixes.stats( fixes.find( "fix" ), 0, 999 );
+    ASSERT_NEAR( stats.mean, 2.0 / 3.0, 1e-12 );
+    ASSERT_EQ( fixes.value( fixes.find( "time" ), 500 ), 1200500.0 );
+    ASSERT_EQ( fixes.span< uint32_t >( fixes.find( "time" ), 1 ).data[ 0 ], 1200064u );
+}
+
+// Check rows can come straight from frames
+TEST_F( ColumnsTest, Frames )
+{
+    using Both = aero::Schema< aero::def::IMU_t, aero::def::GPS_t >;
+    using Only = aero::Schema< aero::def::GPS_t >;
+
+    uint8_t buf[ aero::def::MAX_FRAME_SIZE ];
+    ImuColumns columns;
+
+    size_t size = Both::build( buf, aero::def::ID::Plane, aero::def::ID::Gnd, imu( 7 ), gps( 7 ) );
+    ASSERT_TRUE( columns.append( 42, aero::MessageView( buf, size ) ) );
+
+    size = Only::build( buf, aero::def::ID::Plane, aero::def::ID::Gnd, gps( 8 ) );
+    ASSERT_FALSE( columns.append( 43, aero::MessageView( buf, size ) ) );
+
+    ASSERT_EQ( columns.rows(), 1 );
+    ASSERT_EQ( columns.time( 0 ), 42 );
+    ASSERT_FLOAT_EQ( columns.value( columns.find( "ax" ), 0 ), imu( 7 ).ax );
+}
+
+// Check an export reads back the same and is smaller than the structs
+TEST_F( ColumnsTest, Export )
+{
+    GpsColumns columns, copy;
+    ImuColumns other;
+    const int rows = 300;
+
+    for( int i = 0; i < rows; ++i )
+        columns.append( 1600000000000000ULL + 5000 * i - ( i == 100 ? 7000 : 0 ), gps( i ) );
+
+    FILE* file = tmpfile();
+    ASSERT_NE( file, nullptr );
+    ASSERT_TRUE( columns.write( file ) );
+
+    long size = ftell( file );
+    ASSERT_LT( size, static_cast< long >( rows * sizeof( aero::def::GPS_t ) ) );
+
+    rewind( file );
+    ASSERT_TRUE( copy.read( file ) );
+    ASSERT_EQ( copy.rows(), rows );
+
+    for( int i = 0; i < rows; ++i )
+    {
+        ASSERT_EQ( copy.time( i ), columns.time( i ) );
+        for( size_t c = 0; c < GpsColumns::COLUMNS; ++c )
+            ASSERT_EQ( copy.value( c, i ), columns.value( c, i ) );
+    }
+
+    // Wrong segment type and truncated files are refused
+    rewind( file );
+    ASSERT_FALSE( other.read( file ) );
+
+    ASSERT_EQ( ftruncate( fileno( file ), size - 1 ), 0 );
+    rewind( file );
+    ASSERT_FALSE( copy.read( file ) );
+    ASSERT_EQ( copy.rows(), 0 );
+
+    fclose( file );
+}
+
+#endif
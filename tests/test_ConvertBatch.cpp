@@ -0,0 +1,188 @@
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+// File for testing the batch air data conversions
+#include <gtest/gtest.h>
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <cstring>
+#include "../include/ConvertBatch.hpp"
+
+class ConvertBatchTest : public ::testing::Test
+{
+
+protected:
+
+    static const size_t N = 50021;   // Not a multiple of any vector width
+
+    // Samples spread over the flight envelope and beyond
+    void SetUp( void ) override
+    {
+        dp.resize( N ); p.resize( N ); t.resize( N ); as.resize( N ); out.resize( N ); ref.resize( N );
+
+        for( size_t i = 0; i < N; ++i )
+        {
+            double u = static_cast< double >( i ) / N;
+            dp[ i ] = 0.01 + 5000.0 * u;
+            p[ i ] = 50000.0 + 58000.0 * std::fmod( u * 7.31, 1.0 );
+            t[ i ] = -40.0 + 90.0 * std::fmod( u * 3.17, 1.0 );
+            as[ i ] = 100.0 * u;
+        }
+    }
+
+    // Distance between two floats in units in the last place
+    static int64_t ulp( float a, double exact )
+    {
+        float b = static_cast< float >( exact );
+        int32_t x, y;
+        memcpy( &x, &a, sizeof( x ) );
+        memcpy( &y, &b, sizeof( y ) );
+        int64_t ox = x < 0 ? (int64_t) INT32_MIN - x : x;
+        int64_t oy = y < 0 ? (int64_t) INT32_MIN - y : y;
+        return ox > oy ? ox - oy : oy - ox;
+    }
+
+    // Largest ULP error of out against ref
+    int64_t worst_ulp( void )
+    {
+        int64_t worst = 0;
+        for( size_t i = 0; i < N; ++i )
+            worst = std::max( worst, ulp( out[ i ], ref[ i ] ) );
+        return worst;
+    }
+
+    // Run a one input kernel on every backend built for this machine and check they agree
+    template< typename K >
+    void check_backends( const float* a )
+    {
+        using namespace aero::convert::simd;
+        std::vector< float > other( N );
+        run< Scalar, K >( a, out.data(), N );
+
+#if defined(AERO_SIMD_X86)
+        run< Sse2, K >( a, other.data(), N );
+        ASSERT_EQ( memcmp( other.data(), out.data(), N * sizeof( float ) ), 0 );
+
+        if( has_avx2() )
+        {
+            map_avx2< K >( a, other.data(), N );
+            ASSERT_EQ( memcmp( other.data(), out.data(), N * sizeof( float ) ), 0 );
+        }
+#elif defined(AERO_SIMD_NEON)
+        run< Neon, K >( a, other.data(), N );
+        ASSERT_EQ( memcmp( other.data(), out.data(), N * sizeof( float ) ), 0 );
+#endif
+    }
+
+    // Same for a two input kernel
+    template< typename K >
+    void check_backends( const float* a, const float* b )
+    {
+        using namespace aero::convert::simd;
+        std::vector< float > other( N );
+        run< Scalar, K >( a, b, out.data(), N );
+
+#if defined(AERO_SIMD_X86)
+        run< Sse2, K >( a, b, other.data(), N );
+        ASSERT_EQ( memcmp( other.data(), out.data(), N * sizeof( float ) ), 0 );
+
+        if( has_avx2() )
+        {
+            map_avx2< K >( a, b, other.data(), N );
+            ASSERT_EQ( memcmp( other.data(), out.data(), N * sizeof( float ) ), 0 );
+        }
+#elif defined(AERO_SIMD_NEON)
+        run< Neon, K >( a, b, other.data(), N );
+        ASSERT_EQ( memcmp( other.data(), out.data(), N * sizeof( float ) ), 0 );
+#endif
+    }
+
+    std::vector< float > dp, p, t, as, out;
+    std::vector< double > ref;
+
+    // Standard atmosphere in double precision
+    const double a0 = 340.29, P0 = 101325.0, T0 = 288.15, L = 0.0065, R = 8.314, M = 0.02895, g = 9.807;
+};
+
+// Check airspeeds against the exact formulas
+TEST_F( ConvertBatchTest, Airspeed )
+{
+    using namespace aero::convert;
+
+    for( size_t i = 0; i < N; ++i )
+        ref[ i ] = a0 * std::sqrt( 5.0 * ( std::pow( dp[ i ] / P0 + 1.0, 2.0 / 7.0 ) - 1.0 ) );
+    check_backends< simd::CalAs >( dp.data() );
+    ASSERT_LE( worst_ulp(), 4 );
+
+    for( size_t i = 0; i < N; ++i )
+        ref[ i ] = a0 * std::sqrt( 5.0 * p[ i ] / P0 * ( std::pow( dp[ i ] / p[ i ] + 1.0, 2.0 / 7.0 ) - 1.0 ) );
+    check_backends< simd::EquivAs >( dp.data(), p.data() );
+    ASSERT_LE( worst_ulp(), 4 );
+
+    for( size_t i = 0; i < N; ++i )
+        ref[ i ] = as[ i ] * std::sqrt( ( t[ i ] + 273.15 ) / T0 );
+    check_backends< simd::TrueAs >( as.data(), t.data() );
+    ASSERT_LE( worst_ulp(), 4 );
+}
+
+// Check altitudes and density against the exact formulas
+TEST_F( ConvertBatchTest, Altitude )
+{
+    using namespace aero::convert;
+
+    for( size_t i = 0; i < N; ++i )
+        ref[ i ] = ( T0 / L ) * ( 1.0 - std::pow( p[ i ] / P0, ( L * R ) / ( M * g ) ) );
+    check_backends< simd::PressureAltitude >( p.data() );
+    ASSERT_LE( worst_ulp(), 8 );
+
+    for( size_t i = 0; i < N; ++i )
+        ref[ i ] = ( T0 / L ) * ( 1.0 - std::pow( p[ i ] / P0 * ( T0 / ( t[ i ] + 273.15 ) ), ( L * R ) / ( M * g - L * R ) ) );
+    check_backends< simd::DensityAltitude >( p.data(), t.data() );
+    for( size_t i = 0; i < N; ++i )
+        ASSERT_NEAR( out[ i ], ref[ i ], 0.005 );
+
+    for( size_t i = 0; i < N; ++i )
+        ref[ i ] = M * p[ i ] / ( R * ( t[ i ] + 273.15 ) );
+    check_backends< simd::ApproxDensity >( p.data(), t.data() );
+    ASSERT_LE( worst_ulp(), 4 );
+}
+
+// Check the public overloads agree with the scalar functions and handle odd sizes
+TEST_F( ConvertBatchTest, Overloads )
+{
+    using namespace aero::convert;
+
+    for( size_t n : { 0, 1, 7, 13, 33 } )
+    {
+        // Skip the smallest pressures, the scalar cal_as loses them to cancellation
+        std::vector< float > a( dp.end() - n, dp.end() ), b( p.begin(), p.begin() + n ), c( t.begin(), t.begin() + n );
+
+        cal_as( a.data(), out.data(), n );
+        for( size_t i = 0; i < n; ++i )
+            ASSERT_NEAR( out[ i ], cal_as( a[ i ] ), 1e-3f );
+
+        pressure_altitude( b.data(), out.data(), n );
+        for( size_t i = 0; i < n; ++i )
+            ASSERT_NEAR( out[ i ], pressure_altitude( b[ i ] ), 0.05f );
+
+        density_altitude( b.data(), c.data(), out.data(), n );
+        for( size_t i = 0; i < n; ++i )
+            ASSERT_NEAR( out[ i ], density_altitude( b[ i ], c[ i ] ), 0.05f );
+
+        // In place
+        approx_density( b.data(), c.data(), b.data(), n );
+        for( size_t i = 0; i < n; ++i )
+            ASSERT_FLOAT_EQ( b[ i ], approx_density( p[ i ], c[ i ] ) );
+    }
+
+    // Negative pressure difference is NaN like the scalar version
+    float negative = -10.0f, result;
+    cal_as( &negative, &result, 1 );
+    ASSERT_TRUE( std::isnan( result ) );
+    ASSERT_TRUE( std::isnan( cal_as( negative ) ) );
+}
+
+#endif
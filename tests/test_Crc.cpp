@@ -0,0 +1,83 @@
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+// File for testing frame integrity checks
+#include <gtest/gtest.h>
+#include <iostream>
+#include <vector>
+#include "../include/Crc.hpp"
+
+// Check against the standard check values for "123456789"
+TEST( CrcTest, CheckValues )
+{
+    using namespace aero;
+
+    const uint8_t check[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+
+    ASSERT_EQ( crc::crc16( check, sizeof( check ) ), 0x29B1 );
+    ASSERT_EQ( crc::crc16_nibblewise( check, sizeof( check ) ), 0x29B1 );
+    ASSERT_EQ( crc::crc32c_bytewise( check, sizeof( check ) ), 0xE3069283u );
+    ASSERT_EQ( crc::crc32c_slice8( check, sizeof( check ) ), 0xE3069283u );
+    ASSERT_EQ( crc::crc32c( check, sizeof( check ) ), 0xE3069283u );
+
+    // Empty input leaves the start value
+    ASSERT_EQ( crc::crc16( check, 0 ), 0xFFFF );
+    ASSERT_EQ( crc::crc32c( check, 0 ), 0u );
+}
+
+// Check every CRC path agrees for all lengths and alignments
+TEST( CrcTest, PathsAgree )
+{
+    using namespace aero;
+
+    std::vector< uint8_t > data( 600 );
+    uint32_t seed = 12345;
+    for( uint8_t& byte : data )
+    {
+        seed = seed * 1103515245 + 12345;
+        byte = static_cast< uint8_t >( seed >> 16 );
+    }
+
+    for( size_t offset = 0; offset < 8; ++offset )
+    {
+        for( size_t len = 0; len < data.size() - offset; len += 1 + len / 8 )
+        {
+            ASSERT_EQ( crc::crc16_nibblewise( data.data() + offset, len ), crc::crc16( data.data() + offset, len ) ) << offset << " " << len;
+
+            uint32_t expected = crc::crc32c_bytewise( data.data() + offset, len );
+
+            ASSERT_EQ( crc::crc32c_slice8( data.data() + offset, len ), expected ) << offset << " " << len;
+            ASSERT_EQ( crc::crc32c( data.data() + offset, len ), expected ) << offset << " " << len;
+
+            #if defined(AERO_CRC32C_X86) || defined(AERO_CRC32C_ARM)
+                if( crc::has_hardware() )
+                {
+                    ASSERT_EQ( crc::crc32c_hardware( data.data() + offset, len ), expected ) << offset << " " << len;
+                }
+            #endif
+        }
+    }
+}
+
+// Check a CRC can be computed over a buffer in pieces
+TEST( CrcTest, Incremental )
+{
+    using namespace aero;
+
+    uint8_t data[ 100 ];
+    for( size_t i = 0; i < sizeof( data ); ++i )
+        data[ i ] = static_cast< uint8_t >( i * 7 );
+
+    for( size_t split = 0; split <= sizeof( data ); split += 9 )
+    {
+        uint16_t c16 = crc::crc16( data + split, sizeof( data ) - split, crc::crc16( data, split ) );
+        uint32_t c32 = crc::crc32c( data + split, sizeof( data ) - split, crc::crc32c( data, split ) );
+
+        ASSERT_EQ( c16, crc::crc16( data, sizeof( data ) ) );
+        ASSERT_EQ( c32, crc::crc32c( data, sizeof( data ) ) );
+    }
+}
+
+#endif
@@ -0,0 +1,140 @@
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+// File for testing keyframe and delta compression
+#include <gtest/gtest.h>
+#include <iostream>
+#include <vector>
+#include "../include/Delta.hpp"
+#include "../include/Schema.hpp"
+
+class DeltaTest : public ::testing::Test
+{
+
+protected:
+
+    using Telemetry = aero::Schema< aero::def::IMU_t, aero::def::GPS_t, aero::def::Status_t, aero::def::Servos_t >;
+
+    // Build the frame for a tick. Only the IMU and GPS time change often
+    std::vector< uint8_t > make_tick( uint32_t tick )
+    {
+        aero::def::IMU_t imu = {};
+        imu.ax = 0.01f * ( tick % 7 );
+        imu.az = 1.0f;
+        imu.gz = 0.5f * tick;
+
+        aero::def::GPS_t gps = {};
+        gps.fix = true;
+        gps.lat = 43.0f;
+        gps.lon = -81.0f;
+        gps.time = 120000 + tick / 5;
+
+        aero::def::Status_t status = { -70.0f, tick < 30 ? 1u : 2u };
+
+        aero::def::Servos_t servos = {};
+        servos.servo0 = 1500;
+        servos.servo3 = 1000 + tick / 10;
+
+        std::vector< uint8_t > frame( Telemetry::frame_size );
+        Telemetry::build( frame.data(), aero::def::ID::Plane, aero::def::ID::Gnd, imu, gps, status, servos );
+        return frame;
+    }
+
+    aero::DeltaEncoder encoder { 10 };
+    aero::DeltaDecoder decoder;
+};
+
+// Check every frame is restored exactly and the stream gets smaller
+TEST_F( DeltaTest, RoundTrip )
+{
+    uint8_t out[ aero::def::MAX_FRAME_SIZE ];
+    size_t deltas = 0;
+
+    for( uint32_t tick = 0; tick < 100; ++tick )
+    {
+        std::vector< uint8_t > plain = make_tick( tick );
+        size_t size = encoder.encode( aero::MessageView( plain.data(), plain.size() ), out );
+        ASSERT_GT( size, 0u );
+
+        aero::MessageView sent( out, size );
+        ASSERT_TRUE( sent.valid() );
+        deltas += sent.delta();
+
+        // Keyframe after every 10 delta frames
+        ASSERT_EQ( sent.delta(), tick % 11 != 0 ) << "Tick " << tick;
+
+        ASSERT_TRUE( decoder.decode( sent ) ) << "Tick " << tick;
+        aero::MessageView restored = decoder.frame();
+        ASSERT_TRUE( restored.valid() );
+        ASSERT_EQ( std::vector< uint8_t >( restored.data(), restored.data() + restored.size() ), plain ) << "Tick " << tick;
+    }
+
+    ASSERT_EQ( deltas, 90u );
+    ASSERT_LT( encoder.sent_bytes() * 2, encoder.plain_bytes() ) << "Expected better than half size";
+    ASSERT_EQ( decoder.lost(), 0u );
+}
+
+// Check a lost frame only costs frames until the next keyframe
+TEST_F( DeltaTest, LostFrame )
+{
+    uint8_t out[ aero::def::MAX_FRAME_SIZE ];
+    int rejected = 0;
+
+    for( uint32_t tick = 0; tick < 30; ++tick )
+    {
+        std::vector< uint8_t > plain = make_tick( tick );
+        size_t size = encoder.encode( aero::MessageView( plain.data(), plain.size() ), out );
+
+        // Frame 3 never arrives
+        if( tick == 3 )
+            continue;
+
+        aero::MessageView sent( out, size );
+        bool decoded = decoder.decode( sent );
+
+        if( tick > 3 && tick < 11 )
+        {
+            ASSERT_FALSE( decoded ) << "Tick " << tick;
+            ++rejected;
+        }
+        else
+        {
+            ASSERT_TRUE( decoded ) << "Tick " << tick;
+            aero::MessageView restored = decoder.frame();
+            ASSERT_EQ( std::vector< uint8_t >( restored.data(), restored.data() + restored.size() ), plain );
+        }
+    }
+
+    ASSERT_EQ( rejected, 7 );
+    ASSERT_EQ( decoder.lost(), 7u );
+}
+
+// Check a change of schema forces a keyframe and delta frames can't be read directly
+TEST_F( DeltaTest, SchemaChange )
+{
+    using Small = aero::Schema< aero::def::Battery_t >;
+    uint8_t out[ aero::def::MAX_FRAME_SIZE ];
+
+    std::vector< uint8_t > plain = make_tick( 0 );
+    encoder.encode( aero::MessageView( plain.data(), plain.size() ), out );
+    plain = make_tick( 1 );
+    size_t size = encoder.encode( aero::MessageView( plain.data(), plain.size() ), out );
+
+    aero::MessageView sent( out, size );
+    ASSERT_TRUE( sent.valid() );
+    ASSERT_TRUE( sent.delta() );
+    ASSERT_EQ( sent.signature(), Telemetry::signature );
+    ASSERT_EQ( sent.segment( aero::def::Signature::IMU ) == NULL, true ) << " Delta payload is not readable as segments ";
+
+    aero::def::Battery_t battery = { 12.0f, 1.0f };
+    uint8_t small[ Small::frame_size ];
+    Small::build( small, aero::def::ID::Plane, aero::def::ID::Gnd, battery );
+    size = encoder.encode( aero::MessageView( small, sizeof( small ) ), out );
+
+    ASSERT_EQ( size, Small::frame_size );
+    ASSERT_FALSE( aero::MessageView( out, size ).delta() );
+}
+
+#endif
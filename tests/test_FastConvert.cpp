@@ -0,0 +1,86 @@
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+// File for testing the fast air data conversions
+#include <gtest/gtest.h>
+#include <iostream>
+#include <cmath>
+#include "../include/FastConvert.hpp"
+
+namespace
+{
+    // Exact formulas in double
+    const double a0 = 340.29, g = 9.807, P0 = 101325.0, T0 = 288.15, L = 0.0065, R = 8.314, M = 0.02895;
+
+    double exact_cal_as( double dp )
+    {
+        return a0 * std::sqrt( 5.0 * ( std::pow( dp / P0 + 1.0, 2.0 / 7.0 ) - 1.0 ) );
+    }
+
+    double exact_equiv_as( double dp, double p )
+    {
+        return a0 * std::sqrt( 5.0 * p / P0 * ( std::pow( dp / p + 1.0, 2.0 / 7.0 ) - 1.0 ) );
+    }
+
+    double exact_pressure_altitude( double p )
+    {
+        return ( T0 / L ) * ( 1.0 - std::pow( p / P0, ( L * R ) / ( M * g ) ) );
+    }
+
+    double exact_density_altitude( double p, double t )
+    {
+        return ( T0 / L ) * ( 1.0 - std::pow( p / P0 * ( T0 / ( t + 273.15 ) ), ( L * R ) / ( M * g - L * R ) ) );
+    }
+}
+
+// Check the airspeeds stay inside the documented error over the envelope
+TEST( FastConvertTest, Airspeed )
+{
+    using namespace aero::convert;
+
+    for( float dp = 0.0f; dp <= 25000.0f; dp += 0.37f )
+        ASSERT_NEAR( fast::cal_as( dp ), exact_cal_as( dp ), 1e-4 ) << dp;
+
+    for( float p = 35000.0f; p <= 110000.0f; p += 397.0f )
+        for( float dp = 0.0f; dp <= p / 4.0f; dp += 3.1f )
+            ASSERT_NEAR( fast::equiv_as( dp, p ), exact_equiv_as( dp, p ), 1e-4 ) << dp << " " << p;
+}
+
+// Check the altitudes stay inside the documented error over the envelope
+TEST( FastConvertTest, Altitude )
+{
+    using namespace aero::convert;
+
+    for( float p = 35000.0f; p <= 110000.0f; p += 0.73f )
+        ASSERT_NEAR( fast::pressure_altitude( p ), exact_pressure_altitude( p ), 0.002 ) << p;
+
+    for( float p = 35000.0f; p <= 110000.0f; p += 31.0f )
+        for( float t = -50.0f; t <= 60.0f; t += 0.7f )
+            ASSERT_NEAR( fast::density_altitude( p, t ), exact_density_altitude( p, t ), 0.005 ) << p << " " << t;
+
+    ASSERT_FLOAT_EQ( fast::above_gnd_altitude( 95000.0f, 100.0f ), fast::pressure_altitude( 95000.0f ) - 100.0f );
+}
+
+// Outside the envelope the exact versions are used
+TEST( FastConvertTest, Fallback )
+{
+    using namespace aero::convert;
+
+    ASSERT_EQ( fast::cal_as( 30000.0f ), cal_as( 30000.0f ) );
+    ASSERT_EQ( fast::equiv_as( 20000.0f, 40000.0f ), equiv_as( 20000.0f, 40000.0f ) );
+    ASSERT_EQ( fast::pressure_altitude( 20000.0f ), pressure_altitude( 20000.0f ) );
+    ASSERT_EQ( fast::pressure_altitude( 120000.0f ), pressure_altitude( 120000.0f ) );
+    ASSERT_EQ( fast::density_altitude( 20000.0f, 15.0f ), density_altitude( 20000.0f, 15.0f ) );
+
+    // Negative differential pressure has no airspeed
+    ASSERT_TRUE( std::isnan( fast::cal_as( -10.0f ) ) );
+    ASSERT_TRUE( std::isnan( fast::equiv_as( -10.0f, 90000.0f ) ) );
+
+    // Functions without powf are the exact ones
+    ASSERT_EQ( fast::true_as( 20.0f, 25.0f ), true_as( 20.0f, 25.0f ) );
+    ASSERT_EQ( fast::approx_density( 90000.0f, 25.0f ), approx_density( 90000.0f, 25.0f ) );
+}
+
+#endif
@@ -0,0 +1,243 @@
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+// File for testing the streaming filters
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+#include "../include/Data.hpp"
+#include "../include/Filter.hpp"
+
+namespace
+{
+    // 7 channels, so vector backends also run the one at a time tail
+    const size_t CHANNELS = 7;
+
+    // Random values with an offset per channel
+    std::vector< float > filter_input( size_t samples, unsigned seed )
+    {
+        std::vector< float > out( samples * CHANNELS );
+        srand( seed );
+        for( size_t n = 0; n < samples; ++n )
+            for( size_t c = 0; c < CHANNELS; ++c )
+                out[ n * CHANNELS + c ] = 10.0f * c + 2.0f * rand() / RAND_MAX - 1.0f;
+        return out;
+    }
+}
+
+// Matches the mean of the last N inputs, the first input fills the history
+TEST( FilterTest, MovingAverage )
+{
+    using namespace aero;
+
+    const size_t N = 5;
+    std::vector< float > in = filter_input( 300, 3 );
+    filter::MovingAverage< CHANNELS, N > vector;
+    filter::MovingAverage< CHANNELS, N, filter::Scalar > scalar;
+
+    for( size_t n = 0; n < 300; ++n )
+    {
+        float out[ CHANNELS ], reference[ CHANNELS ];
+        vector.step( &in[ n * CHANNELS ], out );
+        scalar.step( &in[ n * CHANNELS ], reference );
+
+        for( size_t c = 0; c < CHANNELS; ++c )
+        {
+            double sum = 0.0;
+            for( size_t k = 0; k < N; ++k )
+                sum += in[ ( n >= k ? n - k : 0 ) * CHANNELS + c ];
+
+            ASSERT_NEAR( out[ c ], sum / N, 1e-4 );
+            ASSERT_EQ( out[ c ], reference[ c ] );
+        }
+    }
+}
+
+// The running sum does not drift over a long run, what is left is the
+// rounding since the last wrap
+TEST( FilterTest, MovingAverageDrift )
+{
+    using namespace aero;
+
+    filter::MovingAverage< 1, 16 > average;
+    float out = 0.0f;
+    for( int n = 0; n < 1000000; ++n )
+    {
+        float in = ( n & 1 ) ? 1000.1f : 0.1f;
+        average.step( &in, &out );
+    }
+
+    float constant = 3.0f;
+    for( int n = 0; n < 16; ++n )
+        average.step( &constant, &out );
+    ASSERT_NEAR( out, 3.0f, 1e-4f );
+}
+
+// Matches sorting the last N inputs and removes a spike
+TEST( FilterTest, Median )
+{
+    using namespace aero;
+
+    const size_t N = 5;
+    std::vector< float > in = filter_input( 300, 5 );
+    filter::Median< CHANNELS, N > median;
+
+    for( size_t n = 0; n < 300; ++n )
+    {
+        float out[ CHANNELS ];
+        median.step( &in[ n * CHANNELS ], out );
+
+        for( size_t c = 0; c < CHANNELS; ++c )
+        {
+            float window[ N ];
+            for( size_t k = 0; k < N; ++k )
+                window[ k ] = in[ ( n >= k ? n - k : 0 ) * CHANNELS + c ];
+            std::nth_element( window, window + N / 2, window + N );
+
+            ASSERT_EQ( out[ c ], window[ N / 2 ] );
+        }
+    }
+
+    filter::Median< 1, 3 > spikes;
+    float values[] = { 101300.0f, 101301.0f, 0.0f, 101302.0f, 101301.0f };
+    float out = 0.0f;
+    for( size_t n = 0; n < 5; ++n )
+    {
+        spikes.step( &values[ n ], &out );
+        ASSERT_GT( out, 101000.0f );
+    }
+}
+
+// Matches the difference equation worked out in doubles
+TEST( FilterTest, Biquad )
+{
+    using namespace aero;
+
+    filter::Coefficients k = filter::Coefficients::lowpass( 30.0f, 1000.0f );
+    std::vector< float > in = filter_input( 500, 7 );
+    filter::Biquad< CHANNELS > biquad( k );
+
+    // Primed like the filter, as if the first input had always been there
+    double x1[ CHANNELS ], x2[ CHANNELS ], y1[ CHANNELS ], y2[ CHANNELS ];
+    for( size_t c = 0; c < CHANNELS; ++c )
+    {
+        x1[ c ] = x2[ c ] = in[ c ];
+        y1[ c ] = y2[ c ] = in[ c ];
+    }
+
+    for( size_t n = 0; n < 500; ++n )
+    {
+        float out[ CHANNELS ];
+        biquad.step( &in[ n * CHANNELS ], out );
+
+        for( size_t c = 0; c < CHANNELS; ++c )
+        {
+            double x = in[ n * CHANNELS + c ];
+            double y = k.b0 * x + k.b1 * x1[ c ] + k.b2 * x2[ c ] - k.a1 * y1[ c ] - k.a2 * y2[ c ];
+            x2[ c ] = x1[ c ]; x1[ c ] = x;
+            y2[ c ] = y1[ c ]; y1[ c ] = y;
+
+            ASSERT_NEAR( out[ c ], y, 1e-3 );
+        }
+    }
+}
+
+// Low pass keeps DC and removes high frequencies, the notch removes its frequency
+TEST( FilterTest, BiquadResponse )
+{
+    using namespace aero;
+
+    ASSERT_NEAR( filter::Coefficients::lowpass( 20.0f, 1000.0f ).dc_gain(), 1.0f, 1e-4f );
+    ASSERT_NEAR( filter::Coefficients::highpass( 20.0f, 1000.0f ).dc_gain(), 0.0f, 1e-4f );
+    ASSERT_NEAR( filter::Coefficients::notch( 120.0f, 1000.0f ).dc_gain(), 1.0f, 1e-4f );
+
+    filter::Biquad< 3 > lowpass( filter::Coefficients::lowpass( 20.0f, 1000.0f ) );
+    filter::Biquad< 3 > notch( filter::Coefficients::notch( 120.0f, 1000.0f ) );
+    float low_peak = 0.0f, notch_peak = 0.0f;
+
+    for( int n = 0; n < 2000; ++n )
+    {
+        // 1 plus 250 Hz into the low pass, 120 Hz into the notch
+        float low[ 3 ], tone[ 3 ];
+        for( int c = 0; c < 3; ++c )
+        {
+            low[ c ] = 1.0f + sinf( 6.28318531f * 250.0f * n / 1000.0f + c );
+            tone[ c ] = sinf( 6.28318531f * 120.0f * n / 1000.0f + c );
+        }
+        lowpass.step( low, low );
+        notch.step( tone, tone );
+
+        if( n >= 1000 )
+            for( int c = 0; c < 3; ++c )
+            {
+                low_peak = std::max( low_peak, fabsf( low[ c ] - 1.0f ) );
+                notch_peak = std::max( notch_peak, fabsf( tone[ c ] ) );
+            }
+    }
+
+    ASSERT_LT( low_peak, 0.01f );
+    ASSERT_LT( notch_peak, 0.01f );
+}
+
+// Follows the integrated rate short term and the measurement long term
+TEST( FilterTest, Complementary )
+{
+    using namespace aero;
+
+    filter::Complementary< CHANNELS > blend( 0.5f, 100.0f );
+    float rate[ CHANNELS ], measurement[ CHANNELS ], out[ CHANNELS ];
+
+    // Starts at the measurement
+    for( size_t c = 0; c < CHANNELS; ++c )
+    {
+        rate[ c ] = 0.0f;
+        measurement[ c ] = 5.0f * c;
+    }
+    blend.step( rate, measurement, out );
+    for( size_t c = 0; c < CHANNELS; ++c )
+        ASSERT_NEAR( out[ c ], 5.0f * c, 1e-5f );
+
+    // A gyro bias of 2 per second against a fixed measurement settles at
+    // rate * tau above it instead of growing
+    for( size_t c = 0; c < CHANNELS; ++c )
+        rate[ c ] = 2.0f;
+    for( int n = 0; n < 1000; ++n )
+        blend.step( rate, measurement, out );
+    for( size_t c = 0; c < CHANNELS; ++c )
+        ASSERT_NEAR( out[ c ], 5.0f * c + 2.0f * 0.5f, 1e-3f );
+
+    // A step in the rate shows straight away
+    float before = out[ 0 ];
+    for( size_t c = 0; c < CHANNELS; ++c )
+        rate[ c ] = 100.0f;
+    blend.step( rate, measurement, out );
+    ASSERT_GT( out[ 0 ] - before, 0.9f );
+}
+
+// Filters every field of a segment in place
+TEST( FilterTest, Apply )
+{
+    using namespace aero;
+
+    filter::MovingAverage< 12, 2 > average;
+    def::IMU_t imu = { 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f, 12.0f };
+    filter::apply( average, imu );
+    ASSERT_EQ( imu.ax, 1.0f );
+    ASSERT_EQ( imu.roll, 12.0f );
+
+    def::IMU_t zero = {};
+    filter::apply( average, zero );
+    ASSERT_EQ( zero.ax, 0.5f );
+    ASSERT_EQ( zero.mz, 4.5f );
+    ASSERT_EQ( zero.roll, 6.0f );
+
+    filter::Median< 3, 3 > median;
+    def::Enviro_t enviro = { 100.0f, 20.0f, 101325.0f };
+    filter::apply( median, enviro );
+    ASSERT_EQ( enviro.pressure, 101325.0f );
+}
+
+#endif
@@ -0,0 +1,114 @@
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+// File for testing the fixed-point numbers and air data
+#include <gtest/gtest.h>
+#include <iostream>
+#include <cmath>
+#include "../include/Fixed.hpp"
+#include "../include/Utility.hpp"
+
+// Test the arithmetic and that it saturates instead of wrapping
+TEST( FixedTest, Arithmetic )
+{
+    using namespace aero::fixed;
+
+    Q16_16 a = Q16_16::from_float( 1.5f ), b = Q16_16::from_float( -2.25f );
+
+    ASSERT_EQ( a.raw, 0x18000 );
+    ASSERT_FLOAT_EQ( ( a + b ).to_float(), -0.75f );
+    ASSERT_FLOAT_EQ( ( a - b ).to_float(), 3.75f );
+    ASSERT_FLOAT_EQ( ( a * b ).to_float(), -3.375f );
+    ASSERT_FLOAT_EQ( ( b / a ).to_float(), -1.5f );
+    ASSERT_FLOAT_EQ( ( -a ).to_float(), -1.5f );
+    ASSERT_TRUE( b < a && a >= a && a != b );
+
+    ASSERT_EQ( Q16_16::from_int( 30000 ) + Q16_16::from_int( 30000 ), Q16_16::max() );
+    ASSERT_EQ( Q16_16::from_int( -30000 ) - Q16_16::from_int( 30000 ), Q16_16::min() );
+    ASSERT_EQ( Q16_16::from_int( 300 ) * Q16_16::from_int( -300 ), Q16_16::min() );
+    ASSERT_EQ( a / Q16_16::from_raw( 0 ), Q16_16::max() );
+    ASSERT_EQ( -Q16_16::min(), Q16_16::max() );
+    ASSERT_EQ( Q16_16::from_float( 1e9f ), Q16_16::max() );
+    ASSERT_EQ( Q16_16::from_float( NAN ).raw, 0 );
+
+    // Q1.15 can't hold one
+    Q1_15 half = Q1_15::from_float( 0.5f );
+    ASSERT_EQ( Q1_15::one(), Q1_15::max() );
+    ASSERT_EQ( half.raw, 16384 );
+    ASSERT_FLOAT_EQ( ( half * Q1_15::from_float( -0.5f ) ).to_float(), -0.25f );
+    ASSERT_EQ( half + half, Q1_15::max() );
+    ASSERT_EQ( Q1_15::from_float( -0.75f ) - half, Q1_15::min() );
+
+    // Format changes round and saturate
+    ASSERT_EQ( rescale< Q16_16 >( half ).raw, 0x8000 );
+    ASSERT_EQ( rescale< Q1_15 >( Q16_16::from_float( 0.25f ) ).raw, 8192 );
+    ASSERT_EQ( rescale< Q1_15 >( Q16_16::from_int( 3 ) ), Q1_15::max() );
+    ASSERT_FLOAT_EQ( mul( Q16_16::from_int( 1000 ), Q2_30::from_float( 0.001f ) ).to_float(), 1.0f );
+}
+
+// Test square roots against the float version
+TEST( FixedTest, Sqrt )
+{
+    using namespace aero::fixed;
+
+    ASSERT_EQ( sqrt( Q16_16::from_int( 4 ) ).raw, 2 << 16 );
+    ASSERT_EQ( sqrt( Q16_16::from_int( -4 ) ).raw, 0 );
+    ASSERT_NEAR( sqrt( Q16_16::max() ).to_float(), std::sqrt( Q16_16::max().to_float() ), 1.0f / 65536 );
+
+    for( float x = 0.0f; x < 32000.0f; x = x * 1.01f + 0.001f )
+        ASSERT_NEAR( sqrt( Q16_16::from_float( x ) ).to_float(), std::sqrt( Q16_16::from_float( x ).to_float() ), 1.0f / 65536 ) << x;
+
+    for( float x = 0.0f; x < 1.0f; x += 0.001f )
+        ASSERT_NEAR( sqrt( Q1_15::from_float( x ) ).to_float(), std::sqrt( Q1_15::from_float( x ).to_float() ), 1.0f / 32768 ) << x;
+}
+
+// Test the air data against the float versions over the flight envelope
+TEST( FixedTest, AirData )
+{
+    using namespace aero;
+
+    for( float dp = 0.5f; dp <= 32000.0f; dp += 0.37f )
+        ASSERT_NEAR( fixed::cal_as( fixed::Q16_16::from_float( dp ) ).to_float(), convert::cal_as( dp ), 0.02f ) << dp;
+
+    for( float as = 0.0f; as < 100.0f; as += 0.13f )
+        for( float t = -50.0f; t <= 60.0f; t += 1.1f )
+            ASSERT_NEAR( fixed::true_as( fixed::Q16_16::from_float( as ), fixed::Q16_16::from_float( t ) ).to_float(),
+                         convert::true_as( as, t ), 0.002f ) << as << " " << t;
+
+    for( float p = 34500.0f; p <= 111400.0f; p += 0.31f )
+        ASSERT_NEAR( fixed::pressure_altitude( fixed::Q16_16::from_float( p / 100.0f ) ).to_float(),
+                     convert::pressure_altitude( p ), 0.01f ) << p;
+
+    for( float p = 34500.0f; p <= 111400.0f; p += 7.1f )
+        for( float t = -50.0f; t <= 60.0f; t += 0.7f )
+            ASSERT_NEAR( fixed::approx_density( fixed::Q16_16::from_float( p / 100.0f ), fixed::Q16_16::from_float( t ) ).to_float(),
+                         convert::approx_density( p, t ), 5e-5f ) << p << " " << t;
+
+    // No airspeed from negative pressure and altitude clamps outside the envelope
+    ASSERT_EQ( fixed::cal_as( fixed::Q16_16::from_float( -10.0f ) ).raw, 0 );
+    ASSERT_EQ( fixed::pressure_altitude( fixed::Q16_16::from_int( 200 ) ), fixed::pressure_altitude( fixed::Q16_16::from_int( 300 ) ) );
+    ASSERT_EQ( fixed::pressure_altitude( fixed::Q16_16::from_int( 2000 ) ), fixed::pressure_altitude( fixed::Q16_16::from_int( 1200 ) ) );
+}
+
+// Test filling the segment from raw sensor data
+TEST( FixedTest, Compute )
+{
+    using namespace aero;
+
+    def::Pitot_t pitot = { 600.0f };
+    def::Enviro_t enviro = { 0.0f, 20.0f, 95000.0f };
+    def::AirData_t air;
+    memset( &air, 0xAA, sizeof( air ) );
+
+    fixed::compute( pitot, enviro, air );
+
+    ASSERT_NEAR( fixed::Q16_16::from_raw( air.ias ).to_float(), convert::cal_as( 600.0f ), 0.01f );
+    ASSERT_NEAR( fixed::Q16_16::from_raw( air.tas ).to_float(), convert::true_as( convert::cal_as( 600.0f ), 20.0f ), 0.01f );
+    ASSERT_NEAR( fixed::Q16_16::from_raw( air.pressure_alt ).to_float(), convert::pressure_altitude( 95000.0f ), 0.01f );
+    ASSERT_NEAR( fixed::Q16_16::from_raw( air.density ).to_float(), convert::approx_density( 95000.0f, 20.0f ), 1e-4f );
+    ASSERT_EQ( air.eas, 0xAAAAAAAA );
+}
+
+#endif
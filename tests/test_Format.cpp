@@ -0,0 +1,215 @@
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+// File for testing the buffered formatter
+#include <gtest/gtest.h>
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include "../include/Format.hpp"
+
+namespace
+{
+    // Format a float alone
+    std::string real( float value )
+    {
+        char buf[ 32 ];
+        aero::print::Formatter out( buf, sizeof( buf ) );
+        return out.real( value ).c_str();
+    }
+
+    std::string fixed( float value, uint8_t decimals )
+    {
+        char buf[ 48 ];
+        aero::print::Formatter out( buf, sizeof( buf ) );
+        return out.fixed( value, decimals ).c_str();
+    }
+
+    // Fewest significant digits printf needs to read back the same float
+    int shortest_digits( float value )
+    {
+        char buf[ 32 ];
+        for( int p = 1; p < 9; ++p )
+        {
+            snprintf( buf, sizeof( buf ), "%.*e", p - 1, value );
+            if( strtof( buf, NULL ) == value )
+                return p;
+        }
+        return 9;
+    }
+
+    int significant_digits( const std::string& text )
+    {
+        int n = 0;
+        bool leading = true;
+        for( char c : text )
+        {
+            if( c == 'e' )
+                break;
+            if( c < '0' || c > '9' || ( leading && c == '0' ) )
+                continue;
+            leading = false;
+            ++n;
+        }
+
+        // Trailing zeros of an integer are not significant
+        std::string mantissa = text.substr( 0, text.find( 'e' ) );
+        if( mantissa.find( '.' ) == std::string::npos )
+            for( size_t i = mantissa.size(); i > 1 && mantissa[ i - 1 ] == '0'; --i )
+                --n;
+
+        return n;
+    }
+}
+
+// Check integers, hex and padding
+TEST( FormatTest, Integers )
+{
+    using namespace aero::print;
+
+    char buf[ 128 ];
+    Formatter out( buf, sizeof( buf ) );
+
+    out.number( 0 ).put( ' ' ).number( -2147483647 - 1 ).put( ' ' ).number( 4294967295u ).put( ' ' );
+    out.number( static_cast< int16_t >( -300 ) ).put( ' ' ).number( static_cast< uint8_t >( 200 ) ).put( ' ' );
+    out.number( 18446744073709551615ull ).put( ' ' ).number( -9000000000ll );
+    ASSERT_STREQ( out.c_str(), "0 -2147483648 4294967295 -300 200 18446744073709551615 -9000000000" );
+
+    out.clear();
+    out.hex( 0xA ).put( ' ' ).hex( 0x0A, 2 ).put( ' ' ).hex( 0xDEADBEEF ).put( ' ' ).hex( 0x12, 8 );
+    ASSERT_STREQ( out.c_str(), "A 0A DEADBEEF 00000012" );
+
+    out.clear();
+    out.put( '[' ).width( 6 ).number( -42 ).put( '|' ).width( 6, Align::Left ).text( "ab" ).put( '|' ).width( 2 ).text( "long" ).put( ']' );
+    ASSERT_STREQ( out.c_str(), "[   -42|ab    |long]" );
+}
+
+// Check floats are the shortest text that reads back the same
+TEST( FormatTest, Real )
+{
+    ASSERT_EQ( real( 0.0f ), "0" );
+    ASSERT_EQ( real( 1.0f ), "1" );
+    ASSERT_EQ( real( -42.5f ), "-42.5" );
+    ASSERT_EQ( real( 0.1f ), "0.1" );
+    ASSERT_EQ( real( 101325.0f ), "101325" );
+    ASSERT_EQ( real( 123456792.0f ), "123456790" );
+    ASSERT_EQ( real( 0.00012f ), "0.00012" );
+    ASSERT_EQ( real( 1e-6f ), "1e-06" );
+    ASSERT_EQ( real( 3.4028235e38f ), "3.4028235e+38" );
+    ASSERT_EQ( real( 1e10f ), "1e+10" );
+    ASSERT_EQ( real( NAN ), "nan" );
+    ASSERT_EQ( real( -INFINITY ), "-inf" );
+
+    // Random bit patterns over the whole range, including subnormals
+    srand( 17 );
+    for( int i = 0; i < 200000; ++i )
+    {
+        uint32_t bits = ( static_cast< uint32_t >( rand() ) << 16 ) ^ static_cast< uint32_t >( rand() );
+        float value;
+        memcpy( &value, &bits, sizeof( value ) );
+        if( !std::isfinite( value ) )
+            continue;
+
+        std::string text = real( value );
+        ASSERT_EQ( strtof( text.c_str(), NULL ), value ) << text;
+        ASSERT_LE( significant_digits( text ), shortest_digits( value ) ) << text;
+    }
+}
+
+// Check fixed decimals round half away from zero
+TEST( FormatTest, Fixed )
+{
+    ASSERT_EQ( fixed( 3.14159f, 2 ), "3.14" );
+    ASSERT_EQ( fixed( -0.125f, 2 ), "-0.13" );
+    ASSERT_EQ( fixed( -0.004f, 2 ), "0.00" );
+    ASSERT_EQ( fixed( 250.0f, 0 ), "250" );
+    ASSERT_EQ( fixed( 9.9999f, 3 ), "10.000" );
+    ASSERT_EQ( fixed( 43.0096f, 7 ), "43.0096016" );
+    ASSERT_EQ( fixed( 1e30f, 2 ), "1e+30" );
+    ASSERT_EQ( fixed( NAN, 2 ), "nan" );
+}
+
+// Check the hex dump matches hexdump -C
+TEST( FormatTest, HexDump )
+{
+    char buf[ 256 ];
+    aero::print::Formatter out( buf, sizeof( buf ) );
+    uint8_t data[ 20 ];
+    for( size_t i = 0; i < sizeof( data ); ++i )
+        data[ i ] = static_cast< uint8_t >( 0x3A + i );
+
+    out.hex_dump( data, sizeof( data ), 0x10 );
+    ASSERT_STREQ( out.c_str(),
+                  "00000010  3a 3b 3c 3d 3e 3f 40 41  42 43 44 45 46 47 48 49  |:;<=>?@ABCDEFGHI|\n"
+                  "00000020  4a 4b 4c 4d                                       |JKLM|\n" );
+}
+
+// Check tables line up
+TEST( FormatTest, Table )
+{
+    using namespace aero::print;
+
+    char buf[ 256 ];
+    Formatter out( buf, sizeof( buf ) );
+    const Column columns[] = { { "time", 6, -1 }, { "alt", 7, 1 }, { "state", 5, -1 } };
+    Table< 3 > table( out, columns );
+
+    table.header();
+    table.row( 120u, 251.36f, "up" );
+    table.row( -5, 0.04, "flt" );
+
+    ASSERT_STREQ( out.c_str(),
+                  "  time     alt state\n"
+                  "------ ------- -----\n"
+                  "   120   251.4    up\n"
+                  "    -5     0.0   flt\n" );
+}
+
+// Check a full buffer is flushed to the sink and without one the length is still counted
+TEST( FormatTest, Sinks )
+{
+    using namespace aero::print;
+
+    char small[ 8 ];
+    Formatter clipped( small, sizeof( small ) );
+    clipped.text( "0123456789" );
+    ASSERT_STREQ( clipped.c_str(), "0123456" );
+    ASSERT_EQ( clipped.length(), 10u );
+    ASSERT_TRUE( clipped.truncated() );
+    ASSERT_FALSE( clipped.flush() );
+
+    // File sink, flushed several times through a small buffer
+    FILE* file = tmpfile();
+    ASSERT_NE( file, nullptr );
+    {
+        Formatter out( small, sizeof( small ), to( file ) );
+        out.text( "pressure " ).fixed( 101325.0f, 1 ).line();
+        ASSERT_TRUE( out.flush() );
+        ASSERT_FALSE( out.truncated() );
+    }
+    rewind( file );
+    char read_back[ 32 ] = {};
+    ASSERT_EQ( fread( read_back, 1, sizeof( read_back ), file ), 18u );
+    ASSERT_STREQ( read_back, "pressure 101325.0\n" );
+    fclose( file );
+
+    // File descriptor sink
+    int fds[ 2 ];
+    ASSERT_EQ( pipe( fds ), 0 );
+    {
+        Formatter out( small, sizeof( small ), to_fd( fds[ 1 ] ) );
+        out.hex( 0xCAFE ).put( ' ' ).real( 2.5f );
+        ASSERT_TRUE( out.flush() );
+    }
+    char piped[ 16 ] = {};
+    ASSERT_EQ( read( fds[ 0 ], piped, sizeof( piped ) ), 8 );
+    ASSERT_STREQ( piped, "CAFE 2.5" );
+    close( fds[ 0 ] );
+    close( fds[ 1 ] );
+}
+
+#endif
@@ -0,0 +1,147 @@
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+// File for testing the stream frame decoder
+#include <gtest/gtest.h>
+#include <iostream>
+#include <vector>
+#include "../include/FrameDecoder.hpp"
+#include "../include/Schema.hpp"
+
+class FrameDecoderTest : public ::testing::Test
+{
+
+protected:
+
+    using Telemetry = aero::Schema< aero::def::IMU_t, aero::def::Status_t >;
+    using Small = aero::Schema< aero::def::Battery_t >;
+
+    // Test suite pre-test construction
+    void SetUp ( void ) override
+    {
+        decoder = aero::FrameDecoder( on_frame, this );
+    }
+
+    // Records every frame the decoder emits
+    static void on_frame( const aero::MessageView& frame, void* context )
+    {
+        FrameDecoderTest* test = static_cast< FrameDecoderTest* >( context );
+        test->signatures.push_back( frame.signature() );
+
+        aero::def::Status_t status;
+        if( frame.copy( status ) )
+            test->states.push_back( status.state );
+    }
+
+    // Append a telemetry frame to the stream
+    void add_frame( uint32_t state )
+    {
+        aero::def::IMU_t imu = {};
+        imu.ax = aero::def::START_BYTE;     // Start byte value inside the payload
+        aero::def::Status_t status = { 0.0f, state };
+
+        uint8_t buf[ Telemetry::frame_size ];
+        Telemetry::build( buf, aero::def::ID::Plane, aero::def::ID::Gnd, imu, status );
+        stream.insert( stream.end(), buf, buf + sizeof( buf ) );
+    }
+
+    // Feed the whole stream in chunks of a set size
+    void feed_in_chunks( size_t chunk )
+    {
+        for( size_t i = 0; i < stream.size(); i += chunk )
+            decoder.feed( stream.data() + i, std::min( chunk, stream.size() - i ) );
+    }
+
+    // Unit under test
+    aero::FrameDecoder decoder;
+
+    std::vector< uint8_t > stream;
+    std::vector< uint16_t > signatures;
+    std::vector< uint32_t > states;
+};
+
+// Whole frames in one chunk are all found
+TEST_F( FrameDecoderTest, WholeChunk )
+{
+    for( uint32_t i = 0; i < 10; ++i )
+        add_frame( i );
+
+    ASSERT_EQ( decoder.feed( stream.data(), stream.size() ), 10u );
+    ASSERT_EQ( states.size(), 10u );
+    for( uint32_t i = 0; i < 10; ++i )
+        ASSERT_EQ( states[ i ], i );
+
+    ASSERT_EQ( decoder.dropped(), 0u );
+    ASSERT_EQ( decoder.pending(), 0u );
+}
+
+// Frames split over any chunk size are reassembled
+TEST_F( FrameDecoderTest, SplitChunks )
+{
+    for( uint32_t i = 0; i < 5; ++i )
+        add_frame( i );
+
+    for( size_t chunk = 1; chunk < Telemetry::frame_size + 3; ++chunk )
+    {
+        states.clear();
+        feed_in_chunks( chunk );
+
+        ASSERT_EQ( states.size(), 5u ) << "Chunk size " << chunk;
+        for( uint32_t i = 0; i < 5; ++i )
+            ASSERT_EQ( states[ i ], i ) << "Chunk size " << chunk;
+    }
+
+    ASSERT_EQ( decoder.dropped(), 0u );
+}
+
+// Garbage and corrupted frames are skipped without losing the good ones
+TEST_F( FrameDecoderTest, Resync )
+{
+    const uint8_t noise[] = { 0x00, aero::def::START_BYTE, 0xFF, aero::def::START_BYTE, 0x01, 0x00, 0x00 };
+
+    add_frame( 1 );
+    stream.insert( stream.end(), noise, noise + sizeof( noise ) );
+    add_frame( 2 );
+
+    // Corrupt a payload byte of the third frame
+    size_t corrupt = stream.size() + aero::def::HEADER_SIZE + 4;
+    add_frame( 3 );
+    stream[ corrupt ] ^= 0x40;
+
+    add_frame( 4 );
+
+    // Cut off frame at the end waits for more bytes
+    add_frame( 5 );
+    stream.resize( stream.size() - 4 );
+
+    for( size_t chunk : { stream.size(), (size_t) 1, (size_t) 7, (size_t) 64 } )
+    {
+        states.clear();
+        decoder.reset();
+        feed_in_chunks( chunk );
+
+        ASSERT_EQ( states, ( std::vector< uint32_t >{ 1, 2, 4 } ) ) << "Chunk size " << chunk;
+        ASSERT_GT( decoder.pending(), 0u );
+    }
+}
+
+// Frames of different schemas share one stream
+TEST_F( FrameDecoderTest, MixedSchemas )
+{
+    aero::def::Battery_t battery = { 12.6f, 1.5f };
+    uint8_t buf[ Small::frame_size ];
+    Small::build( buf, aero::def::ID::Plane, aero::def::ID::Gnd, battery );
+
+    add_frame( 1 );
+    stream.insert( stream.end(), buf, buf + sizeof( buf ) );
+    add_frame( 2 );
+
+    feed_in_chunks( 5 );
+
+    ASSERT_EQ( signatures, ( std::vector< uint16_t >{ Telemetry::signature, Small::signature, Telemetry::signature } ) );
+    ASSERT_EQ( decoder.frames(), 3u );
+}
+
+#endif
@@ -0,0 +1,270 @@
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+// File for testing the NMEA and UBX GPS parser
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "../include/GpsParser.hpp"
+
+namespace
+{
+    // Sentence with its checksum and line end added
+    std::string nmea( const std::string& body )
+    {
+        uint8_t sum = 0;
+        for( size_t i = 0; i < body.size(); ++i )
+            sum ^= static_cast< uint8_t >( body[ i ] );
+
+        char tail[ 8 ];
+        snprintf( tail, sizeof( tail ), "*%02X\r\n", sum );
+        return "$" + body + tail;
+    }
+
+    void put( std::vector< uint8_t >& out, size_t at, uint32_t value, size_t bytes )
+    {
+        for( size_t i = 0; i < bytes; ++i )
+            out[ at + i ] = static_cast< uint8_t >( value >> ( 8 * i ) );
+    }
+
+    // NAV-PVT with the fields the parser reads, 3D fix at 43.0096 -81.2737
+    std::vector< uint8_t > nav_pvt( uint8_t flags = 0x01 )
+    {
+        std::vector< uint8_t > payload( 92, 0 );
+        put( payload, 4, 2021, 2 );                                 // Year
+        payload[ 6 ] = 7;                                           // Month
+        payload[ 7 ] = 14;                                          // Day
+        payload[ 8 ] = 16;                                          // Hour
+        payload[ 9 ] = 5;                                           // Minute
+        payload[ 10 ] = 42;                                         // Second
+        payload[ 11 ] = 0x03;                                       // Date and time valid
+        put( payload, 16, 250000000, 4 );                           // Nanoseconds
+        payload[ 20 ] = 3;                                          // 3D fix
+        payload[ 21 ] = flags;
+        payload[ 23 ] = 14;                                         // Satellites
+        put( payload, 24, static_cast< uint32_t >( -812737000 ), 4 );  // Longitude
+        put( payload, 28, 430096000, 4 );                           // Latitude
+        put( payload, 36, 251300, 4 );                              // Height above MSL [ mm ]
+        put( payload, 60, 17250, 4 );                               // Ground speed [ mm/s ]
+
+        std::vector< uint8_t > out = { 0xB5, 0x62, 0x01, 0x07, 92, 0 };
+        out.insert( out.end(), payload.begin(), payload.end() );
+
+        uint8_t a = 0, b = 0;
+        for( size_t i = 2; i < out.size(); ++i )
+        {
+            a = static_cast< uint8_t >( a + out[ i ] );
+            b = static_cast< uint8_t >( b + a );
+        }
+        out.push_back( a );
+        out.push_back( b );
+        return out;
+    }
+
+    size_t feed( aero::GpsParser& parser, const std::string& text )
+    {
+        return parser.feed( reinterpret_cast< const uint8_t* >( text.data() ), text.size() );
+    }
+}
+
+// The textbook GGA and RMC sentences
+TEST( GpsParserTest, Nmea )
+{
+    aero::GpsParser parser;
+
+    ASSERT_EQ( feed( parser, "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n" ), 1u );
+    const aero::def::GPS_t& gps = parser.data();
+    ASSERT_TRUE( gps.fix );
+    ASSERT_EQ( gps.time, 12351900u );
+    ASSERT_NEAR( gps.lat, 48.0 + 7.038 / 60.0, 1e-5 );
+    ASSERT_NEAR( gps.lon, 11.0 + 31.0 / 60.0, 1e-5 );
+    ASSERT_EQ( gps.quality, 1u );
+    ASSERT_EQ( gps.satellites, 8u );
+    ASSERT_EQ( gps.HDOP, 90u );
+    ASSERT_FLOAT_EQ( gps.altitude, 545.4f );
+
+    ASSERT_EQ( feed( parser, "$GPRMC,123520,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6A\r\n" ), 0u );
+    ASSERT_EQ( parser.errors(), 1u );
+
+    ASSERT_EQ( feed( parser, nmea( "GNRMC,123520.40,A,4807.03812,S,01131.00050,W,022.4,084.4,230394,003.1,W,A" ) ), 1u );
+    ASSERT_EQ( gps.time, 12352040u );
+    ASSERT_EQ( gps.date, 230394u );
+    ASSERT_NEAR( gps.lat, -( 48.0 + 7.03812 / 60.0 ), 1e-5 );
+    ASSERT_NEAR( gps.lon, -( 11.0 + 31.0005 / 60.0 ), 1e-5 );
+    ASSERT_NEAR( gps.speed, 22.4f * 0.514444f, 1e-4f );
+    ASSERT_EQ( gps.satellites, 8u );
+    ASSERT_EQ( parser.messages(), 2u );
+}
+
+// Sentences without a fix clear it and leave the last position
+TEST( GpsParserTest, NoFix )
+{
+    aero::GpsParser parser;
+
+    feed( parser, nmea( "GPGGA,101500.00,4300.57600,N,08116.42200,W,2,11,0.78,251.3,M,-35.3,M,,0000" ) );
+    ASSERT_TRUE( parser.data().fix );
+    ASSERT_EQ( parser.data().quality, 2u );
+    ASSERT_FLOAT_EQ( parser.data().altitude, 251.3f );
+
+    ASSERT_EQ( feed( parser, nmea( "GPGGA,101501.00,,,,,0,03,99.99,,,,,," ) ), 1u );
+    ASSERT_FALSE( parser.data().fix );
+    ASSERT_EQ( parser.data().time, 10150100u );
+    ASSERT_EQ( parser.data().HDOP, 9999u );
+    ASSERT_NEAR( parser.data().lat, 43.0096f, 1e-5f );
+    ASSERT_NEAR( parser.data().lon, -81.2737f, 1e-5f );
+
+    feed( parser, nmea( "GPRMC,101502.00,A,4300.57600,N,08116.42200,W,0.0,,140721,,,N" ) );
+    ASSERT_FALSE( parser.data().fix );
+
+    feed( parser, nmea( "GPRMC,101503.00,V,,,,,,,140721,,,N" ) );
+    ASSERT_FALSE( parser.data().fix );
+    ASSERT_EQ( parser.data().date, 140721u );
+    ASSERT_EQ( parser.messages(), 4u );
+    ASSERT_EQ( parser.errors(), 0u );
+}
+
+// Other sentences and noise are skipped, broken sentences counted
+TEST( GpsParserTest, Skips )
+{
+    aero::GpsParser parser;
+    std::string stream = nmea( "GPGSV,3,1,11,03,03,111,00,04,15,270,00,06,01,010,00,13,06,292,00" )
+                         + "\x01\x02 garbage \r\n"
+                         + nmea( "GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1" )
+                         + "$GPGGA,123519,4807.038,N,01131.000,E,1"        // Cut off by the next $
+                         + nmea( "GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,," )
+                         + "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*4G\r\n"
+                         + "$GPGGA,12\n3519,4807.038,N*00\r\n"
+                         + "$GPGGA," + std::string( 90, '1' ) + "*00\r\n";
+
+    ASSERT_EQ( feed( parser, stream ), 1u );
+    ASSERT_EQ( parser.messages(), 1u );
+    ASSERT_EQ( parser.errors(), 4u );
+    ASSERT_EQ( parser.data().satellites, 8u );
+}
+
+// A sentence cut short by a UBX frame or another sentence doesn't cost the next message
+TEST( GpsParserTest, Resync )
+{
+    aero::GpsParser parser;
+    std::vector< uint8_t > stream;
+    std::string cut = "$GPGGA,123519,4807.038,N,01131.000,E,1";
+    std::vector< uint8_t > pvt = nav_pvt();
+
+    stream.insert( stream.end(), cut.begin(), cut.end() );
+    stream.insert( stream.end(), pvt.begin(), pvt.end() );
+
+    // Cut in the checksum
+    std::string sum = nmea( "GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,," );
+    std::string text = sum.substr( 0, sum.size() - 3 );
+    stream.insert( stream.end(), text.begin(), text.end() );
+    stream.insert( stream.end(), pvt.begin(), pvt.end() );
+    text = sum.substr( 0, sum.size() - 4 ) + nmea( "GPGGA,123520,4807.038,N,01131.000,E,1,09,0.9,545.4,M,46.9,M,," );
+    stream.insert( stream.end(), text.begin(), text.end() );
+
+    ASSERT_EQ( parser.feed( stream.data(), stream.size() ), 3u );
+    ASSERT_EQ( parser.messages(), 3u );
+    ASSERT_EQ( parser.errors(), 3u );
+    ASSERT_EQ( parser.data().satellites, 9u );
+}
+
+// UBX NAV-PVT fills everything but HDOP
+TEST( GpsParserTest, NavPvt )
+{
+    aero::GpsParser parser;
+    std::vector< uint8_t > pvt = nav_pvt();
+
+    ASSERT_EQ( parser.feed( pvt.data(), pvt.size() ), 1u );
+    const aero::def::GPS_t& gps = parser.data();
+    ASSERT_TRUE( gps.fix );
+    ASSERT_EQ( gps.quality, 1u );
+    ASSERT_EQ( gps.satellites, 14u );
+    ASSERT_EQ( gps.time, 16054225u );
+    ASSERT_EQ( gps.date, 140721u );
+    ASSERT_NEAR( gps.lat, 43.0096f, 1e-6f );
+    ASSERT_NEAR( gps.lon, -81.2737f, 1e-5f );
+    ASSERT_FLOAT_EQ( gps.altitude, 251.3f );
+    ASSERT_FLOAT_EQ( gps.speed, 17.25f );
+    ASSERT_EQ( gps.HDOP, 0u );
+
+    // Differential and RTK fixes, then no fix
+    pvt = nav_pvt( 0x03 );
+    parser.feed( pvt.data(), pvt.size() );
+    ASSERT_EQ( gps.quality, 2u );
+    pvt = nav_pvt( 0x83 );
+    parser.feed( pvt.data(), pvt.size() );
+    ASSERT_EQ( gps.quality, 4u );
+    pvt = nav_pvt( 0x00 );
+    parser.feed( pvt.data(), pvt.size() );
+    ASSERT_FALSE( gps.fix );
+    ASSERT_EQ( gps.quality, 0u );
+
+    // Bad checksum, and other UBX messages are skipped by their length
+    pvt = nav_pvt();
+    pvt[ 40 ] ^= 1;
+    ASSERT_EQ( parser.feed( pvt.data(), pvt.size() ), 0u );
+    ASSERT_EQ( parser.errors(), 1u );
+
+    const uint8_t ack[] = { 0xB5, 0x62, 0x05, 0x01, 0x02, 0x00, 0x06, 0x01, 0x0F, 0x38 };
+    ASSERT_EQ( parser.feed( ack, sizeof( ack ) ), 0u );
+    ASSERT_EQ( parser.errors(), 1u );
+    ASSERT_EQ( parser.messages(), 4u );
+}
+
+// A mixed stream gives the same result however it is split
+TEST( GpsParserTest, Chunks )
+{
+    std::vector< uint8_t > stream;
+    std::string text = nmea( "GNGGA,101500.00,4300.57600,N,08116.42200,W,1,11,0.78,251.3,M,-35.3,M,," )
+                       + nmea( "GNGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1" )
+                       + nmea( "GNRMC,101500.00,A,4300.57600,N,08116.42200,W,0.5,,140721,,,A" );
+    std::vector< uint8_t > pvt = nav_pvt();
+    stream.insert( stream.end(), text.begin(), text.end() );
+    stream.insert( stream.end(), pvt.begin(), pvt.end() );
+    stream.insert( stream.end(), text.begin(), text.end() );
+
+    aero::GpsParser whole;
+    ASSERT_EQ( whole.feed( stream.data(), stream.size() ), 5u );
+
+    for( size_t chunk = 1; chunk <= 64; ++chunk )
+    {
+        aero::GpsParser parser;
+        size_t applied = 0;
+        for( size_t at = 0; at < stream.size(); at += chunk )
+            applied += parser.feed( stream.data() + at, std::min( chunk, stream.size() - at ) );
+
+        ASSERT_EQ( applied, 5u );
+        ASSERT_EQ( parser.errors(), 0u );
+        ASSERT_EQ( memcmp( &parser.data(), &whole.data(), sizeof( aero::def::GPS_t ) ), 0 );
+    }
+}
+
+// The callback sees every applied message
+TEST( GpsParserTest, Callback )
+{
+    struct Seen
+    {
+        std::vector< aero::GpsParser::Message > messages;
+
+        static void callback( const aero::def::GPS_t& data, aero::GpsParser::Message message, void* context )
+        {
+            ASSERT_TRUE( data.fix );
+            static_cast< Seen* >( context )->messages.push_back( message );
+        }
+    } seen;
+
+    aero::GpsParser parser( Seen::callback, &seen );
+    std::vector< uint8_t > pvt = nav_pvt();
+    feed( parser, nmea( "GPRMC,101500.00,A,4300.57600,N,08116.42200,W,0.5,,140721,,,A" ) );
+    parser.feed( pvt.data(), pvt.size() );
+    feed( parser, nmea( "GPGGA,101500.00,4300.57600,N,08116.42200,W,1,11,0.78,251.3,M,-35.3,M,," ) );
+
+    ASSERT_EQ( seen.messages.size(), 3u );
+    ASSERT_EQ( seen.messages[ 0 ], aero::GpsParser::RMC );
+    ASSERT_EQ( seen.messages[ 1 ], aero::GpsParser::NAV_PVT );
+    ASSERT_EQ( seen.messages[ 2 ], aero::GpsParser::GGA );
+}
+
+#endif
@@ -0,0 +1,239 @@
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+// File for testing the memory mapped frame log
+#include <gtest/gtest.h>
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+#include <thread>
+#include "../include/Log.hpp"
+#include "../include/Schema.hpp"
+
+class LogTest : public ::testing::Test
+{
+
+protected:
+
+    using Fast = aero::Schema< aero::def::IMU_t, aero::def::Status_t >;
+    using Slow = aero::Schema< aero::def::GPS_t, aero::def::Status_t >;
+
+    void SetUp( void ) override
+    {
+        char name[] = "/tmp/aero_log_XXXXXX";
+        int fd = mkstemp( name );
+        close( fd );
+        path = name;
+    }
+
+    void TearDown( void ) override
+    {
+        unlink( path.c_str() );
+    }
+
+    // Write frames at 1 ms with a GPS frame every 10 ms, topping up the
+    // preallocated space every 100 frames like a housekeeping call would
+    void write_flight( aero::LogWriter& writer, uint32_t count )
+    {
+        uint8_t buf[ aero::def::MAX_FRAME_SIZE ];
+        aero::def::IMU_t imu = {};
+        aero::def::GPS_t gps = {};
+
+        for( uint32_t i = 0; i < count; ++i )
+        {
+            if( i % 100 == 0 )
+            {
+                ASSERT_TRUE( writer.reserve() );
+            }
+
+            aero::def::Status_t status = { 0.0f, i };
+            size_t size = i % 10 == 0 ? Slow::build( buf, aero::def::ID::Plane, aero::def::ID::Gnd, gps, status )
+                                      : Fast::build( buf, aero::def::ID::Plane, aero::def::ID::Gnd, imu, status );
+
+            ASSERT_TRUE( writer.append( aero::MessageView( buf, size ), 1000 * i ) );
+        }
+    }
+
+    // Build the frame for a state
+    static size_t build_frame( uint8_t* buf, uint32_t i )
+    {
+        aero::def::IMU_t imu = {};
+        aero::def::Status_t status = { 0.0f, i };
+        return Fast::build( buf, aero::def::ID::Plane, aero::def::ID::Gnd, imu, status );
+    }
+
+    // Records the state of every frame a query returns
+    static void on_record( uint64_t time_us, const aero::MessageView& frame, void* context )
+    {
+        aero::def::Status_t status;
+        ASSERT_TRUE( frame.copy( status ) );
+        ASSERT_EQ( time_us, 1000 * status.state );
+        static_cast< std::vector< uint32_t >* >( context )->push_back( status.state );
+    }
+
+    std::string path;
+};
+
+// Check queries by time and segment return exactly the matching frames
+TEST_F( LogTest, Query )
+{
+    // Small reserve so the file has to grow several times
+    aero::LogWriter writer( 64 << 10, 16 << 10, 64 );
+    ASSERT_TRUE( writer.open( path.c_str() ) );
+    write_flight( writer, 10000 );
+
+    // Invalid frames are refused
+    uint8_t junk[ 16 ] = {};
+    ASSERT_FALSE( writer.append( aero::MessageView( junk, sizeof( junk ) ), 0 ) );
+    ASSERT_TRUE( writer.close() );
+
+    aero::LogReader reader;
+    ASSERT_TRUE( reader.open( path.c_str() ) );
+    ASSERT_TRUE( reader.indexed() );
+    ASSERT_EQ( reader.records(), 10000u );
+    ASSERT_EQ( reader.blocks(), 157u );
+
+    // GPS between 2.5 s and 3.5 s inclusive
+    std::vector< uint32_t > states;
+    ASSERT_EQ( reader.query( 2500000, 3500000, aero::schema::bit_of< aero::def::GPS_t >(), on_record, &states ), 101u );
+    ASSERT_EQ( states.front(), 2500u );
+    ASSERT_EQ( states.back(), 3500u );
+
+    // Any segment in a short window
+    states.clear();
+    ASSERT_EQ( reader.query( 100, 4000, 0, on_record, &states ), 4u );
+    ASSERT_EQ( states, ( std::vector< uint32_t >{ 1, 2, 3, 4 } ) );
+
+    ASSERT_EQ( reader.query( 0, UINT64_MAX, 0, NULL, NULL ), 10000u );
+    ASSERT_EQ( reader.query( 20000000, UINT64_MAX, 0, NULL, NULL ), 0u );
+}
+
+// Check append() stops at the preallocated space instead of growing the file
+TEST_F( LogTest, Full )
+{
+    aero::LogWriter writer( 16 << 10, 1 << 20, 64 );
+    ASSERT_TRUE( writer.open( path.c_str() ) );
+
+    uint8_t buf[ aero::def::MAX_FRAME_SIZE ];
+    uint32_t stored = 0;
+    while( writer.append( aero::MessageView( buf, build_frame( buf, stored ) ), 1000 * stored ) )
+        ++stored;
+
+    ASSERT_GT( stored, 0u );
+    ASSERT_LE( writer.size(), 16u << 10 );
+
+    // Topping up makes room again
+    ASSERT_TRUE( writer.reserve() );
+    ASSERT_TRUE( writer.append( aero::MessageView( buf, build_frame( buf, stored ) ), 1000 * stored ) );
+    ++stored;
+    ASSERT_TRUE( writer.close() );
+
+    aero::LogReader reader;
+    ASSERT_TRUE( reader.open( path.c_str() ) );
+    ASSERT_EQ( reader.records(), stored );
+    ASSERT_EQ( reader.query( 0, UINT64_MAX, 0, NULL, NULL ), stored );
+}
+
+// Check the file can grow on another thread while frames are appended
+TEST_F( LogTest, ReserveThread )
+{
+    aero::LogWriter writer( 64 << 10, 16 << 10, 64 );
+    ASSERT_TRUE( writer.open( path.c_str() ) );
+
+    bool done = false;
+    std::thread housekeeping( [ & ]( )
+    {
+        while( !__atomic_load_n( &done, __ATOMIC_ACQUIRE ) )
+        {
+            writer.reserve();
+            std::this_thread::yield();
+        }
+    } );
+
+    // Frames that find the space full are dropped, the rest must all read back
+    uint8_t buf[ aero::def::MAX_FRAME_SIZE ];
+    std::vector< uint32_t > stored;
+    for( uint32_t i = 0; i < 20000; ++i )
+        if( writer.append( aero::MessageView( buf, build_frame( buf, i ) ), 1000 * i ) )
+            stored.push_back( i );
+
+    __atomic_store_n( &done, true, __ATOMIC_RELEASE );
+    housekeeping.join();
+    ASSERT_TRUE( writer.close() );
+
+    aero::LogReader reader;
+    ASSERT_TRUE( reader.open( path.c_str() ) );
+    std::vector< uint32_t > states;
+    ASSERT_EQ( reader.query( 0, UINT64_MAX, 0, on_record, &states ), stored.size() );
+    ASSERT_EQ( states, stored );
+}
+
+// Check a damaged index can't send the reader outside the records
+TEST_F( LogTest, Corrupt )
+{
+    aero::LogWriter writer( 1 << 20, 1 << 20, 64 );
+    ASSERT_TRUE( writer.open( path.c_str() ) );
+    write_flight( writer, 1000 );
+    ASSERT_TRUE( writer.close() );
+
+    aero::logfile::Header header;
+    FILE* file = fopen( path.c_str(), "r+b" );
+    ASSERT_TRUE( file != NULL );
+    ASSERT_EQ( fread( &header, sizeof( header ), 1, file ), 1u );
+    aero::logfile::byte_order( header );
+
+    // The last block claims more records than are left before data_end
+    aero::logfile::Block block;
+    const long last = header.index_offset + ( header.index_count - 1 ) * sizeof( block );
+    fseek( file, last, SEEK_SET );
+    ASSERT_EQ( fread( &block, sizeof( block ), 1, file ), 1u );
+    aero::logfile::byte_order( block );
+    block.count = 1000000;
+    aero::logfile::byte_order( block );
+    fseek( file, last, SEEK_SET );
+    ASSERT_EQ( fwrite( &block, sizeof( block ), 1, file ), 1u );
+    fflush( file );
+
+    aero::LogReader reader;
+    ASSERT_TRUE( reader.open( path.c_str() ) );
+    ASSERT_TRUE( reader.indexed() );
+    ASSERT_EQ( reader.query( 0, UINT64_MAX, 0, NULL, NULL ), 1000u );
+
+    // A block past data_end makes the reader rebuild the index from the records
+    aero::logfile::byte_order( block );
+    block.offset = header.data_end + 64;
+    aero::logfile::byte_order( block );
+    fseek( file, last, SEEK_SET );
+    ASSERT_EQ( fwrite( &block, sizeof( block ), 1, file ), 1u );
+    fclose( file );
+
+    ASSERT_TRUE( reader.open( path.c_str() ) );
+    ASSERT_FALSE( reader.indexed() );
+    ASSERT_EQ( reader.records(), 1000u );
+    ASSERT_EQ( reader.query( 0, UINT64_MAX, 0, NULL, NULL ), 1000u );
+}
+
+// Check a log that was never closed can still be read
+TEST_F( LogTest, Unclosed )
+{
+    aero::LogWriter writer( 1 << 20, 1 << 20, 64 );
+    ASSERT_TRUE( writer.open( path.c_str() ) );
+    write_flight( writer, 1000 );
+    writer.sync();
+
+    aero::LogReader reader;
+    ASSERT_TRUE( reader.open( path.c_str() ) );
+    ASSERT_FALSE( reader.indexed() );
+    ASSERT_EQ( reader.records(), 1000u );
+
+    std::vector< uint32_t > states;
+    ASSERT_EQ( reader.query( 0, UINT64_MAX, aero::schema::bit_of< aero::def::GPS_t >(), on_record, &states ), 100u );
+
+    // Not a log
+    reader.close();
+    ASSERT_FALSE( reader.open( "/dev/null" ) );
+}
+
+#endif
@@ -0,0 +1,152 @@
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+// File for testing the zero-copy message view
+#include <gtest/gtest.h>
+#include <cstring>
+#include "../include/Message.hpp"
+
+// Builds a frame by hand so the view can be tested on its own
+static size_t make_frame( uint8_t* buf, uint16_t signature, const uint8_t* payload, uint16_t length )
+{
+    using namespace aero::def;
+
+    buf[ 0 ] = START_BYTE;
+    buf[ 1 ] = link( ID::Gnd, ID::G1 );
+    memcpy( buf + 2, &signature, sizeof( signature ) );
+    memcpy( buf + 4, &length, sizeof( length ) );
+    if( length > 0 )
+        memcpy( buf + HEADER_SIZE, payload, length );
+
+    seal( buf, signature, length );
+
+    return frame_size( signature, length );
+}
+
+// Check the view finds segments in place without copying them
+TEST( AeroMessageViewTest, TypedAccess )
+{
+    using namespace aero;
+    using namespace aero::def;
+
+    IMU_t imu = {};
+    imu.ax = 5; imu.ay = 10; imu.az = 15;
+
+    Battery_t bat = {};
+    bat.voltage = 25; bat.current = 12;
+
+    Commands_t cmd = {};
+    cmd.drop = 99; cmd.servos = 8; cmd.pitch = 1;
+
+    uint8_t payload[ MAX_PAYLOAD_SIZE ];
+    size_t offset = 0;
+    memcpy( payload + offset, &imu, sizeof( imu ) ); offset += sizeof( imu );
+    memcpy( payload + offset, &bat, sizeof( bat ) ); offset += sizeof( bat );
+    memcpy( payload + offset, &cmd, sizeof( cmd ) ); offset += sizeof( cmd );
+
+    uint16_t signature = ( 1 << 1 ) | ( 1 << 4 ) | ( 1 << 9 );
+    uint8_t buf[ MAX_FRAME_SIZE + 10 ];
+    size_t size = make_frame( buf, signature, payload, offset );
+
+    MessageView view( buf, sizeof( buf ) );
+
+    ASSERT_TRUE( view.valid() );
+    ASSERT_EQ( view.size(), size );
+    ASSERT_EQ( view.signature(), signature );
+    ASSERT_EQ( view.from(), ID::Gnd );
+    ASSERT_EQ( view.to(), ID::G1 );
+
+    // Segments point straight into the receive buffer
+    ASSERT_EQ( view.segment( Signature::IMU ), buf + HEADER_SIZE );
+    ASSERT_EQ( view.segment( Signature::Battery ), buf + HEADER_SIZE + sizeof( IMU_t ) );
+    ASSERT_EQ( view.segment( Signature::GPS ) == NULL, true ) << " Segment not in signature should be NULL ";
+    ASSERT_EQ( view.segment( Signature::Enviro ) == NULL, true ) << " Segment not in signature should be NULL ";
+
+    IMU_t imu_out;
+    Battery_t bat_out;
+    GPS_t gps_out;
+    ASSERT_TRUE( view.copy( imu_out ) );
+    ASSERT_TRUE( view.copy( bat_out ) );
+    ASSERT_FALSE( view.copy( gps_out ) );
+    ASSERT_EQ( imu_out.az, imu.az );
+    ASSERT_EQ( bat_out.voltage, bat.voltage );
+
+    Commands_t cmd_out;
+    ASSERT_TRUE( view.copy( cmd_out ) );
+    ASSERT_EQ( cmd_out.drop, cmd.drop );
+    ASSERT_EQ( cmd_out.servos, cmd.servos );
+    ASSERT_EQ( cmd_out.pitch, cmd.pitch );
+}
+
+// Check the view rejects frames that are damaged or cut short
+TEST( AeroMessageViewTest, Validation )
+{
+    using namespace aero;
+    using namespace aero::def;
+
+    Status_t status = { 1.5f, 7 };
+    uint8_t buf[ MAX_FRAME_SIZE ];
+    size_t size = make_frame( buf, 1 << 6, (const uint8_t *) &status, sizeof( status ) );
+
+    ASSERT_TRUE( MessageView( buf, size ).valid() );
+
+    // Truncated frame
+    ASSERT_FALSE( MessageView( buf, size - 1 ).valid() );
+    ASSERT_FALSE( MessageView( buf, 2 ).valid() );
+    ASSERT_FALSE( MessageView( NULL, size ).valid() );
+
+    // Corrupted payload byte fails the crc
+    buf[ HEADER_SIZE ] ^= 0x01;
+    ASSERT_FALSE( MessageView( buf, size ).valid() );
+    ASSERT_EQ( MessageView( buf, size ).segment( Signature::Status ) == NULL, true );
+    buf[ HEADER_SIZE ] ^= 0x01;
+
+    // Length that doesn't match the signature
+    uint16_t bad_length = sizeof( status ) + 1;
+    memcpy( buf + 4, &bad_length, sizeof( bad_length ) );
+    ASSERT_FALSE( MessageView( buf, sizeof( buf ) ).valid() );
+
+    // Empty message is valid and has no segments
+    size = make_frame( buf, 0, NULL, 0 );
+    MessageView empty( buf, size );
+    ASSERT_TRUE( empty.valid() );
+    ASSERT_EQ( empty.length(), 0 );
+    for( int i = 0; i < static_cast< int >( Signature::Count ); ++i )
+        ASSERT_FALSE( empty.has( static_cast< Signature >( i ) ) );
+}
+
+// Check frames sealed with either crc are accepted
+TEST( AeroMessageViewTest, Crc32Frames )
+{
+    using namespace aero;
+    using namespace aero::def;
+
+    Status_t status = { 1.5f, 7 };
+    uint8_t buf[ MAX_FRAME_SIZE ];
+    size_t size = make_frame( buf, ( 1 << 6 ) | CRC32_FLAG, (const uint8_t *) &status, sizeof( status ) );
+
+    ASSERT_EQ( size, HEADER_SIZE + sizeof( status ) + 5 );
+
+    MessageView view( buf, size );
+    ASSERT_TRUE( view.valid() );
+    ASSERT_EQ( view.signature(), 1 << 6 );
+    ASSERT_EQ( view.flags(), CRC32_FLAG );
+    Status_t status_out;
+    ASSERT_TRUE( view.copy( status_out ) );
+    ASSERT_EQ( status_out.state, status.state );
+
+    // Every single bit flip in the payload or crc is caught
+    for( size_t i = HEADER_SIZE; i < size - 1; ++i )
+    {
+        for( int bit = 0; bit < 8; ++bit )
+        {
+            buf[ i ] ^= ( 1 << bit );
+            ASSERT_FALSE( MessageView( buf, size ).valid() ) << "Byte " << i << " bit " << bit;
+            buf[ i ] ^= ( 1 << bit );
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,136 @@
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+// File for testing radio packet aggregation
+#include <gtest/gtest.h>
+#include <iostream>
+#include <vector>
+#include "../include/Packet.hpp"
+#include "../include/Schema.hpp"
+
+// Radio that keeps every packet it is asked to send
+class MockRadio : public aero::sensor::Radio
+{
+public:
+    bool init( ) override { return true; }
+    bool update( ) override { return true; }
+    bool ready( ) override { return false; }
+    bool receive( uint8_t*, uint8_t* ) override { return false; }
+
+    bool send( uint8_t* buf, uint8_t len ) override
+    {
+        if( fail )
+            return false;
+
+        packets.push_back( std::vector< uint8_t >( buf, buf + len ) );
+        return true;
+    }
+
+    bool fail = false;
+    std::vector< std::vector< uint8_t > > packets;
+};
+
+class PacketTest : public ::testing::Test
+{
+
+protected:
+
+    using Tick = aero::Schema< aero::def::Status_t, aero::def::Battery_t, aero::def::DropAlgo_t >;
+
+    // Build one telemetry frame for a tick
+    size_t make_tick( uint8_t* buf, uint32_t tick )
+    {
+        aero::def::Status_t status = { -60.0f, tick };
+        aero::def::Battery_t battery = { 12.6f, 2.0f };
+        aero::def::DropAlgo_t drop = { 90, 150 };
+
+        return Tick::build( buf, aero::def::ID::Plane, aero::def::ID::Gnd, status, battery, drop );
+    }
+
+    // Records the state of every frame found in a packet
+    static void on_frame( const aero::MessageView& frame, void* context )
+    {
+        aero::def::Status_t status;
+        if( frame.copy( status ) )
+            static_cast< std::vector< uint32_t >* >( context )->push_back( status.state );
+    }
+
+    MockRadio radio;
+    aero::PacketAggregator<> packet;
+};
+
+// Check frames are packed until the packet is full
+TEST_F( PacketTest, Aggregate )
+{
+    uint8_t frame[ Tick::frame_size ];
+    const size_t per_packet = aero::def::MAX_PACKET_SIZE / Tick::frame_size;
+
+    for( uint32_t tick = 0; tick < 2 * per_packet + 1; ++tick )
+        ASSERT_TRUE( packet.add( radio, frame, make_tick( frame, tick ) ) );
+
+    // Two full packets went out and one frame is waiting
+    ASSERT_EQ( radio.packets.size(), 2u );
+    ASSERT_EQ( radio.packets[ 0 ].size(), per_packet * Tick::frame_size );
+    ASSERT_EQ( packet.count(), 1u );
+
+    ASSERT_TRUE( packet.send( radio ) );
+    ASSERT_TRUE( packet.empty() );
+    ASSERT_EQ( radio.packets.size(), 3u );
+
+    // Nothing to send is not an error
+    ASSERT_TRUE( packet.send( radio ) );
+    ASSERT_EQ( radio.packets.size(), 3u );
+
+    // Every frame comes back out in order
+    std::vector< uint32_t > ticks;
+    for( const auto& p : radio.packets )
+        aero::split_packet( p.data(), p.size(), on_frame, &ticks );
+
+    ASSERT_EQ( ticks.size(), 2 * per_packet + 1 );
+    for( uint32_t tick = 0; tick < ticks.size(); ++tick )
+        ASSERT_EQ( ticks[ tick ], tick );
+}
+
+// Check a failed send keeps the packet and a full packet rejects frames
+TEST_F( PacketTest, Failures )
+{
+    uint8_t frame[ Tick::frame_size ];
+    make_tick( frame, 0 );
+
+    while( packet.fits( sizeof( frame ) ) )
+        ASSERT_TRUE( packet.add( frame, sizeof( frame ) ) );
+
+    size_t count = packet.count();
+    ASSERT_FALSE( packet.add( frame, sizeof( frame ) ) );
+    ASSERT_EQ( packet.count(), count );
+
+    radio.fail = true;
+    ASSERT_FALSE( packet.add( radio, frame, sizeof( frame ) ) );
+    ASSERT_EQ( packet.count(), count );
+
+    // Invalid frames are not added
+    frame[ 0 ] = 0;
+    aero::PacketAggregator<> other;
+    ASSERT_FALSE( other.add( aero::MessageView( frame, sizeof( frame ) ) ) );
+    ASSERT_TRUE( other.empty() );
+}
+
+// Check a damaged frame only loses that frame
+TEST_F( PacketTest, SplitDamaged )
+{
+    uint8_t frame[ Tick::frame_size ];
+
+    for( uint32_t tick = 0; tick < 3; ++tick )
+        packet.add( frame, make_tick( frame, tick ) );
+
+    std::vector< uint8_t > data( packet.data(), packet.data() + packet.size() );
+    data[ Tick::frame_size + aero::def::HEADER_SIZE + 2 ] ^= 0xFF;
+
+    std::vector< uint32_t > ticks;
+    ASSERT_EQ( aero::split_packet( data.data(), data.size(), on_frame, &ticks ), 2u );
+    ASSERT_EQ( ticks, ( std::vector< uint32_t >{ 0, 2 } ) );
+}
+
+#endif
@@ -0,0 +1,158 @@
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+// File for testing the host serial port against pseudo terminals
+#include <gtest/gtest.h>
+#include <iostream>
+#include <vector>
+#include <pty.h>
+#include "../include/PosixSerial.hpp"
+#include "../include/Schema.hpp"
+
+class PosixSerialTest : public ::testing::Test
+{
+
+protected:
+
+    using Telemetry = aero::Schema< aero::def::Status_t, aero::def::Battery_t >;
+
+    // Open a pseudo terminal. The port gets the slave end
+    int open_pty( aero::serial::PosixPort& port )
+    {
+        int master, slave;
+        if( openpty( &master, &slave, NULL, NULL, NULL ) != 0 )
+            return -1;
+
+        port.attach( slave );
+        masters.push_back( master );
+        return master;
+    }
+
+    // Build a frame whose payload holds bytes a cooked terminal would eat
+    size_t make_frame( uint8_t* buf, uint32_t state )
+    {
+        aero::def::Status_t status = { 0.0f, state };
+        aero::def::Battery_t battery = { 0.0f, 0.0f };
+        memcpy( &status.rssi, "\x0D\x03\x11\x13", 4 );
+        return Telemetry::build( buf, aero::def::ID::Plane, aero::def::ID::Gnd, status, battery );
+    }
+
+    // Records the state of every frame decoded
+    static void on_frame( const aero::MessageView& frame, void* context )
+    {
+        aero::def::Status_t status;
+        if( frame.copy( status ) )
+            static_cast< std::vector< uint32_t >* >( context )->push_back( status.state );
+    }
+
+    void TearDown( void ) override
+    {
+        for( int fd : masters )
+            close( fd );
+    }
+
+    std::vector< int > masters;
+};
+
+// Check raw bytes pass through unchanged in both directions
+TEST_F( PosixSerialTest, RawReadWrite )
+{
+    aero::serial::PosixPort port;
+    int master = open_pty( port );
+    ASSERT_GE( master, 0 );
+    ASSERT_TRUE( port.configure( 921600 ) );
+    ASSERT_FALSE( port.configure( 1234 ) );
+
+    uint8_t buf[ 64 ];
+
+    // Nothing waiting is not an error
+    ASSERT_EQ( port.read( buf, sizeof( buf ) ), 0 );
+
+    uint8_t frame[ Telemetry::frame_size ];
+    make_frame( frame, 7 );
+    ASSERT_EQ( write( master, frame, sizeof( frame ) ), (ssize_t) sizeof( frame ) );
+
+    std::vector< uint32_t > states;
+    aero::FrameDecoder decoder( on_frame, &states );
+    ASSERT_EQ( aero::serial::read( port, decoder ), 1 );
+    ASSERT_EQ( states, std::vector< uint32_t >{ 7 } );
+
+    // Two frames in one writev
+    uint8_t second[ Telemetry::frame_size ];
+    make_frame( second, 8 );
+    struct iovec iov[ 2 ] = { { frame, sizeof( frame ) }, { second, sizeof( second ) } };
+    ASSERT_EQ( port.writev( iov, 2 ), (ssize_t) ( 2 * Telemetry::frame_size ) );
+
+    uint8_t back[ 2 * Telemetry::frame_size ];
+    ASSERT_EQ( read( master, back, sizeof( back ) ), (ssize_t) sizeof( back ) );
+    ASSERT_EQ( memcmp( back, frame, sizeof( frame ) ), 0 );
+    ASSERT_EQ( memcmp( back + sizeof( frame ), second, sizeof( second ) ), 0 );
+}
+
+// Check one reader services several ports and drops ports that hang up
+TEST_F( PosixSerialTest, Reader )
+{
+    const int PORTS = 3;
+    aero::serial::PosixPort ports[ PORTS ];
+    aero::FrameDecoder decoders[ PORTS ];
+    std::vector< uint32_t > states[ PORTS ];
+    int master[ PORTS ];
+    aero::serial::PortReader reader;
+
+    for( int i = 0; i < PORTS; ++i )
+    {
+        master[ i ] = open_pty( ports[ i ] );
+        ASSERT_GE( master[ i ], 0 );
+        ASSERT_TRUE( ports[ i ].configure( 115200 ) );
+        decoders[ i ] = aero::FrameDecoder( on_frame, &states[ i ] );
+        ASSERT_TRUE( reader.add( ports[ i ], decoders[ i ] ) );
+    }
+
+    ASSERT_EQ( reader.count(), PORTS );
+    ASSERT_EQ( reader.poll( 0 ), 0 );
+
+    // Frames split across writes on every port
+    uint8_t frame[ Telemetry::frame_size ];
+    int found = 0;
+
+    for( uint32_t tick = 0; tick < 10; ++tick )
+    {
+        for( int i = 0; i < PORTS; ++i )
+        {
+            make_frame( frame, 100 * i + tick );
+            ASSERT_EQ( write( master[ i ], frame, 5 ), 5 );
+            ASSERT_EQ( write( master[ i ], frame + 5, sizeof( frame ) - 5 ), (ssize_t) sizeof( frame ) - 5 );
+        }
+
+        found += reader.poll( 100 );
+    }
+
+    // Collect anything still in flight
+    while( found < 10 * PORTS )
+    {
+        int n = reader.poll( 100 );
+        ASSERT_GT( n, 0 );
+        found += n;
+    }
+
+    for( int i = 0; i < PORTS; ++i )
+    {
+        ASSERT_EQ( states[ i ].size(), 10u );
+        for( uint32_t tick = 0; tick < 10; ++tick )
+            ASSERT_EQ( states[ i ][ tick ], 100 * i + tick );
+    }
+
+    // Hang up the first port
+    close( master[ 0 ] );
+    masters[ 0 ] = -1;
+    reader.poll( 100 );
+    ASSERT_EQ( reader.count(), PORTS - 1 );
+
+    ASSERT_TRUE( reader.remove( ports[ 1 ] ) );
+    ASSERT_FALSE( reader.remove( ports[ 1 ] ) );
+    ASSERT_EQ( reader.count(), PORTS - 2 );
+}
+
+#endif
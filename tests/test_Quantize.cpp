@@ -0,0 +1,114 @@
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+// File for testing quantized wire encoding
+#include <gtest/gtest.h>
+#include <iostream>
+#include <cmath>
+#include "../include/Quantize.hpp"
+#include "../include/Schema.hpp"
+
+// Check compact segments are smaller than the full ones
+TEST( QuantizeTest, Sizes )
+{
+    using namespace aero::def;
+
+    ASSERT_EQ( sizeof( IMUCompact_t ), sizeof( IMU_t ) / 2 );
+    ASSERT_EQ( sizeof( GPSCompact_t ), 25u );
+    ASSERT_LT( sizeof( GPSCompact_t ), sizeof( GPS_t ) );
+}
+
+// Check values round trip within half a count and saturate outside the range
+TEST( QuantizeTest, EncodeDecode )
+{
+    using namespace aero::quant;
+
+    const Scale scale = { -10.0f, 10.0f, 0.01f };
+
+    for( float value = -10.0f; value <= 10.0f; value += 0.0137f )
+        ASSERT_NEAR( decode( encode< int16_t >( value, scale ), scale ), value, 0.005f + 1e-5f );
+
+    ASSERT_EQ( encode< int16_t >( 1000.0f, scale ), 1000 );
+    ASSERT_EQ( encode< int16_t >( -1000.0f, scale ), -1000 );
+    ASSERT_EQ( encode< int16_t >( NAN, scale ), -1000 );
+
+    // Unsigned wire counts up from the minimum
+    const Scale offset = { -500.0f, 6053.5f, 0.1f };
+    ASSERT_EQ( encode< uint16_t >( -500.0f, offset ), 0 );
+    ASSERT_EQ( encode< uint16_t >( 0.0f, offset ), 5000 );
+    ASSERT_EQ( encode< uint16_t >( 1e9f, offset ), 65535 );
+    ASSERT_NEAR( decode< uint16_t >( 5123, offset ), 12.3f, 1e-3f );
+
+    ASSERT_EQ( saturate< uint8_t >( 300 ), 255 );
+    ASSERT_EQ( saturate< uint8_t >( 12 ), 12 );
+}
+
+// Check a compact IMU segment is readable as a full IMU_t
+TEST( QuantizeTest, IMU )
+{
+    using namespace aero;
+    using namespace aero::def;
+
+    IMU_t imu = { 0.981f, -0.02f, 15.9994f, 250.04f, -1999.0f, 0.0f, 45.6f, -12.3f, 30.0f, 179.99f, -45.5f, 3.14f };
+    IMUCompact_t compact;
+    quant::pack( imu, compact );
+
+    using Compact = Schema< IMUCompact_t, Status_t >;
+    uint8_t buf[ Compact::frame_size ];
+    Status_t status = { 0.0f, 0 };
+    Compact::build( buf, ID::Plane, ID::Gnd, compact, status );
+
+    IMU_t out;
+    ASSERT_TRUE( quant::read( MessageView( buf, sizeof( buf ) ), out ) );
+
+    ASSERT_NEAR( out.ax, imu.ax, 0.0005f );
+    ASSERT_NEAR( out.az, imu.az, 0.0005f );
+    ASSERT_NEAR( out.gx, imu.gx, 0.05f );
+    ASSERT_NEAR( out.gy, imu.gy, 0.05f );
+    ASSERT_NEAR( out.mx, imu.mx, 0.05f );
+    ASSERT_NEAR( out.yaw, imu.yaw, 0.005f );
+    ASSERT_NEAR( out.roll, imu.roll, 0.005f );
+
+    // Full segment is read as is
+    using Full = Schema< IMU_t >;
+    uint8_t full[ Full::frame_size ];
+    Full::build( full, ID::Plane, ID::Gnd, imu );
+    ASSERT_TRUE( quant::read( MessageView( full, sizeof( full ) ), out ) );
+    ASSERT_EQ( out.ay, imu.ay );
+
+    // Neither segment
+    ASSERT_FALSE( quant::read( MessageView( buf, 0 ), out ) );
+}
+
+// Check GPS data survives the compact encoding
+TEST( QuantizeTest, GPS )
+{
+    using namespace aero;
+    using namespace aero::def;
+
+    GPS_t gps = { true, 43.0096f, -81.2737f, 23.45f, 11, 251.3f, 12345600, 170619, 95, 1 };
+    GPSCompact_t compact;
+    quant::pack( gps, compact );
+
+    using Compact = Schema< GPSCompact_t >;
+    uint8_t buf[ Compact::frame_size ];
+    Compact::build( buf, ID::Plane, ID::Gnd, compact );
+
+    GPS_t out;
+    ASSERT_TRUE( quant::read( MessageView( buf, sizeof( buf ) ), out ) );
+
+    ASSERT_EQ( out.fix, gps.fix );
+    ASSERT_NEAR( out.lat, gps.lat, 1e-5f );
+    ASSERT_NEAR( out.lon, gps.lon, 1e-5f );
+    ASSERT_NEAR( out.speed, gps.speed, 0.005f );
+    ASSERT_NEAR( out.altitude, gps.altitude, 0.05f );
+    ASSERT_EQ( out.satellites, gps.satellites );
+    ASSERT_EQ( out.time, gps.time );
+    ASSERT_EQ( out.date, gps.date );
+    ASSERT_EQ( out.HDOP, gps.HDOP );
+    ASSERT_EQ( out.quality, gps.quality );
+}
+
+#endif
@@ -0,0 +1,224 @@
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+// File for testing compile time field reflection
+#include <gtest/gtest.h>
+#include <iostream>
+#include <string>
+#include "../include/Reflect.hpp"
+#include "../include/Quantize.hpp"
+
+// Check names, offsets and types match the structs
+TEST( ReflectTest, Fields )
+{
+    using namespace aero;
+    using namespace aero::def;
+
+    ASSERT_EQ( reflect::count< IMU_t >(), 12u );
+    ASSERT_EQ( reflect::count< GPS_t >(), 10u );
+    ASSERT_EQ( reflect::count< SystemConfig_t >(), 0u );
+    ASSERT_STREQ( reflect::Describe< GPS_t >::name(), "GPS" );
+
+    // Every field of a plain struct is accounted for with no gaps
+    size_t bytes = 0;
+    reflect::for_each< IMU_t >( [ & ]( const auto& field )
+    {
+        ASSERT_EQ( field.offset, bytes );
+        bytes += reflect::width( field.type );
+    } );
+    ASSERT_EQ( bytes, sizeof( IMU_t ) );
+
+    std::string names;
+    reflect::for_each< DropAlgo_t >( [ & ]( const auto& field ) { names += field.name; names += ' '; } );
+    ASSERT_EQ( names, "heading distance " );
+
+    // Members are reached through the description
+    GPS_t gps = {};
+    reflect::visit( gps, []( const auto& field, auto& value )
+    {
+        if( field.type == reflect::Type::U32 )
+            value = 7;
+    } );
+    ASSERT_EQ( gps.satellites, 7u );
+    ASSERT_EQ( gps.quality, 7u );
+    ASSERT_EQ( gps.lat, 0.0f );
+}
+
+// Swapping twice gives back the original bytes
+TEST( ReflectTest, Swap )
+{
+    using namespace aero;
+    using namespace aero::def;
+
+    Commands_t cmd = { 0x12, 0x3456, 0x78 };
+    reflect::swap( cmd );
+    ASSERT_EQ( cmd.drop, 0x12 );
+    ASSERT_EQ( cmd.servos, 0x5634 );
+    ASSERT_EQ( cmd.pitch, 0x78 );
+
+    GPS_t gps = { true, 43.0f, -81.2f, 12.5f, 9, 250.0f, 123456, 10121, 95, 1 };
+    GPS_t copy = gps;
+    reflect::swap( copy );
+    ASSERT_EQ( copy.satellites, 0x09000000u );
+    reflect::swap( copy );
+    ASSERT_EQ( memcmp( &gps, &copy, sizeof( gps ) ), 0 );
+
+    reflect::to_little_endian( copy );
+    ASSERT_EQ( memcmp( &gps, &copy, sizeof( gps ) ), 0 );
+}
+
+// Swapping arrays of structs matches swapping them one at a time
+TEST( ReflectTest, SwapArray )
+{
+    using namespace aero;
+    using namespace aero::def;
+
+    // Padded, mixed width and packed structs, with a leftover after the runs
+    GPS_t gps[ 11 ], gps_one[ 11 ];
+    Commands_t cmds[ 21 ], cmds_one[ 21 ];
+    GPSCompact_t compact[ 5 ], compact_one[ 5 ];
+
+    for( size_t i = 0; i < 21; ++i )
+    {
+        cmds[ i ] = { static_cast< uint8_t >( i ), static_cast< uint16_t >( 0x0102 * i ), 7 };
+        if( i < 11 )
+            gps[ i ] = { i % 2 == 0, 43.0f + i, -81.0f, 1.5f * i, static_cast< uint32_t >( i ), 250.0f, 0x01020304u, 10121, 95, 1 };
+        if( i < 5 )
+            memset( &compact[ i ], static_cast< int >( i * 17 + 1 ), sizeof( compact[ i ] ) );
+    }
+
+    memcpy( gps_one, gps, sizeof( gps ) );
+    memcpy( cmds_one, cmds, sizeof( cmds ) );
+    memcpy( compact_one, compact, sizeof( compact ) );
+
+    reflect::swap( gps, 11 );
+    reflect::swap( cmds, 21 );
+    reflect::swap( compact, 5 );
+
+    for( size_t i = 0; i < 21; ++i )
+    {
+        reflect::swap( cmds_one[ i ] );
+        if( i < 11 )
+            reflect::swap( gps_one[ i ] );
+        if( i < 5 )
+            reflect::swap( compact_one[ i ] );
+    }
+
+    ASSERT_EQ( memcmp( gps, gps_one, sizeof( gps ) ), 0 );
+    ASSERT_EQ( memcmp( cmds, cmds_one, sizeof( cmds ) ), 0 );
+    ASSERT_EQ( memcmp( compact, compact_one, sizeof( compact ) ), 0 );
+    ASSERT_EQ( gps[ 3 ].time, 0x04030201u );
+
+    ASSERT_TRUE( reflect::detail::Patterns< GPS_t >::pattern.blocked );
+    ASSERT_FALSE( reflect::detail::Patterns< GPSCompact_t >::pattern.blocked );
+}
+
+// Packed structs are visited through copies, build with AERO_SANITIZE=ON to
+// have UBSan check no member is reached through a misaligned reference
+TEST( ReflectTest, Packed )
+{
+    using namespace aero;
+    using namespace aero::def;
+
+    // Every other struct of the array starts at an odd address
+    GPSCompact_t compact[ 2 ];
+    GPS_t gps = { true, 43.5f, -81.25f, 12.5f, 9, 250.0f, 123456, 10121, 95, 1 };
+    quant::pack( gps, compact[ 0 ] );
+    quant::pack( gps, compact[ 1 ] );
+
+    uint32_t sum = 0;
+    reflect::visit( compact[ 1 ], [ & ]( const auto& field, auto& value )
+    {
+        if( field.type == reflect::Type::U32 )
+        {
+            sum += value;
+            value = 7;
+        }
+    } );
+    ASSERT_EQ( sum, 123456u + 10121u );
+    ASSERT_EQ( compact[ 1 ].time, 7u );
+    ASSERT_EQ( compact[ 1 ].date, 7u );
+
+    char buf[ 128 ];
+    reflect::csv_row( compact[ 1 ], buf, sizeof( buf ) );
+    ASSERT_EQ( std::string( buf ), "1,435000000," + std::to_string( compact[ 0 ].lon ) + ",1250,9,7500,7,7,95,1" );
+
+    reflect::swap( compact[ 1 ] );
+    ASSERT_EQ( compact[ 1 ].time, 0x07000000u );
+    reflect::swap( compact, 2 );
+    ASSERT_EQ( compact[ 0 ].date, 0x89270000u );
+    ASSERT_EQ( compact[ 1 ].time, 7u );
+}
+
+// Check the text writers and their snprintf style lengths
+TEST( ReflectTest, Text )
+{
+    using namespace aero;
+    using namespace aero::def;
+
+    char buf[ 128 ];
+    Radio_t radio = { -42.5f, -1200, 7 };
+
+    ASSERT_EQ( reflect::csv_header< Radio_t >( buf, sizeof( buf ) ), strlen( "rssi,frequencyError,snr" ) );
+    ASSERT_STREQ( buf, "rssi,frequencyError,snr" );
+
+    reflect::csv_row( radio, buf, sizeof( buf ) );
+    ASSERT_STREQ( buf, "-42.5,-1200,7" );
+
+    GPS_t gps = { true, 43.5f, -81.25f, 0.0f, 9, 250.0f, 123456, 10121, 95, 1 };
+    reflect::json( gps, buf, sizeof( buf ) );
+    ASSERT_STREQ( buf, "{\"fix\":true,\"lat\":43.5,\"lon\":-81.25,\"speed\":0,\"satellites\":9,\"altitude\":250,"
+                       "\"time\":123456,\"date\":10121,\"HDOP\":95,\"quality\":1}" );
+
+    DropAlgo_t drop = { -32768, 65535 };
+    reflect::pretty( drop, buf, sizeof( buf ) );
+    ASSERT_STREQ( buf, "DropAlgo\n  heading: -32768\n  distance: 65535\n" );
+
+    // Truncated output is terminated and reports the full length
+    char small[ 8 ];
+    ASSERT_EQ( reflect::csv_row( radio, small, sizeof( small ) ), 13u );
+    ASSERT_STREQ( small, "-42.5,-" );
+    ASSERT_EQ( reflect::csv_row( radio, small, 0 ), 13u );
+}
+
+// The generic pack matches the per field conversions it replaced
+TEST( ReflectTest, Pack )
+{
+    using namespace aero;
+    using namespace aero::def;
+
+    GPS_t gps = { true, 43.0096f, -81.2737f, 700.0f, 300, 251.3f, 123456, 10121, 70000, 4 };
+    GPSCompact_t compact;
+    quant::pack( gps, compact );
+
+    ASSERT_EQ( compact.fix, 1 );
+    ASSERT_EQ( compact.lat, quant::encode< int32_t >( gps.lat, quant::gps::lat ) );
+    ASSERT_EQ( compact.lon, quant::encode< int32_t >( gps.lon, quant::gps::lon ) );
+    ASSERT_EQ( compact.speed, 65535 );
+    ASSERT_EQ( compact.satellites, 255 );
+    ASSERT_EQ( compact.altitude, quant::encode< uint16_t >( gps.altitude, quant::gps::altitude ) );
+    ASSERT_EQ( compact.time, 123456u );
+    ASSERT_EQ( compact.date, 10121u );
+    ASSERT_EQ( compact.HDOP, 65535 );
+    ASSERT_EQ( compact.quality, 4 );
+
+    compact.fix = 2;
+    GPS_t out;
+    quant::unpack( compact, out );
+    ASSERT_TRUE( out.fix );
+    ASSERT_NEAR( out.lat, gps.lat, 1e-5f );
+    ASSERT_EQ( out.satellites, 255u );
+    ASSERT_EQ( out.time, gps.time );
+
+    IMU_t imu = { 0.981f, -0.02f, 20.0f, 250.04f, -1999.0f, 0.0f, 45.6f, -12.3f, 30.0f, 179.99f, -45.5f, 3.14f };
+    IMUCompact_t wire;
+    quant::pack( imu, wire );
+    ASSERT_EQ( wire.ax, 981 );
+    ASSERT_EQ( wire.az, 16000 );
+    ASSERT_EQ( wire.gx, 2500 );
+    ASSERT_EQ( wire.roll, 314 );
+}
+
+#endif
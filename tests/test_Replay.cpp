@@ -0,0 +1,132 @@
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+// File for testing capture replay
+#include <gtest/gtest.h>
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+#include "../include/Replay.hpp"
+#include "../include/Schema.hpp"
+
+class ReplayTest : public ::testing::Test
+{
+
+protected:
+
+    using AirData = aero::Schema< aero::def::Pitot_t, aero::def::Enviro_t, aero::def::IMU_t, aero::def::Status_t >;
+
+    // Write a capture of frames spaced by step_us
+    void SetUp( void ) override
+    {
+        char name[] = "/tmp/aero_replay_XXXXXX";
+        close( mkstemp( name ) );
+        path = name;
+    }
+
+    void TearDown( void ) override
+    {
+        unlink( path.c_str() );
+    }
+
+    void capture( uint32_t count, uint64_t step_us )
+    {
+        aero::LogWriter writer( 1 << 20 );
+        ASSERT_TRUE( writer.open( path.c_str() ) );
+
+        uint8_t buf[ AirData::frame_size ];
+        aero::def::Pitot_t pitot = { 450.0f };
+        aero::def::Enviro_t enviro = { 0.0f, 15.0f, 98000.0f };
+        aero::def::IMU_t imu = {};
+
+        for( uint32_t i = 0; i < count; ++i )
+        {
+            aero::def::Status_t status = { 0.0f, i };
+            AirData::build( buf, aero::def::ID::Plane, aero::def::ID::Gnd, pitot, enviro, imu, status );
+            ASSERT_TRUE( writer.append( aero::MessageView( buf, sizeof( buf ) ), step_us * i ) );
+        }
+
+        ASSERT_TRUE( writer.close() );
+        ASSERT_TRUE( log.open( path.c_str() ) );
+    }
+
+    std::string path;
+    aero::LogReader log;
+};
+
+// Check a clean replay recovers every frame and times every stage
+TEST_F( ReplayTest, Clean )
+{
+    capture( 2000, 1000 );
+
+    aero::replay::Options options;
+    aero::replay::Report report;
+    aero::replay::Engine engine( options );
+
+    ASSERT_TRUE( engine.run( log, report ) );
+    ASSERT_EQ( report.records, 2000u );
+    ASSERT_EQ( report.frames, 2000u );
+    ASSERT_EQ( report.bytes, 2000u * AirData::frame_size );
+    ASSERT_EQ( report.dropped, 0u );
+    ASSERT_EQ( report.parse.count(), 2000u );
+    ASSERT_EQ( report.convert.count(), 2000u );
+    ASSERT_EQ( report.decode.count(), 2000u );
+    ASSERT_GT( report.frame_rate(), 0.0 );
+    ASSERT_LE( report.parse.percentile( 50 ), report.parse.percentile( 100 ) );
+    ASSERT_TRUE( std::isfinite( engine.sink() ) );
+
+    // A report carried over from another run doesn't count as a match
+    options.from_us = 10000000;
+    ASSERT_FALSE( aero::replay::Engine( options ).run( log, report ) );
+    ASSERT_EQ( report.records, 2000u );
+}
+
+// Check injected errors lose frames the same way for the same seed
+TEST_F( ReplayTest, Injection )
+{
+    capture( 2000, 1000 );
+
+    aero::replay::Options options;
+    options.bit_error_rate = 1e-4;
+    options.drop_rate = 1e-4;
+    options.seed = 42;
+
+    aero::replay::Report first, second;
+    aero::replay::Engine( options ).run( log, first );
+    aero::replay::Engine( options ).run( log, second );
+
+    ASSERT_GT( first.bit_errors, 0u );
+    ASSERT_GT( first.lost_bytes, 0u );
+    ASSERT_LT( first.frames, 2000u );
+    ASSERT_GT( first.frames, 1500u );
+    ASSERT_EQ( first.frames, second.frames );
+    ASSERT_EQ( first.bit_errors, second.bit_errors );
+
+    // Everything is dropped
+    options.drop_rate = 1.0;
+    aero::replay::Report none;
+    aero::replay::Engine( options ).run( log, none );
+    ASSERT_EQ( none.frames, 0u );
+    ASSERT_EQ( none.bytes, 0u );
+}
+
+// Check throttled replay follows the capture clock
+TEST_F( ReplayTest, Speed )
+{
+    capture( 21, 10000 );
+
+    aero::replay::Options options;
+    options.speed = 4.0;
+
+    aero::replay::Report report;
+    aero::replay::Engine( options ).run( log, report );
+
+    // 200 ms of capture at 4x
+    ASSERT_EQ( report.frames, 21u );
+    ASSERT_GE( report.seconds, 0.05 );
+    ASSERT_LT( report.seconds, 0.5 );
+}
+
+#endif
@@ -0,0 +1,144 @@
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+// File for testing the single producer, single consumer ring
+#include <gtest/gtest.h>
+#include <iostream>
+#include <thread>
+#include "../include/Ring.hpp"
+
+// Check single element push and pop including full and empty
+TEST( RingTest, PushPop )
+{
+    aero::Ring< int, 4 > ring;
+    int value = 0;
+
+    ASSERT_TRUE( ring.empty() );
+    ASSERT_FALSE( ring.pop( value ) );
+
+    for( int i = 0; i < 4; ++i )
+        ASSERT_TRUE( ring.push( i ) );
+
+    ASSERT_TRUE( ring.full() );
+    ASSERT_FALSE( ring.push( 4 ) );
+
+    // Wrap around several times
+    for( int i = 0; i < 20; ++i )
+    {
+        ASSERT_TRUE( ring.pop( value ) );
+        ASSERT_EQ( value, i );
+        ASSERT_TRUE( ring.push( i + 4 ) );
+        ASSERT_EQ( ring.size(), 4u );
+    }
+}
+
+// Check bulk copies and spans split at the end of storage
+TEST( RingTest, Bulk )
+{
+    aero::Ring< uint8_t, 8 > ring;
+    uint8_t in[ 16 ], out[ 16 ];
+
+    for( uint8_t i = 0; i < sizeof( in ); ++i )
+        in[ i ] = i;
+
+    ASSERT_EQ( ring.push_n( in, 6 ), 6u );
+    ASSERT_EQ( ring.pop_n( out, 4 ), 4u );
+
+    // Only 6 slots are free and they wrap
+    ASSERT_EQ( ring.push_n( in + 6, 10 ), 6u );
+    ASSERT_TRUE( ring.full() );
+
+    aero::Ring< uint8_t, 8 >::Span span = ring.read_span();
+    ASSERT_EQ( span.size, 4u );
+    ASSERT_EQ( span.data[ 0 ], 4 );
+    ring.consume( span.size );
+
+    ASSERT_EQ( ring.pop_n( out, sizeof( out ) ), 4u );
+    for( uint8_t i = 0; i < 4; ++i )
+        ASSERT_EQ( out[ i ], 8 + i );
+
+    ASSERT_TRUE( ring.empty() );
+    ASSERT_EQ( ring.read_span().size, 0u );
+
+    // Writing through a span
+    span = ring.write_span();
+    ASSERT_EQ( span.size, 4u );
+    span.data[ 0 ] = 42;
+    ring.commit( 1 );
+    ASSERT_EQ( ring.pop_n( out, 1 ), 1u );
+    ASSERT_EQ( out[ 0 ], 42 );
+}
+
+// Check a narrow index type wraps correctly
+TEST( RingTest, ByteIndex )
+{
+    aero::Ring< uint16_t, 128, uint8_t > ring;
+    uint16_t value;
+
+    for( uint16_t i = 0; i < 1000; ++i )
+    {
+        ASSERT_TRUE( ring.push( i ) );
+        if( i >= 100 )
+        {
+            ASSERT_TRUE( ring.pop( value ) );
+            ASSERT_EQ( value, i - 100 );
+        }
+    }
+
+    ASSERT_EQ( ring.size(), 100u );
+}
+
+// Check nothing is lost or reordered between two threads
+TEST( RingTest, Threads )
+{
+    static aero::Ring< uint32_t, 64 > ring;
+    const uint32_t total = 200000;
+
+    std::thread producer( [ & ]( )
+    {
+        uint32_t next = 0, batch[ 7 ];
+
+        while( next < total )
+        {
+            // Mix single and bulk pushes
+            if( next % 3 == 0 )
+            {
+                if( ring.push( next ) )
+                    ++next;
+                else
+                    std::this_thread::yield();
+                continue;
+            }
+
+            size_t count = 0;
+            for( ; count < 7 && next + count < total; ++count )
+                batch[ count ] = next + count;
+
+            size_t pushed = ring.push_n( batch, count );
+            if( pushed == 0 )
+                std::this_thread::yield();
+            next += pushed;
+        }
+    } );
+
+    uint32_t expected = 0, batch[ 5 ];
+    bool ordered = true;
+
+    while( expected < total )
+    {
+        size_t count = ring.pop_n( batch, 5 );
+        if( count == 0 )
+            std::this_thread::yield();
+
+        for( size_t i = 0; i < count; ++i )
+            ordered &= batch[ i ] == expected++;
+    }
+
+    producer.join();
+    ASSERT_TRUE( ordered );
+    ASSERT_TRUE( ring.empty() );
+}
+
+#endif
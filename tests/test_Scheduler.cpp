@@ -0,0 +1,191 @@
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+// File for testing the task scheduler on a virtual clock
+#include <gtest/gtest.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../include/Scheduler.hpp"
+
+namespace
+{
+    using aero::sched::VirtualClock;
+
+    // Task that takes a fixed time on the virtual clock and logs its runs
+    struct Work
+    {
+        VirtualClock* clock;
+        uint32_t cost;
+        char id;
+        std::string* log;
+        bool ok;
+
+        static bool run( void* context )
+        {
+            Work* work = static_cast< Work* >( context );
+            *work->log += work->id;
+            work->clock->advance( work->cost );
+            return work->ok;
+        }
+    };
+
+    // GPS whose update takes a long time
+    class SlowGps : public aero::sensor::GPS
+    {
+    public:
+        SlowGps( VirtualClock& clock, uint16_t poll_time_ms ) : m_clock( clock ), updates( 0 )
+        {
+            m_config.poll_time_ms = poll_time_ms;
+        }
+
+        bool init( void ) override { return true; }
+
+        bool update( void ) override
+        {
+            m_clock.advance( 12000 );
+            ++updates;
+            return true;
+        }
+
+        VirtualClock& m_clock;
+        int updates;
+    };
+
+    class FastImu : public aero::sensor::IMU
+    {
+    public:
+        explicit FastImu( VirtualClock& clock ) : m_clock( clock ), updates( 0 ) {}
+
+        bool init( void ) override { return true; }
+
+        bool update( void ) override
+        {
+            m_clock.advance( 300 );
+            ++updates;
+            return true;
+        }
+
+        VirtualClock& m_clock;
+        int updates;
+    };
+}
+
+// Shorter periods run first regardless of the order they were added in
+TEST( SchedulerTest, RateMonotonic )
+{
+    using namespace aero::sched;
+
+    VirtualClock clock;
+    Scheduler< 3, VirtualClock > tasks( clock );
+    std::string log;
+    Work slow = { &clock, 100, 's', &log, true };
+    Work fast = { &clock, 100, 'f', &log, true };
+    Work mid = { &clock, 100, 'm', &log, false };
+
+    ASSERT_TRUE( tasks.add( Work::run, &slow, 10000, "slow" ) );
+    ASSERT_TRUE( tasks.add( Work::run, &fast, 1000, "fast" ) );
+    ASSERT_TRUE( tasks.add( Work::run, &mid, 5000, "mid" ) );
+    ASSERT_FALSE( tasks.add( Work::run, &mid, 5000, "full" ) );
+    ASSERT_STREQ( tasks.task( 0 ).name, "fast" );
+    ASSERT_STREQ( tasks.task( 2 ).name, "slow" );
+
+    // Everything is released at the start
+    ASSERT_EQ( tasks.tick(), 3u );
+    ASSERT_EQ( log, "fms" );
+    ASSERT_EQ( tasks.idle(), 700u );
+
+    // Nothing runs before the next release
+    ASSERT_EQ( tasks.tick(), 0u );
+    clock.set( 1000 );
+    ASSERT_EQ( tasks.tick(), 1u );
+
+    for( uint32_t t = 1000; t <= 10000; t += 100 )
+    {
+        clock.set( t > clock.now() ? t : clock.now() );
+        tasks.tick();
+    }
+
+    ASSERT_EQ( log, "fmsfffffmfffffms" );
+    ASSERT_EQ( tasks.task( 0 ).stats.runs, 11u );
+    ASSERT_EQ( tasks.task( 1 ).stats.failures, 3u );
+    ASSERT_EQ( tasks.task( 0 ).stats.misses, 0u );
+
+    // At 10000 all three were released, slow went last and started 200 us late
+    ASSERT_EQ( tasks.task( 2 ).stats.jitter_last, 200u );
+    ASSERT_EQ( tasks.task( 2 ).stats.exec_mean(), 100u );
+}
+
+// A slow GPS read delays the IMU and the stats show by how much
+TEST( SchedulerTest, Overruns )
+{
+    using namespace aero;
+
+    sched::VirtualClock clock( 4294900000u );  // Wraps during the test
+    sched::Scheduler< 2, sched::VirtualClock > tasks( clock );
+    SlowGps gps( clock, 100 );
+    FastImu imu( clock );
+
+    ASSERT_TRUE( tasks.add( gps ) );
+    ASSERT_TRUE( tasks.add( imu, 5000, "imu", 2000 ) );
+    ASSERT_EQ( tasks.task( 1 ).period, 100000u );
+
+    // One second ticking every 100 us
+    const uint32_t start = clock.now();
+    while( clock.now() - start < 1000000 )
+    {
+        tasks.tick();
+        uint32_t next = clock.now() + 100;
+        clock.set( next - ( next - start ) % 100 );
+    }
+
+    const sched::Stats& imu_stats = tasks.task( 0 ).stats;
+    const sched::Stats& gps_stats = tasks.task( 1 ).stats;
+
+    ASSERT_EQ( gps.updates, 10 );
+    ASSERT_EQ( gps_stats.exec_max, 12000u );
+    ASSERT_EQ( gps_stats.misses, 0u );
+
+    // Each GPS read holds the IMU back from 300 us to the first tick after
+    // 12300 us, past two releases and its deadline. One run covers both
+    ASSERT_EQ( imu_stats.misses, 10u );
+    ASSERT_EQ( imu_stats.skipped, 10u );
+    ASSERT_EQ( imu_stats.jitter_max, 7400u );
+    ASSERT_EQ( imu.updates, 200 - 10 );
+    ASSERT_EQ( imu_stats.runs, static_cast< uint32_t >( imu.updates ) );
+
+    char buf[ 512 ];
+    print::Formatter out( buf, sizeof( buf ) );
+    tasks.report( out );
+    ASSERT_NE( std::string( out.c_str() ).find( "       imu     5000      190     300     300    7400     10     10      0" ),
+               std::string::npos ) << out.c_str();
+
+    tasks.reset_stats();
+    ASSERT_EQ( tasks.task( 0 ).stats.runs, 0u );
+}
+
+// Over 100% load still gives every task one run per tick and returns
+TEST( SchedulerTest, Overload )
+{
+    using namespace aero;
+
+    sched::VirtualClock clock;
+    sched::Scheduler< 2, sched::VirtualClock > tasks( clock );
+    std::string log;
+    Work a = { &clock, 600, 'a', &log, true };
+    Work b = { &clock, 600, 'b', &log, true };
+
+    ASSERT_TRUE( tasks.add( Work::run, &a, 1000, "a" ) );
+    ASSERT_TRUE( tasks.add( Work::run, &b, 1000, "b" ) );
+
+    for( int i = 0; i < 5; ++i )
+        ASSERT_EQ( tasks.tick(), 2u );
+
+    ASSERT_EQ( log, "ababababab" );
+    ASSERT_EQ( clock.now(), 6000u );
+    ASSERT_GT( tasks.task( 1 ).stats.misses, 0u );
+}
+
+#endif
@@ -0,0 +1,81 @@
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+// File for testing compile time message schemas
+#include <gtest/gtest.h>
+#include <iostream>
+#include "../include/Schema.hpp"
+
+// Check constants are computed at compile time and match the runtime layout
+TEST( SchemaTest, Constants )
+{
+    using namespace aero;
+    using namespace aero::def;
+
+    // Listed out of order on purpose, offsets follow signature bit order
+    using Telemetry = Schema< Commands_t, IMU_t, Battery_t, Enviro_t >;
+
+    static_assert( Telemetry::signature == ( ( 1 << 1 ) | ( 1 << 3 ) | ( 1 << 4 ) | ( 1 << 9 ) ), "Bad signature" );
+    static_assert( Telemetry::length == sizeof( IMU_t ) + sizeof( Enviro_t ) + sizeof( Battery_t ) + sizeof( Commands_t ), "Bad length" );
+    static_assert( Telemetry::offset< IMU_t >() == 0, "Bad offset" );
+    static_assert( Telemetry::offset< Commands_t >() == Telemetry::length - sizeof( Commands_t ), "Bad offset" );
+
+    ASSERT_EQ( Telemetry::frame_size, HEADER_SIZE + Telemetry::length + footer_size( INTEGRITY ) );
+    ASSERT_EQ( Telemetry::offset< Enviro_t >(), segment_offset( Telemetry::signature, Signature::Enviro ) );
+    ASSERT_EQ( Telemetry::offset< Battery_t >(), segment_offset( Telemetry::signature, Signature::Battery ) );
+    ASSERT_EQ( Telemetry::length, payload_size( Telemetry::signature ) );
+}
+
+// Check a schema frame round trips and is readable by MessageView
+TEST( SchemaTest, BuildParse )
+{
+    using namespace aero;
+    using namespace aero::def;
+    using Telemetry = Schema< IMU_t, GPS_t, Status_t >;
+
+    IMU_t imu = {};
+    imu.ax = 1.5f; imu.gz = -3.25f; imu.roll = 90.0f;
+
+    GPS_t gps = {};
+    gps.fix = true; gps.lat = 43.0f; gps.lon = -81.25f; gps.satellites = 9;
+
+    Status_t status = { -42.0f, 0x05 };
+
+    uint8_t buf[ Telemetry::frame_size ];
+    ASSERT_EQ( Telemetry::build( buf, ID::Plane, ID::Gnd, imu, gps, status ), Telemetry::frame_size );
+
+    // Runtime view agrees with the compile time layout
+    MessageView view( buf, sizeof( buf ) );
+    ASSERT_TRUE( view.valid() );
+    ASSERT_EQ( view.from(), ID::Plane );
+    ASSERT_EQ( view.to(), ID::Gnd );
+    GPS_t gps_view = {};
+    Status_t status_view = {};
+    ASSERT_TRUE( view.copy( gps_view ) && view.copy( status_view ) );
+    ASSERT_EQ( gps_view.lon, gps.lon );
+    ASSERT_EQ( status_view.state, status.state );
+
+    IMU_t imu_out = {};
+    GPS_t gps_out = {};
+    Status_t status_out = {};
+    ASSERT_TRUE( Telemetry::parse( buf, sizeof( buf ), imu_out, gps_out, status_out ) );
+
+    ASSERT_EQ( imu_out.ax, imu.ax );
+    ASSERT_EQ( imu_out.gz, imu.gz );
+    ASSERT_EQ( imu_out.roll, imu.roll );
+    ASSERT_EQ( gps_out.fix, gps.fix );
+    ASSERT_EQ( gps_out.lat, gps.lat );
+    ASSERT_EQ( gps_out.satellites, gps.satellites );
+    ASSERT_EQ( status_out.rssi, status.rssi );
+
+    // A frame from another schema is rejected
+    ASSERT_FALSE( ( Schema< IMU_t, GPS_t >::check( buf, sizeof( buf ) ) ) );
+
+    // A corrupted frame is rejected
+    buf[ def::HEADER_SIZE + 3 ] ^= 0x10;
+    ASSERT_FALSE( Telemetry::parse( buf, sizeof( buf ), imu_out, gps_out, status_out ) );
+}
+
+#endif
@@ -0,0 +1,126 @@
+#if defined(ARDUINO) || defined(CORE_TEENSY)
+    // This if defined is added so Arduino does not compile this code
+    // when this library is added as a submodule
+#else
+
+// File for testing lock free sensor snapshots
+#include <gtest/gtest.h>
+#include <iostream>
+#include <atomic>
+#include <thread>
+#include "../include/Snapshot.hpp"
+#include "../include/Sensors.hpp"
+
+namespace
+{
+    // IMU whose every reading is one value, so a torn copy shows up
+    class CountingImu : public aero::sensor::IMU
+    {
+    public:
+        CountingImu( ) : count( 0 ) {}
+
+        using aero::sensor::IMU::init;
+        bool init( void ) override { return true; }
+
+        bool update( void ) override
+        {
+            float value = static_cast< float >( ++count );
+            float* fields = &m_data.ax;
+            for( size_t i = 0; i < sizeof( m_data ) / sizeof( float ); ++i )
+                fields[ i ] = value;
+
+            publish( count * 10 );
+            return true;
+        }
+
+        uint32_t count;
+    };
+}
+
+// Check sequence numbers, times and the newer only read
+TEST( SnapshotTest, Publish )
+{
+    aero::Snapshot< int > snapshot;
+
+    aero::Sample< int > held = snapshot.read();
+    ASSERT_EQ( held.sequence, 0u );
+    ASSERT_EQ( held.data, 0 );
+    ASSERT_FALSE( snapshot.read_newer( held ) );
+
+    snapshot.publish( 7, 1000 );
+    ASSERT_EQ( snapshot.sequence(), 1u );
+    ASSERT_TRUE( snapshot.read_newer( held ) );
+    ASSERT_EQ( held.data, 7 );
+    ASSERT_EQ( held.time_us, 1000u );
+    ASSERT_FALSE( snapshot.read_newer( held ) );
+
+    // Stamped with the clock when no time is given
+    uint32_t before = aero::now_us();
+    snapshot.publish( 8 );
+    aero::Sample< int > latest = snapshot.read();
+    ASSERT_EQ( latest.data, 8 );
+    ASSERT_EQ( latest.sequence, 2u );
+    ASSERT_LE( latest.time_us - before, 1000000u );
+
+    // A one byte version wraps without losing the sequence
+    aero::Snapshot< int, uint8_t > small;
+    for( int i = 1; i <= 300; ++i )
+        small.publish( i, 0 );
+    ASSERT_EQ( small.read().data, 300 );
+    ASSERT_EQ( small.sequence(), 300u );
+}
+
+// Readers on other threads never see a half written sample
+TEST( SnapshotTest, Threads )
+{
+    CountingImu imu;
+    const uint32_t UPDATES = 200000;
+
+    ASSERT_TRUE( imu.init( aero::sensor::IMU::Config_t() ) );
+
+    std::atomic< uint32_t > started( 0 ), torn( 0 ), backwards( 0 ), reads( 0 );
+    auto reader = [ & ]( )
+    {
+        aero::Sample< aero::def::IMU_t > held = imu.sample();
+        ++started;
+
+        while( held.sequence < UPDATES )
+        {
+            uint32_t last = held.sequence;
+            if( !imu.sample( held ) )
+                continue;
+
+            ++reads;
+            if( held.sequence < last )
+                ++backwards;
+
+            const float* fields = &held.data.ax;
+            for( size_t i = 0; i < sizeof( held.data ) / sizeof( float ); ++i )
+                if( fields[ i ] != static_cast< float >( held.sequence ) )
+                    ++torn;
+            if( held.time_us != held.sequence * 10 )
+                ++torn;
+        }
+    };
+
+    std::thread first( reader ), second( reader );
+    std::thread writer( [ & ]( )
+    {
+        while( started < 2 )
+            std::this_thread::yield();
+        for( uint32_t i = 0; i < UPDATES; ++i )
+            imu.update();
+    } );
+
+    writer.join();
+    first.join();
+    second.join();
+
+    ASSERT_EQ( torn, 0u );
+    ASSERT_EQ( backwards, 0u );
+    ASSERT_GE( reads, 2u );
+    ASSERT_EQ( imu.sample().sequence, UPDATES );
+    ASSERT_EQ( imu.sample().data.yaw, static_cast< float >( UPDATES ) );
+}
+
+#endif
@@ -8,6 +8,7 @@
 #include <iostream>
 #include <cmath>
 #include "../include/Utility.hpp"
+#include "../include/Simd.hpp"
 
 // Test swap endian function in aero library
 TEST( UtilityTest, BitSwapEndian )
@@ -31,7 +32,68 @@ TEST( UtilityTest, BitSwapEndian )
     ASSERT_EQ( bit::swap_endian<int8_t>( si_byte ), si_byte );
     ASSERT_EQ( bit::swap_endian<int16_t>( si_word ), si_word_swapped );
     ASSERT_EQ( bit::swap_endian<int32_t>( si_long ), si_long_swapped );
-    
+
+    // Wider and odd sized values
+    ASSERT_EQ( bit::swap_endian<uint64_t>( 0x0102030405060708ULL ), 0x0807060504030201ULL );
+    ASSERT_EQ( bit::swap_endian( bit::swap_endian( 3.25f ) ), 3.25f );
+
+    struct Three { uint8_t b[ 3 ]; } three = { { 1, 2, 3 } };
+    three = bit::swap_endian( three );
+    ASSERT_EQ( three.b[ 0 ], 3 );
+    ASSERT_EQ( three.b[ 2 ], 1 );
+}
+
+// Test wire order conversions and swapping whole arrays
+TEST( UtilityTest, BitSwapArray )
+{
+    using namespace aero;
+
+    uint16_t word = 0x1234;
+    uint8_t bytes[ 2 ];
+    memcpy( bytes, &word, sizeof( word ) );
+    ASSERT_EQ( bit::HOST_ORDER, bytes[ 0 ] == 0x34 ? bit::Order::Little : bit::Order::Big );
+    ASSERT_EQ( bit::from_little_endian( bit::to_little_endian( word ) ), word );
+
+    // Sizes that leave a tail after the 16 byte blocks
+    for( size_t n = 0; n < 40; ++n )
+    {
+        uint16_t u16[ 40 ];
+        uint32_t u32[ 40 ];
+        uint64_t u64[ 40 ];
+
+        for( size_t i = 0; i < n; ++i )
+        {
+            u16[ i ] = static_cast< uint16_t >( 0x0102 + i );
+            u32[ i ] = static_cast< uint32_t >( 0x01020304 + i );
+            u64[ i ] = 0x0102030405060708ULL + i;
+        }
+
+        bit::swap_endian( u16, n );
+        bit::swap_endian( u32, n );
+        bit::swap_endian( u64, n );
+
+        for( size_t i = 0; i < n; ++i )
+        {
+            ASSERT_EQ( u16[ i ], bit::swap_endian< uint16_t >( 0x0102 + i ) );
+            ASSERT_EQ( u32[ i ], bit::swap_endian< uint32_t >( 0x01020304 + i ) );
+            ASSERT_EQ( u64[ i ], bit::swap_endian< uint64_t >( 0x0102030405060708ULL + i ) );
+        }
+    }
+
+    // Repeating masks move each block by its own mask
+    uint8_t data[ 32 ];
+    uint8_t masks[ 32 ];
+    for( size_t i = 0; i < 32; ++i )
+    {
+        data[ i ] = static_cast< uint8_t >( i );
+        masks[ i ] = static_cast< uint8_t >( i < 16 ? 15 - i : 0 );
+    }
+
+    bit::shuffle( data, 2, masks, 2 );
+    ASSERT_EQ( data[ 0 ], 15 );
+    ASSERT_EQ( data[ 15 ], 0 );
+    ASSERT_EQ( data[ 16 ], 16 );
+    ASSERT_EQ( data[ 31 ], 16 );
 }
 
 
@@ -161,4 +223,23 @@ TEST( UtilityTest, ConvertApproxDensity )
     using namespace aero::convert;
 }
 
+// Longer than one write of the internal buffer
+TEST( UtilityTest, PrintHex )
+{
+    char buf[ 24 ];
+    std::string expected;
+    for( int i = 0; i < 24; ++i )
+    {
+        buf[ i ] = static_cast< char >( i * 11 );
+        char byte[ 4 ];
+        snprintf( byte, sizeof( byte ), "%02X ", static_cast< unsigned >( i * 11 ) );
+        expected += byte;
+    }
+
+    testing::internal::CaptureStdout();
+    aero::print::print_hex( buf, sizeof( buf ) );
+    fflush( stdout );
+    ASSERT_EQ( testing::internal::GetCapturedStdout(), expected );
+}
+
 #endif
@@ -4,8 +4,30 @@
     // when this library is added as a submodule
 #else
 
-#include "test_Message.cpp"
+#include "test_MessageView.cpp"
 #include "test_Utility.cpp"
+#include "test_Schema.cpp"
+#include "test_FrameDecoder.cpp"
+#include "test_Crc.cpp"
+#include "test_Packet.cpp"
+#include "test_Quantize.cpp"
+#include "test_Delta.cpp"
+#include "test_Ring.cpp"
+#include "test_PosixSerial.cpp"
+#include "test_Log.cpp"
+#include "test_Replay.cpp"
+#include "test_ConvertBatch.cpp"
+#include "test_FastConvert.cpp"
+#include "test_Fixed.cpp"
+#include "test_Columns.cpp"
+#include "test_Reflect.cpp"
+#include "test_Format.cpp"
+#include "test_Scheduler.cpp"
+#include "test_Snapshot.cpp"
+#include "test_Ahrs.cpp"
+#include "test_AirData.cpp"
+#include "test_Filter.cpp"
+#include "test_GpsParser.cpp"
 
 // Main that runs all unit tests
 int main( int argc, char **argv )